@@ -0,0 +1,27 @@
+#include "ActorRegistryComponent.h"
+#include "ActorRegistrySubsystem.h"
+
+UActorRegistryComponent::UActorRegistryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UActorRegistryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		Registry->RegisterActor(GetOwner());
+	}
+}
+
+void UActorRegistryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		Registry->UnregisterActor(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,83 @@
+#include "ActorRegistrySubsystem.h"
+#include "SummerTPS.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Actors"), STAT_ActorRegistry_NumActors, STATGROUP_SummerTPS);
+
+void UActorRegistrySubsystem::Deinitialize()
+{
+	SET_DWORD_STAT(STAT_ActorRegistry_NumActors, 0);
+
+	ActorsByClass.Empty();
+	ActorsByTag.Empty();
+	RegisteredActors.Empty();
+
+	Super::Deinitialize();
+}
+
+void UActorRegistrySubsystem::RegisterActor(AActor* Actor)
+{
+	if (!Actor || RegisteredActors.Contains(Actor))
+	{
+		return;
+	}
+
+	for (const UClass* Class = Actor->GetClass(); Class && Class != AActor::StaticClass(); Class = Class->GetSuperClass())
+	{
+		ActorsByClass.FindOrAdd(Class).Add(Actor);
+	}
+
+	TArray<FName>& Tags = RegisteredActors.Add(Actor);
+	for (const FName& Tag : Actor->Tags)
+	{
+		if (!Tag.IsNone() && !Tags.Contains(Tag))
+		{
+			Tags.Add(Tag);
+			ActorsByTag.FindOrAdd(Tag).Add(Actor);
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ActorRegistry_NumActors);
+	OnActorRegistered.Broadcast(Actor);
+}
+
+void UActorRegistrySubsystem::UnregisterActor(AActor* Actor)
+{
+	const TArray<FName>* Tags = RegisteredActors.Find(Actor);
+	if (!Tags)
+	{
+		return;
+	}
+
+	OnActorUnregistered.Broadcast(Actor);
+
+	for (const FName& Tag : *Tags)
+	{
+		if (TArray<AActor*>* Bucket = ActorsByTag.Find(Tag))
+		{
+			Bucket->RemoveSingleSwap(Actor);
+		}
+	}
+
+	for (const UClass* Class = Actor->GetClass(); Class && Class != AActor::StaticClass(); Class = Class->GetSuperClass())
+	{
+		if (TArray<AActor*>* Bucket = ActorsByClass.Find(Class))
+		{
+			Bucket->RemoveSingleSwap(Actor);
+		}
+	}
+
+	RegisteredActors.Remove(Actor);
+	DEC_DWORD_STAT(STAT_ActorRegistry_NumActors);
+}
+
+TConstArrayView<AActor*> UActorRegistrySubsystem::GetActorsOfClass(const UClass* Class) const
+{
+	const TArray<AActor*>* Bucket = ActorsByClass.Find(Class);
+	return Bucket ? TConstArrayView<AActor*>(*Bucket) : TConstArrayView<AActor*>();
+}
+
+TConstArrayView<AActor*> UActorRegistrySubsystem::GetActorsWithTag(FName Tag) const
+{
+	const TArray<AActor*>* Bucket = ActorsByTag.Find(Tag);
+	return Bucket ? TConstArrayView<AActor*>(*Bucket) : TConstArrayView<AActor*>();
+}
@@ -0,0 +1,119 @@
+#include "AttackTokenComponent.h"
+#include "SummerTPS.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attack Tokens Granted"), STAT_AttackTokens_Granted, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attack Tokens Denied"), STAT_AttackTokens_Denied, STATGROUP_SummerTPS);
+
+UAttackTokenComponent::UAttackTokenComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	MaxTokens = 3;
+	TokenCooldown = 0.5f;
+	MaxHoldTime = 2.0f;
+	PreemptPriorityMargin = 0.25f;
+}
+
+bool UAttackTokenComponent::TryAcquireToken(AActor* Attacker, float Priority)
+{
+	if (!Attacker)
+	{
+		return false;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Slots.Num() != MaxTokens)
+	{
+		Slots.SetNum(MaxTokens);
+	}
+	ExpireSlots(Now);
+
+	FTokenSlot* FreeSlot = nullptr;
+	FTokenSlot* WeakestSlot = nullptr;
+	for (FTokenSlot& Slot : Slots)
+	{
+		if (Slot.Holder.Get() == Attacker)
+		{
+			// Already holding one, keep it with the latest priority
+			Slot.Priority = Priority;
+			return true;
+		}
+
+		if (!Slot.Holder.IsValid())
+		{
+			if (!FreeSlot && Now >= Slot.CooldownEndTime)
+			{
+				FreeSlot = &Slot;
+			}
+		}
+		else if (!WeakestSlot || Slot.Priority < WeakestSlot->Priority)
+		{
+			WeakestSlot = &Slot;
+		}
+	}
+
+	FTokenSlot* GrantedSlot = FreeSlot;
+	if (!GrantedSlot && WeakestSlot && Priority > WeakestSlot->Priority + PreemptPriorityMargin)
+	{
+		// The preempted holder finds out the next time it asks; its slot changes hands without a cooldown
+		GrantedSlot = WeakestSlot;
+	}
+
+	if (!GrantedSlot)
+	{
+		INC_DWORD_STAT(STAT_AttackTokens_Denied);
+		return false;
+	}
+
+	GrantedSlot->Holder = Attacker;
+	GrantedSlot->Priority = Priority;
+	GrantedSlot->AcquiredTime = Now;
+	INC_DWORD_STAT(STAT_AttackTokens_Granted);
+	return true;
+}
+
+void UAttackTokenComponent::ReleaseToken(AActor* Attacker)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (FTokenSlot& Slot : Slots)
+	{
+		if (Slot.Holder.Get() == Attacker)
+		{
+			FreeSlot(Slot, Now);
+			return;
+		}
+	}
+}
+
+bool UAttackTokenComponent::HasToken(const AActor* Attacker) const
+{
+	return Slots.ContainsByPredicate([Attacker](const FTokenSlot& Slot) { return Slot.Holder.Get() == Attacker; });
+}
+
+int32 UAttackTokenComponent::GetNumActiveTokens() const
+{
+	int32 NumActive = 0;
+	for (const FTokenSlot& Slot : Slots)
+	{
+		NumActive += Slot.Holder.IsValid() ? 1 : 0;
+	}
+	return NumActive;
+}
+
+void UAttackTokenComponent::ExpireSlots(double Now)
+{
+	for (FTokenSlot& Slot : Slots)
+	{
+		if (Slot.Holder.IsStale() || (Slot.Holder.IsValid() && MaxHoldTime > 0.0f && Now - Slot.AcquiredTime > MaxHoldTime))
+		{
+			FreeSlot(Slot, Now);
+		}
+	}
+}
+
+void UAttackTokenComponent::FreeSlot(FTokenSlot& Slot, double Now)
+{
+	Slot.Holder.Reset();
+	Slot.Priority = 0.0f;
+	Slot.CooldownEndTime = Now + TokenCooldown;
+}
@@ -0,0 +1,130 @@
+#include "BTService_ChaseTarget.h"
+#include "SummerTPS.h"
+#include "AIController.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+
+DECLARE_CYCLE_STAT(TEXT("BTService ChaseTarget"), STAT_BTService_ChaseTarget, STATGROUP_SummerTPS);
+
+UBTService_ChaseTarget::UBTService_ChaseTarget()
+{
+	NodeName = TEXT("Chase Target");
+
+	bNotifyTick = true;
+	bNotifyCeaseRelevant = true;
+	Interval = 0.25f;
+	RandomDeviation = 0.05f;
+
+	AttackRange = 800.0f;
+	RangeHysteresis = 150.0f;
+
+	TargetActorKey.SelectedKeyName = TEXT("TargetActor");
+	TargetActorKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_ChaseTarget, TargetActorKey), AActor::StaticClass());
+
+	InAttackRangeKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_ChaseTarget, InAttackRangeKey));
+	InAttackRangeKey.AllowNoneAsValue(true);
+}
+
+void UBTService_ChaseTarget::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* BBAsset = GetBlackboardAsset())
+	{
+		TargetActorKey.ResolveSelectedKey(*BBAsset);
+		InAttackRangeKey.ResolveSelectedKey(*BBAsset);
+	}
+}
+
+uint16 UBTService_ChaseTarget::GetInstanceMemorySize() const
+{
+	return sizeof(FBTChaseTargetMemory);
+}
+
+void UBTService_ChaseTarget::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTChaseTargetMemory>(NodeMemory, InitType);
+}
+
+void UBTService_ChaseTarget::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTChaseTargetMemory>(NodeMemory, CleanupType);
+}
+
+void UBTService_ChaseTarget::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BTService_ChaseTarget);
+
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	FBTChaseTargetMemory* Memory = CastInstanceNodeMemory<FBTChaseTargetMemory>(NodeMemory);
+	AAIController* AICon = OwnerComp.GetAIOwner();
+	APawn* Pawn = AICon ? AICon->GetPawn() : nullptr;
+	UBlackboardComponent* BBComp = OwnerComp.GetBlackboardComponent();
+	if (!Pawn || !BBComp)
+	{
+		return;
+	}
+
+	AActor* Target = Cast<AActor>(BBComp->GetValue<UBlackboardKeyType_Object>(TargetActorKey.GetSelectedKeyID()));
+	if (!Target)
+	{
+		StopChasing(OwnerComp, *Memory);
+		return;
+	}
+
+	const float DistSq = FVector::DistSquared(Pawn->GetActorLocation(), Target->GetActorLocation());
+	const float EffectiveRange = Memory->bIsChasing ? AttackRange : AttackRange + RangeHysteresis;
+	const bool bInRange = DistSq <= FMath::Square(EffectiveRange);
+
+	if (InAttackRangeKey.IsSet())
+	{
+		BBComp->SetValue<UBlackboardKeyType_Bool>(InAttackRangeKey.GetSelectedKeyID(), bInRange);
+	}
+
+	if (bInRange)
+	{
+		StopChasing(OwnerComp, *Memory);
+		return;
+	}
+
+	// The move request tracks the goal actor on its own, so it only has to be (re)issued when the target changes
+	// or path following went idle (e.g. path was invalidated)
+	const bool bTargetChanged = Memory->ChasedTarget.Get() != Target;
+	const bool bPathIdle = AICon->GetMoveStatus() == EPathFollowingStatus::Idle;
+	if (bTargetChanged || bPathIdle || !Memory->bIsChasing)
+	{
+		const EPathFollowingRequestResult::Type Result = AICon->MoveToActor(Target, AttackRange * 0.9f);
+		Memory->bIsChasing = Result != EPathFollowingRequestResult::Failed;
+		Memory->ChasedTarget = Target;
+	}
+}
+
+void UBTService_ChaseTarget::OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	StopChasing(OwnerComp, *CastInstanceNodeMemory<FBTChaseTargetMemory>(NodeMemory));
+
+	Super::OnCeaseRelevant(OwnerComp, NodeMemory);
+}
+
+void UBTService_ChaseTarget::StopChasing(UBehaviorTreeComponent& OwnerComp, FBTChaseTargetMemory& Memory) const
+{
+	if (Memory.bIsChasing)
+	{
+		if (AAIController* AICon = OwnerComp.GetAIOwner())
+		{
+			AICon->StopMovement();
+		}
+	}
+
+	Memory.bIsChasing = false;
+	Memory.ChasedTarget.Reset();
+}
+
+FString UBTService_ChaseTarget::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s\nChase %s, attack range %.0f"), *Super::GetStaticDescription(), *TargetActorKey.SelectedKeyName.ToString(), AttackRange);
+}
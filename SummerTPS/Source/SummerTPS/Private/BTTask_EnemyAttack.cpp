@@ -0,0 +1,147 @@
+#include "BTTask_EnemyAttack.h"
+#include "SummerTPS.h"
+#include "EnemyCharacter.h"
+#include "EnemyDecisionSubsystem.h"
+#include "AIController.h"
+#include "NavigationSystem.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+
+DECLARE_CYCLE_STAT(TEXT("BTTask EnemyAttack"), STAT_BTTask_EnemyAttack, STATGROUP_SummerTPS);
+
+UBTTask_EnemyAttack::UBTTask_EnemyAttack()
+{
+	NodeName = TEXT("Enemy Attack");
+
+	bNotifyTick = true;
+	bNotifyTaskFinished = true;
+	RecoveryTime = 0.5f;
+	StrafeDistance = 300.0f;
+
+	TargetActorKey.SelectedKeyName = TEXT("TargetActor");
+	TargetActorKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyAttack, TargetActorKey), AActor::StaticClass());
+
+	AttackReadyKey.SelectedKeyName = TEXT("AttackReady");
+	AttackReadyKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyAttack, AttackReadyKey));
+}
+
+void UBTTask_EnemyAttack::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* BBAsset = GetBlackboardAsset())
+	{
+		TargetActorKey.ResolveSelectedKey(*BBAsset);
+		AttackReadyKey.ResolveSelectedKey(*BBAsset);
+	}
+}
+
+uint16 UBTTask_EnemyAttack::GetInstanceMemorySize() const
+{
+	return sizeof(FBTEnemyAttackMemory);
+}
+
+void UBTTask_EnemyAttack::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTEnemyAttackMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_EnemyAttack::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTEnemyAttackMemory>(NodeMemory, CleanupType);
+}
+
+EBTNodeResult::Type UBTTask_EnemyAttack::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BTTask_EnemyAttack);
+
+	AAIController* AICon = OwnerComp.GetAIOwner();
+	AEnemyCharacter* Enemy = AICon ? Cast<AEnemyCharacter>(AICon->GetPawn()) : nullptr;
+	if (!Enemy)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	AActor* Target = nullptr;
+	if (const UBlackboardComponent* BBComp = OwnerComp.GetBlackboardComponent())
+	{
+		// Blackboards without the key leave it unresolved and keep attacking whenever the tree gets here
+		if (AttackReadyKey.IsSet() && UEnemyDecisionSubsystem::IsEnabled() && !BBComp->GetValue<UBlackboardKeyType_Bool>(AttackReadyKey.GetSelectedKeyID()))
+		{
+			return EBTNodeResult::Failed;
+		}
+
+		Target = Cast<AActor>(BBComp->GetValue<UBlackboardKeyType_Object>(TargetActorKey.GetSelectedKeyID()));
+		if (Target)
+		{
+			AICon->SetFocus(Target);
+		}
+	}
+
+	FBTEnemyAttackMemory* Memory = CastInstanceNodeMemory<FBTEnemyAttackMemory>(NodeMemory);
+	Memory->bDeniedToken = !Enemy->TryAttack(Target);
+
+	if (Memory->bDeniedToken)
+	{
+		StartStrafe(*AICon, Target);
+	}
+
+	if (RecoveryTime <= 0.0f)
+	{
+		return Memory->bDeniedToken ? EBTNodeResult::Failed : EBTNodeResult::Succeeded;
+	}
+
+	Memory->RemainingRecoveryTime = RecoveryTime;
+	return EBTNodeResult::InProgress;
+}
+
+void UBTTask_EnemyAttack::StartStrafe(AAIController& AICon, const AActor* Target) const
+{
+	const APawn* Pawn = AICon.GetPawn();
+	if (!Pawn || !Target || StrafeDistance <= 0.0f)
+	{
+		return;
+	}
+
+	const FVector ToTarget = (Target->GetActorLocation() - Pawn->GetActorLocation()).GetSafeNormal2D();
+	const FVector Side = FVector::CrossProduct(ToTarget, FVector::UpVector) * (FMath::RandBool() ? 1.0f : -1.0f);
+
+	FNavLocation StrafePoint;
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(Pawn->GetWorld());
+	if (NavSys && NavSys->ProjectPointToNavigation(Pawn->GetActorLocation() + Side * StrafeDistance, StrafePoint))
+	{
+		AICon.MoveToLocation(StrafePoint.Location, 50.0f, true, true, false, false);
+	}
+}
+
+void UBTTask_EnemyAttack::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	FBTEnemyAttackMemory* Memory = CastInstanceNodeMemory<FBTEnemyAttackMemory>(NodeMemory);
+	Memory->RemainingRecoveryTime -= DeltaSeconds;
+
+	if (Memory->RemainingRecoveryTime <= 0.0f)
+	{
+		FinishLatentTask(OwnerComp, Memory->bDeniedToken ? EBTNodeResult::Failed : EBTNodeResult::Succeeded);
+	}
+}
+
+void UBTTask_EnemyAttack::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	// Hand the token back after each attack so other enemies get their turn once the slot cooled down
+	if (AAIController* AICon = OwnerComp.GetAIOwner())
+	{
+		if (AEnemyCharacter* Enemy = Cast<AEnemyCharacter>(AICon->GetPawn()))
+		{
+			Enemy->ReleaseAttackToken();
+		}
+	}
+
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+FString UBTTask_EnemyAttack::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: %s, recovery %.2fs"), *Super::GetStaticDescription(), *TargetActorKey.SelectedKeyName.ToString(), RecoveryTime);
+}
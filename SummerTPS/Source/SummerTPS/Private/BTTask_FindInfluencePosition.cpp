@@ -0,0 +1,77 @@
+#include "BTTask_FindInfluencePosition.h"
+#include "SummerTPS.h"
+#include "InfluenceMapSubsystem.h"
+#include "AIController.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+DECLARE_CYCLE_STAT(TEXT("BTTask FindInfluencePosition"), STAT_BTTask_FindInfluencePosition, STATGROUP_SummerTPS);
+
+UBTTask_FindInfluencePosition::UBTTask_FindInfluencePosition()
+{
+	NodeName = TEXT("Find Influence Position");
+
+	Mode = EInfluencePositionMode::Flank;
+	MinFlankRange = 600.0f;
+	MaxFlankRange = 1500.0f;
+	RetreatSearchRadius = 1200.0f;
+
+	TargetActorKey.SelectedKeyName = TEXT("TargetActor");
+	TargetActorKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_FindInfluencePosition, TargetActorKey), AActor::StaticClass());
+
+	ResultKey.SelectedKeyName = TEXT("TacticalLocation");
+	ResultKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_FindInfluencePosition, ResultKey));
+}
+
+void UBTTask_FindInfluencePosition::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (UBlackboardData* BBAsset = GetBlackboardAsset())
+	{
+		TargetActorKey.ResolveSelectedKey(*BBAsset);
+		ResultKey.ResolveSelectedKey(*BBAsset);
+	}
+}
+
+EBTNodeResult::Type UBTTask_FindInfluencePosition::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BTTask_FindInfluencePosition);
+
+	AAIController* AICon = OwnerComp.GetAIOwner();
+	APawn* Pawn = AICon ? AICon->GetPawn() : nullptr;
+	UBlackboardComponent* BBComp = OwnerComp.GetBlackboardComponent();
+	if (!Pawn || !BBComp)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	const UInfluenceMapSubsystem* InfluenceMap = Pawn->GetWorld()->GetSubsystem<UInfluenceMapSubsystem>();
+	const AActor* Target = Cast<AActor>(BBComp->GetValue<UBlackboardKeyType_Object>(TargetActorKey.GetSelectedKeyID()));
+	if (!InfluenceMap || !Target)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	FVector Position;
+	const bool bFound = Mode == EInfluencePositionMode::Flank
+		? InfluenceMap->FindFlankPosition(Pawn->GetActorLocation(), Target, MinFlankRange, MaxFlankRange, Position)
+		: InfluenceMap->FindRetreatPosition(Pawn->GetActorLocation(), Target->GetActorLocation(), RetreatSearchRadius, Position);
+
+	if (!bFound)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	BBComp->SetValue<UBlackboardKeyType_Vector>(ResultKey.GetSelectedKeyID(), Position);
+	return EBTNodeResult::Succeeded;
+}
+
+FString UBTTask_FindInfluencePosition::GetStaticDescription() const
+{
+	return Mode == EInfluencePositionMode::Flank
+		? FString::Printf(TEXT("%s: flank %s (%.0f-%.0f) -> %s"), *Super::GetStaticDescription(), *TargetActorKey.SelectedKeyName.ToString(), MinFlankRange, MaxFlankRange, *ResultKey.SelectedKeyName.ToString())
+		: FString::Printf(TEXT("%s: retreat from %s (radius %.0f) -> %s"), *Super::GetStaticDescription(), *TargetActorKey.SelectedKeyName.ToString(), RetreatSearchRadius, *ResultKey.SelectedKeyName.ToString());
+}
@@ -0,0 +1,103 @@
+#include "BTTask_FindPatrolPoint.h"
+#include "SummerTPS.h"
+#include "EnemyDecisionSubsystem.h"
+#include "EnemyCharacter.h"
+#include "AIController.h"
+#include "AISystem.h"
+#include "NavigationSystem.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+DECLARE_CYCLE_STAT(TEXT("BTTask FindPatrolPoint"), STAT_BTTask_FindPatrolPoint, STATGROUP_SummerTPS);
+
+UBTTask_FindPatrolPoint::UBTTask_FindPatrolPoint()
+{
+	NodeName = TEXT("Find Patrol Point");
+
+	PatrolRadius = 1000.0f;
+	bAnchorToFirstLocation = true;
+
+	PatrolLocationKey.SelectedKeyName = TEXT("PatrolLocation");
+	PatrolLocationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_FindPatrolPoint, PatrolLocationKey));
+}
+
+void UBTTask_FindPatrolPoint::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	// Resolve the key name to a key ID once per asset instead of looking it up by name on every execution
+	if (UBlackboardData* BBAsset = GetBlackboardAsset())
+	{
+		PatrolLocationKey.ResolveSelectedKey(*BBAsset);
+	}
+}
+
+uint16 UBTTask_FindPatrolPoint::GetInstanceMemorySize() const
+{
+	return sizeof(FBTFindPatrolPointMemory);
+}
+
+void UBTTask_FindPatrolPoint::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTFindPatrolPointMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_FindPatrolPoint::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTFindPatrolPointMemory>(NodeMemory, CleanupType);
+}
+
+EBTNodeResult::Type UBTTask_FindPatrolPoint::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BTTask_FindPatrolPoint);
+
+	AAIController* AICon = OwnerComp.GetAIOwner();
+	APawn* Pawn = AICon ? AICon->GetPawn() : nullptr;
+	UBlackboardComponent* BBComp = OwnerComp.GetBlackboardComponent();
+	if (!Pawn || !BBComp)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	FBTFindPatrolPointMemory* Memory = CastInstanceNodeMemory<FBTFindPatrolPointMemory>(NodeMemory);
+	if (!Memory->bHasPatrolOrigin || !bAnchorToFirstLocation)
+	{
+		Memory->PatrolOrigin = Pawn->GetActorLocation();
+		Memory->bHasPatrolOrigin = true;
+	}
+
+	// The batched decision phase keeps PatrolLocation up to date within this node's area; only query the navmesh until it has written one
+	if (UEnemyDecisionSubsystem::IsEnabled())
+	{
+		if (AEnemyCharacter* Enemy = Cast<AEnemyCharacter>(Pawn))
+		{
+			Enemy->SetPatrolArea(Memory->PatrolOrigin, PatrolRadius);
+
+			if (FAISystem::IsValidLocation(BBComp->GetValue<UBlackboardKeyType_Vector>(PatrolLocationKey.GetSelectedKeyID())))
+			{
+				return EBTNodeResult::Succeeded;
+			}
+		}
+	}
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(Pawn->GetWorld());
+	if (!NavSys)
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	FNavLocation PatrolPoint;
+	if (!NavSys->GetRandomReachablePointInRadius(Memory->PatrolOrigin, PatrolRadius, PatrolPoint))
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	BBComp->SetValue<UBlackboardKeyType_Vector>(PatrolLocationKey.GetSelectedKeyID(), PatrolPoint.Location);
+	return EBTNodeResult::Succeeded;
+}
+
+FString UBTTask_FindPatrolPoint::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: %s (radius %.0f)"), *Super::GetStaticDescription(), *PatrolLocationKey.SelectedKeyName.ToString(), PatrolRadius);
+}
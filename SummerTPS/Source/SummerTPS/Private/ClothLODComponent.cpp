@@ -0,0 +1,231 @@
+#include "ClothLODComponent.h"
+#include "SummerTPS.h"
+#include "TPSPlayer.h"
+#include "ClothingSimulationInteractor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Kismet/GameplayStatics.h"
+#include "Camera/PlayerCameraManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cloth LOD Update"), STAT_ClothLOD_Update, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cloth LOD Level"), STAT_ClothLOD_Level, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cloth Solver Work (iterations x substeps)"), STAT_ClothLOD_SolverWork, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cloth Meshes Suspended"), STAT_ClothLOD_Suspended, STATGROUP_SummerTPS);
+
+UClothLODComponent::UClothLODComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+
+	HysteresisDistance = 150.0f;
+	FastCameraSpeed = 3000.0f;
+	ResetAfterSuspendTime = 0.5f;
+
+	CurrentLevel = INDEX_NONE;
+	bFrozen = false;
+	SuspendStartTime = 0.0;
+	LastCameraLocation = FVector::ZeroVector;
+	bHasLastCameraLocation = false;
+
+	// Close-up: whatever the cloth config authors
+	FClothLODLevel& Near = Levels.AddDefaulted_GetRef();
+	Near.MaxDistance = 800.0f;
+
+	// Gameplay camera distance
+	FClothLODLevel& Mid = Levels.AddDefaulted_GetRef();
+	Mid.MaxDistance = 2000.0f;
+	Mid.NumIterations = 2;
+	Mid.NumSubsteps = 1;
+
+	FClothLODLevel& Far = Levels.AddDefaulted_GetRef();
+	Far.MaxDistance = 4000.0f;
+	Far.NumIterations = 1;
+	Far.NumSubsteps = 1;
+
+	FClothLODLevel& Off = Levels.AddDefaulted_GetRef();
+	Off.MaxDistance = TNumericLimits<float>::Max();
+	Off.bSuspend = true;
+}
+
+void UClothLODComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	TArray<USkeletalMeshComponent*> SkeletalMeshes;
+	GetOwner()->GetComponents(SkeletalMeshes);
+	for (USkeletalMeshComponent* SkelMesh : SkeletalMeshes)
+	{
+		const USkeletalMesh* Asset = SkelMesh->GetSkeletalMeshAsset();
+		if (Asset && Asset->HasActiveClothingAssets())
+		{
+			ClothMeshes.Add(SkelMesh);
+
+			// Decide the level before the mesh kicks off its cloth simulation this frame
+			SkelMesh->PrimaryComponentTick.AddPrerequisite(this, PrimaryComponentTick);
+		}
+	}
+
+	if (ClothMeshes.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ClothLODComponent on %s found no skeletal mesh with clothing"), *GetOwner()->GetName());
+		SetComponentTickEnabled(false);
+	}
+}
+
+void UClothLODComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_CYCLE_COUNTER(STAT_ClothLOD_Update);
+
+	const APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (!CameraManager || Levels.Num() == 0)
+	{
+		return;
+	}
+
+	const FVector CameraLocation = CameraManager->GetCameraLocation();
+	const float CameraSpeed = bHasLastCameraLocation && DeltaTime > 0.0f ? FVector::Dist(CameraLocation, LastCameraLocation) / DeltaTime : 0.0f;
+	LastCameraLocation = CameraLocation;
+	bHasLastCameraLocation = true;
+
+	const float CameraDistance = FVector::Dist(CameraLocation, GetOwner()->GetActorLocation());
+	const int32 NewLevel = ComputeLevel(CameraDistance, CameraSpeed);
+
+	const bool bShouldFreeze = NewLevel == INDEX_NONE || Levels[NewLevel].bSuspend;
+	if (bShouldFreeze && !bFrozen)
+	{
+		Suspend();
+	}
+	else if (!bShouldFreeze && bFrozen)
+	{
+		Resume();
+	}
+
+	if (NewLevel != INDEX_NONE && NewLevel != CurrentLevel)
+	{
+		ApplyLevel(NewLevel);
+	}
+
+	const FClothLODLevel* Applied = Levels.IsValidIndex(CurrentLevel) ? &Levels[CurrentLevel] : nullptr;
+	SET_DWORD_STAT(STAT_ClothLOD_Level, FMath::Max(CurrentLevel, 0));
+	SET_DWORD_STAT(STAT_ClothLOD_SolverWork, bFrozen || !Applied ? 0 : FMath::Max(Applied->NumIterations, 1) * FMath::Max(Applied->NumSubsteps, 1));
+	SET_DWORD_STAT(STAT_ClothLOD_Suspended, bFrozen ? ClothMeshes.Num() : 0);
+}
+
+int32 UClothLODComponent::ComputeLevel(float CameraDistance, float CameraSpeed) const
+{
+	// The cover lerp moves the actor several units a frame with no animation to drive the cloth, freeze instead of simulating the slide
+	if (const ATPSPlayer* Player = Cast<ATPSPlayer>(GetOwner()))
+	{
+		if (Player->IsEnteringCover() || Player->IsExitingCover())
+		{
+			return INDEX_NONE;
+		}
+	}
+
+	int32 Candidate = Levels.Num() - 1;
+	for (int32 Level = 0; Level < Levels.Num() - 1; ++Level)
+	{
+		if (CameraDistance < Levels[Level].MaxDistance)
+		{
+			Candidate = Level;
+			break;
+		}
+	}
+
+	if (CurrentLevel != INDEX_NONE && Candidate > CurrentLevel && CameraDistance < Levels[CurrentLevel].MaxDistance + HysteresisDistance)
+	{
+		Candidate = CurrentLevel;
+	}
+
+	if (FastCameraSpeed > 0.0f && CameraSpeed > FastCameraSpeed)
+	{
+		// Detail is lost in the motion blur anyway, but keep simulating so the cloth doesn't pop afterwards
+		for (int32 Level = Levels.Num() - 1; Level > Candidate; --Level)
+		{
+			if (!Levels[Level].bSuspend)
+			{
+				Candidate = Level;
+				break;
+			}
+		}
+	}
+
+	return Candidate;
+}
+
+void UClothLODComponent::ApplyLevel(int32 NewLevel)
+{
+	CurrentLevel = NewLevel;
+	const FClothLODLevel& Level = Levels[NewLevel];
+	if (Level.bSuspend)
+	{
+		return;
+	}
+
+	for (USkeletalMeshComponent* SkelMesh : ClothMeshes)
+	{
+		UClothingSimulationInteractor* Interactor = SkelMesh ? SkelMesh->GetClothingSimulationInteractor() : nullptr;
+		if (!Interactor)
+		{
+			continue;
+		}
+
+		if (Level.NumIterations == 0 && Level.NumSubsteps == 0)
+		{
+			// Back to the authored config
+			Interactor->ClothConfigUpdated();
+			continue;
+		}
+
+		if (Level.NumIterations > 0)
+		{
+			Interactor->SetNumIterations(Level.NumIterations);
+			Interactor->SetMaxNumIterations(Level.NumIterations);
+		}
+		if (Level.NumSubsteps > 0)
+		{
+			Interactor->SetNumSubsteps(Level.NumSubsteps);
+		}
+	}
+}
+
+void UClothLODComponent::Suspend()
+{
+	bFrozen = true;
+	SuspendStartTime = GetWorld()->GetTimeSeconds();
+
+	for (USkeletalMeshComponent* SkelMesh : ClothMeshes)
+	{
+		if (SkelMesh)
+		{
+			SkelMesh->SuspendClothingSimulation();
+		}
+	}
+}
+
+void UClothLODComponent::Resume()
+{
+	bFrozen = false;
+	const bool bReset = GetWorld()->GetTimeSeconds() - SuspendStartTime > ResetAfterSuspendTime;
+
+	for (USkeletalMeshComponent* SkelMesh : ClothMeshes)
+	{
+		if (!SkelMesh)
+		{
+			continue;
+		}
+
+		// The owner moved while the cloth was frozen; without a teleport the solver sees that as one huge step
+		if (bReset)
+		{
+			SkelMesh->ForceClothNextUpdateTeleportAndReset();
+		}
+		else
+		{
+			SkelMesh->ForceClothNextUpdateTeleport();
+		}
+		SkelMesh->ResumeClothingSimulation();
+	}
+}
@@ -0,0 +1,449 @@
+#include "CombatClockSubsystem.h"
+#include "SummerTPS.h"
+#include "TPSPlayer.h"
+#include "EnemyCharacter.h"
+#include "EnemySpawner.h"
+#include "HealthComponent.h"
+#include "ActorRegistrySubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Combat Step"), STAT_CombatClock_Step, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Combat State Hash"), STAT_CombatClock_Hash, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Steps"), STAT_CombatClock_Steps, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Steps Dropped"), STAT_CombatClock_Dropped, STATGROUP_SummerTPS);
+
+namespace CombatClock
+{
+	static bool FixedStep = false;
+	static FAutoConsoleVariableRef CVarFixedStep(
+		TEXT("summer.Combat.FixedStep"),
+		FixedStep,
+		TEXT("Run firing, spawning and projectile flight in fixed combat steps decoupled from the frame rate. Applies to worlds created afterwards."));
+
+	static int32 Seed = 1;
+	static FAutoConsoleVariableRef CVarSeed(
+		TEXT("summer.Combat.Seed"),
+		Seed,
+		TEXT("Seed of the combat random stream in fixed step mode. Applies to worlds created afterwards."));
+
+	static int32 Determinism = 0;
+	static FAutoConsoleVariableRef CVarDeterminism(
+		TEXT("summer.Combat.Determinism"),
+		Determinism,
+		TEXT("Per-step combat state hashes in fixed step mode. 0: off, 1: record to Saved/Determinism when the world ends,\n")
+		TEXT("2: compare against the last recording of the map and report the first step that differs. Applies to worlds created afterwards."));
+
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("summer.Combat.Determinism.Report"),
+		TEXT("Prints how many combat steps were hashed and, when comparing, whether and where they diverged from the recording."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			if (const UCombatClockSubsystem* Clock = World ? World->GetSubsystem<UCombatClockSubsystem>() : nullptr)
+			{
+				Clock->ReportDeterminism();
+			}
+		}));
+
+	/** Rounds to whole steps, at least one so a timer never fires on the step that set it */
+	static int32 ToSteps(float Seconds, float StepSize)
+	{
+		return FMath::Max(FMath::RoundToInt(Seconds / StepSize), 1);
+	}
+
+	/** Floats are hashed by their bits: any difference at all is a divergence */
+	static uint32 HashFloat(float Value, uint32 Crc)
+	{
+		return FCrc::MemCrc32(&Value, sizeof(Value), Crc);
+	}
+
+	static uint32 HashLocation(const FVector& Location, float Grid, uint32 Crc)
+	{
+		if (Grid <= 0.0f)
+		{
+			return Crc;
+		}
+
+		const FIntVector Cell(FMath::RoundToInt(Location.X / Grid), FMath::RoundToInt(Location.Y / Grid), FMath::RoundToInt(Location.Z / Grid));
+		return FCrc::MemCrc32(&Cell, sizeof(Cell), Crc);
+	}
+}
+
+UCombatClockSubsystem::UCombatClockSubsystem()
+{
+	FixedStepSize = 1.0f / 60.0f;
+	MaxStepsPerFrame = 4;
+	LocationHashGrid = 0.0f;
+
+	bFixedStep = false;
+	StepIndex = 0;
+	Accumulator = 0.0;
+	NextTimerId = 0;
+	DeterminismMode = 0;
+	FirstMismatchStep = INDEX_NONE;
+}
+
+void UCombatClockSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Switching mode mid-game would strand timers on the other clock, so it's read once per world
+	bFixedStep = CombatClock::FixedStep;
+	Random.Initialize(bFixedStep ? CombatClock::Seed : FMath::Rand());
+	DeterminismMode = bFixedStep ? FMath::Clamp(CombatClock::Determinism, 0, 2) : 0;
+
+	if (CombatClock::Determinism != 0 && !bFixedStep)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("summer.Combat.Determinism needs summer.Combat.FixedStep 1 when the map loads, ignored"));
+	}
+
+	if (DeterminismMode == 2)
+	{
+		const FString Path = GetDeterminismFilePath();
+		TArray<FString> Lines;
+		if (FFileHelper::LoadFileToStringArray(Lines, *Path))
+		{
+			BaselineHashes.Reserve(Lines.Num());
+			for (const FString& Line : Lines)
+			{
+				BaselineHashes.Add(FParse::HexNumber(*Line));
+			}
+		}
+		UE_LOG(LogTemp, Log, TEXT("Combat determinism: comparing against %d recorded steps from %s"), BaselineHashes.Num(), *Path);
+	}
+}
+
+void UCombatClockSubsystem::Deinitialize()
+{
+	if (DeterminismMode == 1 && StepHashes.Num() > 0)
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(StepHashes.Num());
+		for (const uint32 Hash : StepHashes)
+		{
+			Lines.Add(FString::Printf(TEXT("%08x"), Hash));
+		}
+
+		const FString Path = GetDeterminismFilePath();
+		if (FFileHelper::SaveStringArrayToFile(Lines, *Path))
+		{
+			UE_LOG(LogTemp, Log, TEXT("Combat determinism: recorded %d steps to %s"), StepHashes.Num(), *Path);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Combat determinism: couldn't write %s"), *Path);
+		}
+	}
+	else if (DeterminismMode == 2)
+	{
+		ReportDeterminism();
+	}
+
+	StepTimers.Empty();
+	StepHashes.Empty();
+	BaselineHashes.Empty();
+	OnCombatStep.Clear();
+
+	Super::Deinitialize();
+}
+
+bool UCombatClockSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UCombatClockSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatClockSubsystem, STATGROUP_Tickables);
+}
+
+UCombatClockSubsystem* UCombatClockSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatClockSubsystem>() : nullptr;
+}
+
+void UCombatClockSubsystem::Tick(float DeltaTime)
+{
+	if (!bFixedStep)
+	{
+		return;
+	}
+
+	Accumulator += DeltaTime;
+
+	int32 Steps = FMath::FloorToInt(Accumulator / FixedStepSize);
+	if (Steps > MaxStepsPerFrame)
+	{
+		// Dropped time is lost to combat, not owed to later frames, so one hitch can't snowball
+		INC_DWORD_STAT_BY(STAT_CombatClock_Dropped, Steps - MaxStepsPerFrame);
+		Steps = MaxStepsPerFrame;
+		Accumulator = Steps * (double)FixedStepSize;
+	}
+
+	for (int32 Index = 0; Index < Steps; ++Index)
+	{
+		Accumulator -= FixedStepSize;
+		Step();
+	}
+}
+
+void UCombatClockSubsystem::Step()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatClock_Step);
+	INC_DWORD_STAT(STAT_CombatClock_Steps);
+
+	StepIndex++;
+	FireTimers();
+	OnCombatStep.Broadcast(StepIndex);
+
+	if (DeterminismMode != 0)
+	{
+		CheckDeterminism();
+	}
+}
+
+void UCombatClockSubsystem::FireTimers()
+{
+	// Timer callbacks may set or clear timers, so the due ones are looked up again by id before each call
+	TArray<int32, TInlineAllocator<16>> DueIds;
+	for (const FStepTimer& Timer : StepTimers)
+	{
+		if (Timer.NextStep <= StepIndex)
+		{
+			DueIds.Add(Timer.Id);
+		}
+	}
+
+	for (const int32 Id : DueIds)
+	{
+		const int32 Index = StepTimers.IndexOfByPredicate([Id](const FStepTimer& Timer) { return Timer.Id == Id; });
+		if (Index == INDEX_NONE || StepTimers[Index].NextStep > StepIndex)
+		{
+			continue;
+		}
+
+		FTimerDelegate Delegate = StepTimers[Index].Delegate;
+		if (StepTimers[Index].bLoop)
+		{
+			StepTimers[Index].NextStep = StepIndex + StepTimers[Index].IntervalSteps;
+		}
+		else
+		{
+			StepTimers.RemoveAt(Index, 1, false);
+		}
+
+		Delegate.ExecuteIfBound();
+	}
+}
+
+UCombatClockSubsystem::FStepTimer* UCombatClockSubsystem::FindStepTimer(int32 Id)
+{
+	return Id != INDEX_NONE ? StepTimers.FindByPredicate([Id](const FStepTimer& Timer) { return Timer.Id == Id; }) : nullptr;
+}
+
+const UCombatClockSubsystem::FStepTimer* UCombatClockSubsystem::FindStepTimer(int32 Id) const
+{
+	return Id != INDEX_NONE ? StepTimers.FindByPredicate([Id](const FStepTimer& Timer) { return Timer.Id == Id; }) : nullptr;
+}
+
+double UCombatClockSubsystem::GetCombatTime(const UObject* WorldContextObject)
+{
+	if (const UCombatClockSubsystem* Clock = Get(WorldContextObject))
+	{
+		if (Clock->bFixedStep)
+		{
+			return Clock->StepIndex * (double)Clock->FixedStepSize;
+		}
+	}
+
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+void UCombatClockSubsystem::SetTimer(const UObject* WorldContextObject, FCombatTimerHandle& Handle, FTimerDelegate Delegate, float Rate, bool bLoop, float FirstDelay)
+{
+	UCombatClockSubsystem* Clock = Get(WorldContextObject);
+	if (!Clock || !Clock->bFixedStep)
+	{
+		if (UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr)
+		{
+			World->GetTimerManager().SetTimer(Handle.WorldHandle, MoveTemp(Delegate), Rate, bLoop, FirstDelay);
+		}
+		return;
+	}
+
+	// Like the timer manager, setting an active handle replaces its timer and a rate of 0 only clears it
+	ClearTimer(WorldContextObject, Handle);
+	if (Rate <= 0.0f)
+	{
+		return;
+	}
+
+	FStepTimer& Timer = Clock->StepTimers.AddDefaulted_GetRef();
+	Timer.Id = Clock->NextTimerId++;
+	Timer.Delegate = MoveTemp(Delegate);
+	Timer.IntervalSteps = CombatClock::ToSteps(Rate, Clock->FixedStepSize);
+	Timer.NextStep = Clock->StepIndex + CombatClock::ToSteps(FirstDelay >= 0.0f ? FirstDelay : Rate, Clock->FixedStepSize);
+	Timer.bLoop = bLoop;
+	Handle.StepTimerId = Timer.Id;
+}
+
+void UCombatClockSubsystem::ClearTimer(const UObject* WorldContextObject, FCombatTimerHandle& Handle)
+{
+	if (Handle.StepTimerId != INDEX_NONE)
+	{
+		if (UCombatClockSubsystem* Clock = Get(WorldContextObject))
+		{
+			const int32 Id = Handle.StepTimerId;
+			Clock->StepTimers.RemoveAll([Id](const FStepTimer& Timer) { return Timer.Id == Id; });
+		}
+	}
+
+	if (Handle.WorldHandle.IsValid())
+	{
+		if (UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr)
+		{
+			World->GetTimerManager().ClearTimer(Handle.WorldHandle);
+		}
+	}
+
+	Handle.Invalidate();
+}
+
+bool UCombatClockSubsystem::IsTimerActive(const UObject* WorldContextObject, const FCombatTimerHandle& Handle)
+{
+	if (Handle.StepTimerId != INDEX_NONE)
+	{
+		const UCombatClockSubsystem* Clock = Get(WorldContextObject);
+		return Clock && Clock->FindStepTimer(Handle.StepTimerId);
+	}
+
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World && World->GetTimerManager().IsTimerActive(Handle.WorldHandle);
+}
+
+float UCombatClockSubsystem::GetTimerRemaining(const UObject* WorldContextObject, const FCombatTimerHandle& Handle)
+{
+	if (Handle.StepTimerId != INDEX_NONE)
+	{
+		const UCombatClockSubsystem* Clock = Get(WorldContextObject);
+		const FStepTimer* Timer = Clock ? Clock->FindStepTimer(Handle.StepTimerId) : nullptr;
+		return Timer ? (Timer->NextStep - Clock->StepIndex) * Clock->FixedStepSize : -1.0f;
+	}
+
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetTimerManager().GetTimerRemaining(Handle.WorldHandle) : -1.0f;
+}
+
+float UCombatClockSubsystem::FRand(const UObject* WorldContextObject)
+{
+	UCombatClockSubsystem* Clock = Get(WorldContextObject);
+	return Clock && Clock->bFixedStep ? Clock->Random.FRand() : FMath::FRand();
+}
+
+uint32 UCombatClockSubsystem::HashCombatState() const
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatClock_Hash);
+
+	uint32 Crc = FCrc::MemCrc32(&StepIndex, sizeof(StepIndex));
+	const int32 RandomSeed = Random.GetCurrentSeed();
+	Crc = FCrc::MemCrc32(&RandomSeed, sizeof(RandomSeed), Crc);
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (const ATPSPlayer* Player = PlayerController ? Cast<ATPSPlayer>(PlayerController->GetPawn()) : nullptr)
+		{
+			Crc = CombatClock::HashFloat(Player->GetHealthComponent() ? Player->GetHealthComponent()->GetHealth() : 0.0f, Crc);
+			Crc = CombatClock::HashFloat(Player->GetWater(), Crc);
+			Crc = CombatClock::HashLocation(Player->GetActorLocation(), LocationHashGrid, Crc);
+		}
+	}
+
+	const UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	if (!Registry)
+	{
+		return Crc;
+	}
+
+	// Actor ids and registration order differ between runs, so each actor is hashed on its own and the sorted hashes combined
+	ActorHashes.Reset();
+	Registry->ForEachActor<AEnemyCharacter>([this](AEnemyCharacter* Enemy)
+	{
+		if (Enemy->IsPooled())
+		{
+			return;
+		}
+
+		const uint32 EnemyCrc = CombatClock::HashFloat(Enemy->GetHealthComponent() ? Enemy->GetHealthComponent()->GetHealth() : 0.0f, 0);
+		ActorHashes.Add(CombatClock::HashLocation(Enemy->GetActorLocation(), LocationHashGrid, EnemyCrc));
+	});
+	ActorHashes.Sort();
+	Crc = FCrc::MemCrc32(ActorHashes.GetData(), ActorHashes.Num() * ActorHashes.GetTypeSize(), Crc);
+
+	ActorHashes.Reset();
+	Registry->ForEachActor<AEnemySpawner>([this](AEnemySpawner* Spawner)
+	{
+		const FEnemySpawnerState State = Spawner->CaptureState();
+		const int32 Counts[2] = { State.EnemiesSpawnedCount, State.NumberOfEnemiesToSpawn };
+		ActorHashes.Add(FCrc::MemCrc32(Counts, sizeof(Counts)));
+	});
+	ActorHashes.Sort();
+	return FCrc::MemCrc32(ActorHashes.GetData(), ActorHashes.Num() * ActorHashes.GetTypeSize(), Crc);
+}
+
+void UCombatClockSubsystem::CheckDeterminism()
+{
+	const uint32 Hash = HashCombatState();
+
+	if (DeterminismMode == 1)
+	{
+		StepHashes.Add(Hash);
+		return;
+	}
+
+	// Only the first divergence matters, everything after it follows from it
+	const int32 Index = StepHashes.Add(Hash);
+	if (FirstMismatchStep == INDEX_NONE && BaselineHashes.IsValidIndex(Index) && BaselineHashes[Index] != Hash)
+	{
+		FirstMismatchStep = StepIndex;
+		UE_LOG(LogTemp, Warning, TEXT("Combat determinism: step %lld diverged from the recording (%08x, recorded %08x)"), StepIndex, Hash, BaselineHashes[Index]);
+	}
+}
+
+void UCombatClockSubsystem::ReportDeterminism() const
+{
+	if (DeterminismMode == 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Combat determinism: off (summer.Combat.FixedStep 1 and summer.Combat.Determinism 1 or 2, then reload the map)"));
+		return;
+	}
+
+	if (DeterminismMode == 1)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Combat determinism: %d steps hashed, written to %s when the world ends"), StepHashes.Num(), *GetDeterminismFilePath());
+		return;
+	}
+
+	const int32 Compared = FMath::Min(StepHashes.Num(), BaselineHashes.Num());
+	if (FirstMismatchStep != INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Combat determinism: diverged at step %lld of %d compared"), FirstMismatchStep, Compared);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("Combat determinism: %d steps compared, all identical (%d recorded, %d run)"), Compared, BaselineHashes.Num(), StepHashes.Num());
+	}
+}
+
+FString UCombatClockSubsystem::GetDeterminismFilePath() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("Determinism") / GetWorld()->GetMapName() + TEXT(".txt");
+}
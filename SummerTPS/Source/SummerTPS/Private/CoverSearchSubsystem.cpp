@@ -0,0 +1,291 @@
+#include "CoverSearchSubsystem.h"
+#include "SummerTPS.h"
+#include "ActorRegistrySubsystem.h"
+#include "WorldQuerySchedulerSubsystem.h"
+#include "NavigationSystem.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cover Search Tick"), STAT_CoverSearch_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cover Visibility Traces"), STAT_CoverSearch_Traces, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cover Visibility Cache Hits"), STAT_CoverSearch_CacheHits, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cover Visibility Cache Misses"), STAT_CoverSearch_CacheMisses, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cover Refresh Queue"), STAT_CoverSearch_Queue, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cover Points"), STAT_CoverSearch_Points, STATGROUP_SummerTPS);
+
+namespace CoverSearch
+{
+	/** Tickables run in no fixed order, so a trace submitted after the scheduler's tick goes out a frame later */
+	static constexpr int32 VisibilityTraceLatencyFrames = 2;
+}
+
+UCoverSearchSubsystem::UCoverSearchSubsystem()
+{
+	CoverActorTag = TEXT("Cover");
+	CandidateSpacing = 100.0f;
+	CandidateStandoff = 60.0f;
+	MinCoverHeight = 80.0f;
+	TargetHeight = 60.0f;
+	MaxVisibilityDistance = 6000.0f;
+	CacheLifetime = 0.5f;
+	MaxTracesPerFrame = 8;
+	RefreshHead = 0;
+}
+
+void UCoverSearchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Cover actors register in BeginPlay, after every world subsystem is up
+	if (UActorRegistrySubsystem* Registry = Collection.InitializeDependency<UActorRegistrySubsystem>())
+	{
+		ActorRegisteredHandle = Registry->OnActorRegistered.AddUObject(this, &UCoverSearchSubsystem::HandleActorRegistered);
+		ActorUnregisteredHandle = Registry->OnActorUnregistered.AddUObject(this, &UCoverSearchSubsystem::HandleActorUnregistered);
+	}
+}
+
+void UCoverSearchSubsystem::Deinitialize()
+{
+	if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		Registry->OnActorRegistered.Remove(ActorRegisteredHandle);
+		Registry->OnActorUnregistered.Remove(ActorUnregisteredHandle);
+	}
+
+	DEC_DWORD_STAT_BY(STAT_CoverSearch_Points, PointsByLocation.Num());
+
+	CoverPoints.Empty();
+	PointsByLocation.Empty();
+	RefreshQueue.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCoverSearchSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UCoverSearchSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCoverSearchSubsystem, STATGROUP_Tickables);
+}
+
+void UCoverSearchSubsystem::HandleActorRegistered(AActor* Actor)
+{
+	if (Actor && Actor->ActorHasTag(CoverActorTag))
+	{
+		AddCoverPoints(Actor);
+	}
+}
+
+void UCoverSearchSubsystem::HandleActorUnregistered(AActor* Actor)
+{
+	if (!Actor || !Actor->ActorHasTag(CoverActorTag))
+	{
+		return;
+	}
+
+	for (FCoverPoint& Point : CoverPoints)
+	{
+		if (Point.bValid && Point.CoverActor.Get() == Actor)
+		{
+			Point.bValid = false;
+			PointsByLocation.Remove(MakeLocationKey(Point.Location));
+			DEC_DWORD_STAT(STAT_CoverSearch_Points);
+		}
+	}
+}
+
+void UCoverSearchSubsystem::AddCoverPoints(AActor* CoverActor)
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys)
+	{
+		return;
+	}
+
+	const FBox LocalBox = CoverActor->CalculateComponentsBoundingBoxInLocalSpace();
+	if (!LocalBox.IsValid || LocalBox.GetSize().Z * CoverActor->GetActorScale3D().Z < MinCoverHeight)
+	{
+		return;
+	}
+
+	const FTransform& ActorTransform = CoverActor->GetActorTransform();
+	const FVector Center = LocalBox.GetCenter();
+	const FVector Extent = LocalBox.GetExtent();
+	const FVector NavExtent(CandidateStandoff, CandidateStandoff, LocalBox.GetSize().Z);
+
+	// One row of points along each of the four side faces, in the actor's space so rotated cover boxes work
+	static const FVector FaceNormals[] = { FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector, FVector::LeftVector };
+	for (const FVector& LocalNormal : FaceNormals)
+	{
+		const FVector LocalTangent = FVector::CrossProduct(FVector::UpVector, LocalNormal);
+		const FVector WorldNormal = ActorTransform.TransformVectorNoScale(LocalNormal).GetSafeNormal2D();
+		const float FaceHalfLength = (float)FMath::Abs(FVector::DotProduct(Extent * ActorTransform.GetScale3D(), LocalTangent));
+		const float FaceDepth = (float)FMath::Abs(FVector::DotProduct(Extent * ActorTransform.GetScale3D(), LocalNormal));
+		const int32 NumAlongFace = FMath::Max(1, FMath::FloorToInt(2.0f * FaceHalfLength / CandidateSpacing));
+
+		const FVector FaceCenter = ActorTransform.TransformPosition(FVector(Center.X, Center.Y, LocalBox.Min.Z));
+		const FVector WorldTangent = ActorTransform.TransformVectorNoScale(LocalTangent).GetSafeNormal2D();
+
+		for (int32 Step = 0; Step < NumAlongFace; ++Step)
+		{
+			const float Along = (NumAlongFace == 1) ? 0.0f : FMath::Lerp(-FaceHalfLength, FaceHalfLength, (Step + 0.5f) / NumAlongFace);
+			const FVector Candidate = FaceCenter + WorldNormal * (FaceDepth + CandidateStandoff) + WorldTangent * Along;
+
+			FNavLocation Projected;
+			if (!NavSys->ProjectPointToNavigation(Candidate, Projected, NavExtent))
+			{
+				continue;
+			}
+
+			const FIntVector Key = MakeLocationKey(Projected.Location);
+			if (PointsByLocation.Contains(Key))
+			{
+				continue;
+			}
+
+			FCoverPoint& Point = CoverPoints.AddDefaulted_GetRef();
+			Point.Location = FVector(Key);
+			Point.WallNormal = WorldNormal;
+			Point.CoverActor = CoverActor;
+			PointsByLocation.Add(Key, CoverPoints.Num() - 1);
+			INC_DWORD_STAT(STAT_CoverSearch_Points);
+		}
+	}
+}
+
+void UCoverSearchSubsystem::GatherCoverPoints(const FVector& Center, float Radius, TArray<int32, FFrameArenaAllocator>& OutIndices) const
+{
+	const float RadiusSq = FMath::Square(Radius);
+	for (int32 Index = 0; Index < CoverPoints.Num(); ++Index)
+	{
+		const FCoverPoint& Point = CoverPoints[Index];
+		if (Point.bValid && FVector::DistSquared(Point.Location, Center) <= RadiusSq)
+		{
+			OutIndices.Add(Index);
+		}
+	}
+}
+
+int32 UCoverSearchSubsystem::FindCoverPointAt(const FVector& Location) const
+{
+	const int32* Index = PointsByLocation.Find(MakeLocationKey(Location));
+	return Index ? *Index : INDEX_NONE;
+}
+
+ECoverVisibility UCoverSearchSubsystem::RequestVisibility(int32 Index)
+{
+	FCoverPoint& Point = CoverPoints[Index];
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	const bool bEvaluated = Point.LastEvaluatedTime >= 0.0;
+	if (bEvaluated && Now - Point.LastEvaluatedTime < CacheLifetime)
+	{
+		INC_DWORD_STAT(STAT_CoverSearch_CacheHits);
+		return Point.bHidden ? ECoverVisibility::Hidden : ECoverVisibility::Exposed;
+	}
+
+	INC_DWORD_STAT(STAT_CoverSearch_CacheMisses);
+
+	if (!Point.bQueued)
+	{
+		Point.bQueued = true;
+		RefreshQueue.Add(Index);
+	}
+
+	// A slightly stale answer beats none; the refresh lands within a few frames
+	if (bEvaluated)
+	{
+		return Point.bHidden ? ECoverVisibility::Hidden : ECoverVisibility::Exposed;
+	}
+
+	return ECoverVisibility::Unknown;
+}
+
+void UCoverSearchSubsystem::SetVisibility(FCoverPoint& Point, bool bHidden, double Now)
+{
+	Point.bHidden = bHidden;
+	Point.LastEvaluatedTime = Now;
+	Point.bQueued = false;
+}
+
+void UCoverSearchSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CoverSearch_Tick);
+
+	SET_DWORD_STAT(STAT_CoverSearch_Queue, RefreshQueue.Num() - RefreshHead);
+
+	if (RefreshHead >= RefreshQueue.Num())
+	{
+		return;
+	}
+
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	UWorldQuerySchedulerSubsystem* Queries = GetWorld()->GetSubsystem<UWorldQuerySchedulerSubsystem>();
+	if (!PlayerPawn || !Queries)
+	{
+		return;
+	}
+
+	FVector EyeLocation;
+	FRotator EyeRotation;
+	PlayerPawn->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CoverVisibility), false, PlayerPawn);
+
+	int32 NumTraces = 0;
+	while (RefreshHead < RefreshQueue.Num() && NumTraces < MaxTracesPerFrame)
+	{
+		const int32 Index = RefreshQueue[RefreshHead++];
+		FCoverPoint& Point = CoverPoints[Index];
+		if (!Point.bValid)
+		{
+			Point.bQueued = false;
+			continue;
+		}
+
+		const FVector Target = Point.Location + FVector(0.0f, 0.0f, TargetHeight);
+		const FVector ToPlayer = EyeLocation - Target;
+
+		// The player is on the open side of this face, or too far to matter: no trace needed
+		if (FVector::DotProduct(ToPlayer, Point.WallNormal) > 0.0f)
+		{
+			SetVisibility(Point, false, Now);
+			continue;
+		}
+		if (ToPlayer.SizeSquared() > FMath::Square(MaxVisibilityDistance))
+		{
+			SetVisibility(Point, true, Now);
+			continue;
+		}
+
+		Queries->SubmitLineTrace(EWorldQueryCategory::AI, EyeLocation, Target, ECC_Visibility, QueryParams, CoverSearch::VisibilityTraceLatencyFrames,
+			[WeakThis = TWeakObjectPtr<UCoverSearchSubsystem>(this), Index](const FWorldQueryResult& Result)
+			{
+				if (UCoverSearchSubsystem* Subsystem = WeakThis.Get())
+				{
+					Subsystem->OnVisibilityTraceDone(Index, Result);
+				}
+			});
+		++NumTraces;
+	}
+
+	INC_DWORD_STAT_BY(STAT_CoverSearch_Traces, NumTraces);
+
+	if (RefreshHead >= RefreshQueue.Num())
+	{
+		RefreshQueue.Reset();
+		RefreshHead = 0;
+	}
+}
+
+void UCoverSearchSubsystem::OnVisibilityTraceDone(int32 Index, const FWorldQueryResult& Result)
+{
+	// Anything blocking between the player's eyes and the point hides it
+	if (CoverPoints.IsValidIndex(Index))
+	{
+		SetVisibility(CoverPoints[Index], Result.bBlockingHit, GetWorld()->GetTimeSeconds());
+	}
+}
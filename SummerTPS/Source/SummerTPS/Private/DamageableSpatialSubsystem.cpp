@@ -0,0 +1,266 @@
+#include "DamageableSpatialSubsystem.h"
+#include "SummerTPS.h"
+#include "HealthComponent.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damageable Hash Update"), STAT_DamageableHash_Update, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Damageable Hash Query"), STAT_DamageableHash_Query, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damageable Queries"), STAT_DamageableHash_Queries, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damageable Cell Moves"), STAT_DamageableHash_CellMoves, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Splash Damage Applications"), STAT_DamageableHash_SplashHits, STATGROUP_SummerTPS);
+
+UDamageableSpatialSubsystem::UDamageableSpatialSubsystem()
+{
+	CellSize = 500.0f;
+	MaxEntryRadius = 0.0f;
+}
+
+bool UDamageableSpatialSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UDamageableSpatialSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageableSpatialSubsystem, STATGROUP_Tickables);
+}
+
+FIntVector UDamageableSpatialSubsystem::ToCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UDamageableSpatialSubsystem::AddToCell(const FIntVector& Cell, int32 EntryIndex)
+{
+	Cells.FindOrAdd(Cell).Add(EntryIndex);
+}
+
+void UDamageableSpatialSubsystem::RemoveFromCell(const FIntVector& Cell, int32 EntryIndex)
+{
+	if (TArray<int32, TInlineAllocator<8>>* Bucket = Cells.Find(Cell))
+	{
+		Bucket->RemoveSingleSwap(EntryIndex);
+		if (Bucket->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UDamageableSpatialSubsystem::RegisterDamageable(UHealthComponent* HealthComponent)
+{
+	AActor* Owner = HealthComponent ? HealthComponent->GetOwner() : nullptr;
+	if (!Owner || EntryIndices.Contains(HealthComponent))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = Entries.AddDefaulted();
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.HealthComponent = HealthComponent;
+	Entry.Owner = Owner;
+	Entry.Location = Owner->GetActorLocation();
+	Entry.Radius = Owner->GetSimpleCollisionRadius();
+	Entry.Cell = ToCell(Entry.Location);
+
+	MaxEntryRadius = FMath::Max(MaxEntryRadius, Entry.Radius);
+	EntryIndices.Add(HealthComponent, EntryIndex);
+	AddToCell(Entry.Cell, EntryIndex);
+}
+
+void UDamageableSpatialSubsystem::UnregisterDamageable(UHealthComponent* HealthComponent)
+{
+	if (const int32* EntryIndex = EntryIndices.Find(HealthComponent))
+	{
+		RemoveEntryAt(*EntryIndex);
+	}
+}
+
+void UDamageableSpatialSubsystem::RemoveEntryAt(int32 EntryIndex)
+{
+	RemoveFromCell(Entries[EntryIndex].Cell, EntryIndex);
+	EntryIndices.Remove(Entries[EntryIndex].HealthComponent);
+
+	// Swap the last entry into the hole and patch its cell bucket and index
+	const int32 LastIndex = Entries.Num() - 1;
+	if (EntryIndex != LastIndex)
+	{
+		FEntry& Moved = Entries[LastIndex];
+		if (TArray<int32, TInlineAllocator<8>>* Bucket = Cells.Find(Moved.Cell))
+		{
+			const int32 SlotIndex = Bucket->Find(LastIndex);
+			if (SlotIndex != INDEX_NONE)
+			{
+				(*Bucket)[SlotIndex] = EntryIndex;
+			}
+		}
+		EntryIndices.Add(Moved.HealthComponent, EntryIndex);
+	}
+
+	Entries.RemoveAtSwap(EntryIndex);
+}
+
+void UDamageableSpatialSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageableHash_Update);
+
+	int32 NumCellMoves = 0;
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		FEntry& Entry = Entries[EntryIndex];
+		const AActor* Owner = Entry.Owner.Get();
+		if (!Owner || !Entry.HealthComponent.IsValid())
+		{
+			RemoveEntryAt(EntryIndex);
+			continue;
+		}
+
+		Entry.Location = Owner->GetActorLocation();
+
+		const FIntVector NewCell = ToCell(Entry.Location);
+		if (NewCell != Entry.Cell)
+		{
+			RemoveFromCell(Entry.Cell, EntryIndex);
+			AddToCell(NewCell, EntryIndex);
+			Entry.Cell = NewCell;
+			++NumCellMoves;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_DamageableHash_CellMoves, NumCellMoves);
+}
+
+template <typename FunctorType>
+void UDamageableSpatialSubsystem::ForEachInBox(const FBox& Box, FunctorType&& Functor) const
+{
+	const FIntVector MinCell = ToCell(Box.Min);
+	const FIntVector MaxCell = ToCell(Box.Max);
+
+	for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				if (const TArray<int32, TInlineAllocator<8>>* Bucket = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					for (const int32 EntryIndex : *Bucket)
+					{
+						Functor(Entries[EntryIndex]);
+					}
+				}
+			}
+		}
+	}
+}
+
+int32 UDamageableSpatialSubsystem::QueryRadius(const FVector& Center, float Radius, TArray<FDamageableQueryHit>& OutHits) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageableHash_Query);
+	INC_DWORD_STAT(STAT_DamageableHash_Queries);
+
+	OutHits.Reset();
+
+	const FBox QueryBox = FBox::BuildAABB(Center, FVector(Radius + MaxEntryRadius));
+	ForEachInBox(QueryBox, [&](const FEntry& Entry)
+	{
+		UHealthComponent* HealthComponent = Entry.HealthComponent.Get();
+		if (!HealthComponent || HealthComponent->IsDead())
+		{
+			return;
+		}
+
+		const float SurfaceDistance = FMath::Max(FVector::Dist(Center, Entry.Location) - Entry.Radius, 0.0f);
+		if (SurfaceDistance <= Radius)
+		{
+			OutHits.Add({ HealthComponent, SurfaceDistance });
+		}
+	});
+
+	return OutHits.Num();
+}
+
+int32 UDamageableSpatialSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Length, TArray<FDamageableQueryHit>& OutHits) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageableHash_Query);
+	INC_DWORD_STAT(STAT_DamageableHash_Queries);
+
+	OutHits.Reset();
+
+	const FVector Axis = Direction.GetSafeNormal();
+	if (Axis.IsZero())
+	{
+		return 0;
+	}
+
+	const float HalfAngle = FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.0f, 89.0f));
+	const float CosHalfAngle = FMath::Cos(HalfAngle);
+	const float SinHalfAngle = FMath::Sin(HalfAngle);
+
+	// Bounds of the cone: apex plus the end cap disc
+	const FVector EndCenter = Origin + Axis * Length;
+	const float CapRadius = Length * FMath::Tan(HalfAngle);
+	FBox QueryBox = FBox::BuildAABB(EndCenter, FVector(CapRadius));
+	QueryBox += Origin;
+	QueryBox = QueryBox.ExpandBy(MaxEntryRadius);
+
+	ForEachInBox(QueryBox, [&](const FEntry& Entry)
+	{
+		UHealthComponent* HealthComponent = Entry.HealthComponent.Get();
+		if (!HealthComponent || HealthComponent->IsDead())
+		{
+			return;
+		}
+
+		const FVector ToEntry = Entry.Location - Origin;
+		const float AlongAxis = FVector::DotProduct(ToEntry, Axis);
+		if (AlongAxis < -Entry.Radius || AlongAxis > Length + Entry.Radius)
+		{
+			return;
+		}
+
+		// Distance from the entry's center to the cone surface, so actors poking into the cone with their collision count
+		const float FromAxis = (ToEntry - Axis * AlongAxis).Size();
+		const float OutsideDistance = FromAxis * CosHalfAngle - AlongAxis * SinHalfAngle;
+		if (OutsideDistance <= Entry.Radius)
+		{
+			OutHits.Add({ HealthComponent, FMath::Max(ToEntry.Size() - Entry.Radius, 0.0f) });
+		}
+	});
+
+	return OutHits.Num();
+}
+
+int32 UDamageableSpatialSubsystem::ApplyRadialDamage(const FVector& Center, float Radius, float BaseDamage, float MinimumDamage, float FalloffExponent,
+	AActor* DamageCauser, AController* InstigatedBy, TSubclassOf<UDamageType> DamageTypeClass, TConstArrayView<AActor*> IgnoreActors)
+{
+	// Borrow the scratch array; a nested call (damage handler causing another splash) just gets a fresh one
+	TArray<FDamageableQueryHit> Hits = MoveTemp(RadialDamageScratch);
+	QueryRadius(Center, Radius, Hits);
+
+	int32 NumDamaged = 0;
+	for (const FDamageableQueryHit& Hit : Hits)
+	{
+		AActor* Victim = Hit.HealthComponent->GetOwner();
+		if (!Victim || IgnoreActors.Contains(Victim))
+		{
+			continue;
+		}
+
+		const float Alpha = Radius > 0.0f ? FMath::Clamp(Hit.Distance / Radius, 0.0f, 1.0f) : 0.0f;
+		const float Damage = FMath::Lerp(BaseDamage, MinimumDamage, FMath::Pow(Alpha, FMath::Max(FalloffExponent, UE_KINDA_SMALL_NUMBER)));
+
+		// Through the regular pipeline so OnTakeAnyDamage, the health component and death handling all see it
+		UGameplayStatics::ApplyDamage(Victim, Damage, InstigatedBy, DamageCauser, DamageTypeClass ? DamageTypeClass : TSubclassOf<UDamageType>(UDamageType::StaticClass()));
+		++NumDamaged;
+	}
+
+	RadialDamageScratch = MoveTemp(Hits);
+
+	INC_DWORD_STAT_BY(STAT_DamageableHash_SplashHits, NumDamaged);
+	return NumDamaged;
+}
@@ -1,9 +1,27 @@
 #include "EnemyAIController.h"
+#include "EnemyBehaviorTreeComponent.h"
+#include "EnemySignificanceSubsystem.h"
+#include "Navigation/CrowdFollowingComponent.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "HAL/IConsoleManager.h"
 
-AEnemyAIController::AEnemyAIController()
+static TAutoConsoleVariable<bool> CVarUseNativeBehaviorTree(
+	TEXT("summer.AI.UseNativeBehaviorTree"),
+	true,
+	TEXT("If true, enemies run their NativeBehaviorTree (native tasks/services) instead of the Blueprint task tree when one is assigned.\n")
+	TEXT("Takes effect the next time a behavior tree is started."),
+	ECVF_Default);
+
+AEnemyAIController::AEnemyAIController(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UCrowdFollowingComponent>(TEXT("PathFollowingComponent")))
 {
+	// AAIController::RunBehaviorTree reuses BrainComponent when it already is a behavior tree component
+	EnemyBehaviorTreeComponent = CreateDefaultSubobject<UEnemyBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
+	BrainComponent = EnemyBehaviorTreeComponent;
+
+	PendingCrowdSimulationState = ECrowdSimulationState::Enabled;
+	bHasPendingCrowdSimulationState = false;
 }
 
 void AEnemyAIController::BeginPlay()
@@ -20,3 +38,81 @@ void AEnemyAIController::BeginPlay()
 		RunBehaviorTree(BehaviorTree);
 	}
 }
+
+bool AEnemyAIController::RunBehaviorTree(UBehaviorTree* BTAsset)
+{
+	UBehaviorTree* TreeToRun = BTAsset;
+	if (BTAsset == BehaviorTree && NativeBehaviorTree && CVarUseNativeBehaviorTree.GetValueOnGameThread())
+	{
+		TreeToRun = NativeBehaviorTree;
+	}
+
+	if (EnemyBehaviorTreeComponent)
+	{
+		EnemyBehaviorTreeComponent->SetCostCategory(TreeToRun == NativeBehaviorTree ? EEnemyBTCostCategory::Native : EEnemyBTCostCategory::Blueprint);
+	}
+
+	return Super::RunBehaviorTree(TreeToRun);
+}
+
+void AEnemyAIController::SetBehaviorTreeTickInterval(float Interval)
+{
+	if (EnemyBehaviorTreeComponent)
+	{
+		EnemyBehaviorTreeComponent->SetLODTickInterval(Interval);
+	}
+}
+
+void AEnemyAIController::SetCrowdAvoidance(EEnemyCrowdAvoidance Avoidance)
+{
+	UCrowdFollowingComponent* CrowdFollowing = Cast<UCrowdFollowingComponent>(GetPathFollowingComponent());
+	if (!CrowdFollowing)
+	{
+		return;
+	}
+
+	if (Avoidance != EEnemyCrowdAvoidance::Off)
+	{
+		ECrowdAvoidanceQuality::Type Quality = ECrowdAvoidanceQuality::High;
+		switch (Avoidance)
+		{
+		case EEnemyCrowdAvoidance::Low:		Quality = ECrowdAvoidanceQuality::Low; break;
+		case EEnemyCrowdAvoidance::Medium:	Quality = ECrowdAvoidanceQuality::Medium; break;
+		case EEnemyCrowdAvoidance::Good:	Quality = ECrowdAvoidanceQuality::Good; break;
+		default:							break;
+		}
+
+		// Quality applies immediately, even mid-move
+		CrowdFollowing->SetCrowdAvoidanceQuality(Quality);
+	}
+
+	// Still registered when off so nearer agents steer around it, but it skips its own avoidance sampling
+	PendingCrowdSimulationState = Avoidance == EEnemyCrowdAvoidance::Off ? ECrowdSimulationState::ObstacleOnly : ECrowdSimulationState::Enabled;
+	bHasPendingCrowdSimulationState = true;
+	ApplyPendingCrowdSimulationState();
+}
+
+void AEnemyAIController::OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result)
+{
+	Super::OnMoveCompleted(RequestID, Result);
+
+	ApplyPendingCrowdSimulationState();
+}
+
+void AEnemyAIController::ApplyPendingCrowdSimulationState()
+{
+	UCrowdFollowingComponent* CrowdFollowing = Cast<UCrowdFollowingComponent>(GetPathFollowingComponent());
+	if (!bHasPendingCrowdSimulationState || !CrowdFollowing)
+	{
+		return;
+	}
+
+	// The crowd component ignores simulation state changes while a move is active, so keep it for the end of the move
+	if (CrowdFollowing->GetStatus() != EPathFollowingStatus::Idle)
+	{
+		return;
+	}
+
+	CrowdFollowing->SetCrowdSimulationState(PendingCrowdSimulationState);
+	bHasPendingCrowdSimulationState = false;
+}
@@ -0,0 +1,27 @@
+#include "EnemyAnimSharingStateProcessor.h"
+#include "EnemyAIState.h"
+#include "EnemyCharacter.h"
+
+UEnemyAnimSharingStateProcessor::UEnemyAnimSharingStateProcessor()
+{
+	AnimationStateEnum = StaticEnum<EEnemyAIState>();
+}
+
+void UEnemyAnimSharingStateProcessor::ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess)
+{
+	const AEnemyCharacter* Enemy = Cast<AEnemyCharacter>(InActor);
+	if (!Enemy)
+	{
+		OutState = CurrentState;
+		bShouldProcess = false;
+		return;
+	}
+
+	OutState = static_cast<int32>(Enemy->GetAIState());
+	bShouldProcess = true;
+}
+
+UEnum* UEnemyAnimSharingStateProcessor::GetAnimationStateEnum_Implementation()
+{
+	return StaticEnum<EEnemyAIState>();
+}
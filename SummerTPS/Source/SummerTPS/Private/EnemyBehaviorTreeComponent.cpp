@@ -0,0 +1,127 @@
+#include "EnemyBehaviorTreeComponent.h"
+#include "SummerTPS.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy BT Tick (Blueprint tasks)"), STAT_EnemyBT_Blueprint, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Enemy BT Tick (Native tasks)"), STAT_EnemyBT_Native, STATGROUP_SummerTPS);
+
+namespace EnemyBTBenchmark
+{
+	struct FCategoryCost
+	{
+		/** Accumulated tick time in cycles */
+		uint64 Cycles = 0;
+
+		/** Sum over frames of the number of live components, used to normalize to "per enemy per frame" */
+		uint64 EnemyFrames = 0;
+
+		/** Components currently running in this category */
+		int32 LiveComponents = 0;
+
+		/** Last frame EnemyFrames was advanced for */
+		uint64 LastCountedFrame = 0;
+	};
+
+	static FCategoryCost Costs[(int32)EEnemyBTCostCategory::MAX];
+
+	static FAutoConsoleCommand ReportCommand(
+		TEXT("summer.AI.BTBenchmark.Report"),
+		TEXT("Prints the average behavior tree cost per enemy per frame, split by Blueprint and native task trees."),
+		FConsoleCommandDelegate::CreateStatic(&UEnemyBehaviorTreeComponent::ReportBenchmark));
+
+	static FAutoConsoleCommand ResetCommand(
+		TEXT("summer.AI.BTBenchmark.Reset"),
+		TEXT("Clears the accumulated behavior tree benchmark timings."),
+		FConsoleCommandDelegate::CreateStatic(&UEnemyBehaviorTreeComponent::ResetBenchmark));
+}
+
+void UEnemyBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	EnemyBTBenchmark::FCategoryCost& Cost = EnemyBTBenchmark::Costs[(int32)CostCategory];
+
+	// Advance the enemy-frame counter once per frame per category, so enemies whose tree skipped a tick
+	// still count towards the per-enemy average
+	if (Cost.LastCountedFrame != GFrameCounter)
+	{
+		Cost.LastCountedFrame = GFrameCounter;
+		Cost.EnemyFrames += Cost.LiveComponents;
+	}
+
+	if (LODTickInterval > 0.0f)
+	{
+		AccumulatedLODDeltaTime += DeltaTime;
+		if (AccumulatedLODDeltaTime < LODTickInterval)
+		{
+			return;
+		}
+		DeltaTime = AccumulatedLODDeltaTime;
+		AccumulatedLODDeltaTime = 0.0f;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	{
+		FScopeCycleCounter CycleCounter(CostCategory == EEnemyBTCostCategory::Native ? GET_STATID(STAT_EnemyBT_Native) : GET_STATID(STAT_EnemyBT_Blueprint));
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	}
+	Cost.Cycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void UEnemyBehaviorTreeComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (!bIsCounted)
+	{
+		EnemyBTBenchmark::Costs[(int32)CostCategory].LiveComponents++;
+		bIsCounted = true;
+	}
+}
+
+void UEnemyBehaviorTreeComponent::OnUnregister()
+{
+	if (bIsCounted)
+	{
+		EnemyBTBenchmark::Costs[(int32)CostCategory].LiveComponents--;
+		bIsCounted = false;
+	}
+
+	Super::OnUnregister();
+}
+
+void UEnemyBehaviorTreeComponent::SetCostCategory(EEnemyBTCostCategory NewCategory)
+{
+	if (NewCategory == CostCategory)
+	{
+		return;
+	}
+
+	if (bIsCounted)
+	{
+		EnemyBTBenchmark::Costs[(int32)CostCategory].LiveComponents--;
+		EnemyBTBenchmark::Costs[(int32)NewCategory].LiveComponents++;
+	}
+	CostCategory = NewCategory;
+}
+
+void UEnemyBehaviorTreeComponent::ReportBenchmark()
+{
+	for (int32 Index = 0; Index < (int32)EEnemyBTCostCategory::MAX; ++Index)
+	{
+		const EnemyBTBenchmark::FCategoryCost& Cost = EnemyBTBenchmark::Costs[Index];
+		const double TotalMs = FPlatformTime::ToMilliseconds64(Cost.Cycles);
+		const double PerEnemyUs = Cost.EnemyFrames > 0 ? (TotalMs * 1000.0) / (double)Cost.EnemyFrames : 0.0;
+
+		UE_LOG(LogTemp, Display, TEXT("Enemy BT [%s]: %d live, %llu enemy-frames, %.3f ms total, %.3f us per enemy per frame"),
+			*StaticEnum<EEnemyBTCostCategory>()->GetNameStringByIndex(Index), Cost.LiveComponents, Cost.EnemyFrames, TotalMs, PerEnemyUs);
+	}
+}
+
+void UEnemyBehaviorTreeComponent::ResetBenchmark()
+{
+	for (EnemyBTBenchmark::FCategoryCost& Cost : EnemyBTBenchmark::Costs)
+	{
+		Cost.Cycles = 0;
+		Cost.EnemyFrames = 0;
+		Cost.LastCountedFrame = 0;
+	}
+}
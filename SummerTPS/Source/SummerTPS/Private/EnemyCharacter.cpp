@@ -6,10 +6,24 @@
 #include "EnemyAIController.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BrainComponent.h"
 #include "Perception/AIPerceptionStimuliSourceComponent.h"
 #include "Perception/AISenseConfig_Sight.h"
+#include "Perception/AISense_Sight.h"
+#include "EnemySignificanceSubsystem.h"
+#include "EnemyDecisionSubsystem.h"
+#include "AttackTokenComponent.h"
+#include "ActorRegistrySubsystem.h"
+#include "DamageableSpatialSubsystem.h"
+#include "WetnessSubsystem.h"
+#include "ObjectChurnSubsystem.h"
+#include "AnimationSharingManager.h"
+#include "AnimationSharingSetup.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
 
-AEnemyCharacter::AEnemyCharacter()
+AEnemyCharacter::AEnemyCharacter(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
     PrimaryActorTick.bCanEverTick = true;
 
@@ -31,6 +45,13 @@ AEnemyCharacter::AEnemyCharacter()
     AIPerceptionComponent->OnTargetPerceptionUpdated.AddDynamic(this, &AEnemyCharacter::OnPerceptionUpdated);
 
     bIsDead = false;
+    bIsPooled = false;
+    bHasPerceivedTarget = false;
+    LastAttackTime = -1.0;
+    PatrolOrigin = FVector::ZeroVector;
+    PatrolAreaRadius = -1.0f;
+    bUsesAnimationSharing = false;
+    AnimationSharingSetup = nullptr;
 }
 
 void AEnemyCharacter::BeginPlay()
@@ -42,6 +63,8 @@ void AEnemyCharacter::BeginPlay()
         HealthComponent->OnHealthChanged.AddDynamic(this, &AEnemyCharacter::OnHealthChanged);
     }
 
+    MeshCollisionProfileName = GetMesh()->GetCollisionProfileName();
+
     if (DefaultWeaponClass)
     {
         CurrentWeapon = GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass);
@@ -60,17 +83,56 @@ void AEnemyCharacter::BeginPlay()
         {
             AICon->BehaviorTree = BehaviorTree;
             AICon->BlackboardData = BlackboardData;
+            AICon->NativeBehaviorTree = NativeBehaviorTree;
             AICon->RunBehaviorTree(BehaviorTree);
         }
     }
+
+    if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+    {
+        Significance->RegisterEnemy(this);
+    }
+
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->RegisterActor(this);
+    }
+
+    RegisterAnimationSharing();
+}
+
+void AEnemyCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    ReleaseAttackToken();
+    UnregisterAnimationSharing();
+
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->UnregisterActor(this);
+    }
+
+    if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+    {
+        Significance->UnregisterEnemy(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void AEnemyCharacter::OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
 {
+    bHasPerceivedTarget = Stimulus.WasSuccessfullySensed();
+
+    // The batched decision phase picks the best of all perceived actors instead of the last one reported
+    if (UEnemyDecisionSubsystem::IsEnabled())
+    {
+        return;
+    }
+
     AEnemyAIController* AICon = Cast<AEnemyAIController>(GetController());
     if (AICon && AICon->GetBlackboardComponent())
     {
-        if (Stimulus.WasSuccessfullySensed())
+        if (bHasPerceivedTarget)
         {
             AICon->GetBlackboardComponent()->SetValueAsObject(TEXT("TargetActor"), Actor);
         }
@@ -81,6 +143,27 @@ void AEnemyCharacter::OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
     }
 }
 
+void AEnemyCharacter::SetPatrolArea(const FVector& Origin, float Radius)
+{
+    PatrolOrigin = Origin;
+    PatrolAreaRadius = FMath::Max(Radius, 0.0f);
+}
+
+void AEnemyCharacter::OnNoiseHeard(const FVector& NoiseLocation, float Loudness, AActor* NoiseSource)
+{
+    if (bIsDead || bIsPooled || bHasPerceivedTarget || Loudness < HearingThreshold)
+    {
+        return;
+    }
+
+    AEnemyAIController* AICon = Cast<AEnemyAIController>(GetController());
+    if (AICon && AICon->GetBlackboardComponent())
+    {
+        // Only a place to go and look, sight decides whether the source becomes TargetActor
+        AICon->GetBlackboardComponent()->SetValueAsVector(TEXT("InvestigateLocation"), NoiseLocation);
+    }
+}
+
 void AEnemyCharacter::OnHealthChanged(UHealthComponent* OwningHealthComp, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser)
 {
     if (Health <= 0.0f && !bIsDead)
@@ -95,6 +178,10 @@ void AEnemyCharacter::OnHealthChanged(UHealthComponent* OwningHealthComp, float
 void AEnemyCharacter::OnDeath_Implementation()
 {
     // Stop AI logic here
+    ReleaseAttackToken();
+
+    // The ragdoll needs the mesh's own pose, not a shared one
+    UnregisterAnimationSharing();
     GetCharacterMovement()->StopMovementImmediately();
     GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
@@ -113,8 +200,292 @@ void AEnemyCharacter::Tick(float DeltaTime)
 
 void AEnemyCharacter::Attack()
 {
-    if (CurrentWeapon && !bIsDead)
+    AActor* Target = nullptr;
+    if (AEnemyAIController* AICon = Cast<AEnemyAIController>(GetController()))
+    {
+        if (UBlackboardComponent* BBComp = AICon->GetBlackboardComponent())
+        {
+            Target = Cast<AActor>(BBComp->GetValueAsObject(TEXT("TargetActor")));
+        }
+    }
+
+    TryAttack(Target);
+}
+
+bool AEnemyCharacter::TryAttack(AActor* Target)
+{
+    if (!CurrentWeapon || bIsDead)
+    {
+        return false;
+    }
+
+    if (UAttackTokenComponent* TokenComp = Target ? Target->FindComponentByClass<UAttackTokenComponent>() : nullptr)
+    {
+        // Closer attackers win contended slots
+        const float Distance = FVector::Dist(GetActorLocation(), Target->GetActorLocation());
+        const float Priority = AttackPriority + FMath::Clamp(1.0f - Distance / 2000.0f, 0.0f, 1.0f);
+
+        if (!TokenComp->TryAcquireToken(this, Priority))
+        {
+            return false;
+        }
+
+        if (HeldAttackToken.Get() != TokenComp)
+        {
+            ReleaseAttackToken();
+            HeldAttackToken = TokenComp;
+        }
+    }
+
+    CurrentWeapon->Fire();
+    LastAttackTime = GetWorld()->GetTimeSeconds();
+    return true;
+}
+
+EEnemyAIState AEnemyCharacter::GetAIState() const
+{
+    if (bIsDead)
+    {
+        return EEnemyAIState::EAS_Dead;
+    }
+
+    if (LastAttackTime >= 0.0 && GetWorld()->GetTimeSeconds() - LastAttackTime < AttackAnimationTime)
+    {
+        return EEnemyAIState::EAS_Attack;
+    }
+
+    if (GetVelocity().SizeSquared2D() > FMath::Square(10.0f))
+    {
+        return bHasPerceivedTarget ? EEnemyAIState::EAS_Chase : EEnemyAIState::EAS_Patrol;
+    }
+
+    return EEnemyAIState::EAS_Idle;
+}
+
+void AEnemyCharacter::RegisterAnimationSharing()
+{
+    if (bUsesAnimationSharing || !AnimationSharingSetup || !UAnimationSharingManager::AnimationSharingEnabled())
+    {
+        return;
+    }
+
+    const USkeletalMesh* SkeletalMesh = GetMesh()->GetSkeletalMeshAsset();
+    if (!SkeletalMesh || !SkeletalMesh->GetSkeleton())
+    {
+        return;
+    }
+
+    UAnimationSharingManager* Manager = UAnimationSharingManager::GetAnimationSharingManager(this);
+    if (!Manager && UAnimationSharingManager::CreateAnimationSharingManager(this, AnimationSharingSetup))
+    {
+        Manager = UAnimationSharingManager::GetAnimationSharingManager(this);
+    }
+
+    if (Manager)
+    {
+        Manager->RegisterActorWithSkeletonBP(this, SkeletalMesh->GetSkeleton());
+        bUsesAnimationSharing = true;
+    }
+}
+
+void AEnemyCharacter::UnregisterAnimationSharing()
+{
+    if (!bUsesAnimationSharing)
+    {
+        return;
+    }
+
+    if (UAnimationSharingManager* Manager = UAnimationSharingManager::GetAnimationSharingManager(this))
+    {
+        Manager->UnregisterActor(this);
+    }
+    bUsesAnimationSharing = false;
+}
+
+void AEnemyCharacter::ReleaseAttackToken()
+{
+    if (UAttackTokenComponent* TokenComp = HeldAttackToken.Get())
+    {
+        TokenComp->ReleaseToken(this);
+    }
+    HeldAttackToken.Reset();
+}
+
+void AEnemyCharacter::ApplyLODSettings(const FEnemyLODTierSettings& Settings)
+{
+    if (bIsDead)
+    {
+        return;
+    }
+
+    if (AEnemyAIController* AICon = Cast<AEnemyAIController>(GetController()))
+    {
+        AICon->SetBehaviorTreeTickInterval(Settings.BehaviorTreeTickInterval);
+        AICon->SetCrowdAvoidance(Settings.CrowdAvoidance);
+    }
+
+    if (AIPerceptionComponent)
+    {
+        AIPerceptionComponent->SetSenseEnabled(UAISense_Sight::StaticClass(), Settings.bEnableSight);
+    }
+
+    UCharacterMovementComponent* MoveComp = GetCharacterMovement();
+    MoveComp->SetComponentTickInterval(Settings.MovementTickInterval);
+    if (Settings.bUseNavWalking && MoveComp->MovementMode == MOVE_Walking)
+    {
+        MoveComp->SetMovementMode(MOVE_NavWalking);
+    }
+    else if (!Settings.bUseNavWalking && MoveComp->MovementMode == MOVE_NavWalking)
+    {
+        MoveComp->SetMovementMode(MOVE_Walking);
+    }
+
+    // Shared poses are evaluated once by the sharing manager, and a running budget allocator owns the mesh tick rate.
+    // Only fall back to fixed per-tier intervals when neither is active.
+    USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+    IAnimationBudgetAllocator* BudgetAllocator = IAnimationBudgetAllocator::Get(GetWorld());
+    if (BudgetedMesh && BudgetAllocator && BudgetAllocator->GetEnabled())
+    {
+        BudgetAllocator->SetComponentSignificance(BudgetedMesh, Settings.AnimationSignificance);
+    }
+    else if (!bUsesAnimationSharing)
+    {
+        GetMesh()->SetComponentTickInterval(Settings.AnimationTickInterval);
+        GetMesh()->VisibilityBasedAnimTickOption = Settings.AnimationTickOption;
+    }
+}
+
+void AEnemyCharacter::DeactivateToPool()
+{
+    bIsPooled = true;
+    bHasPerceivedTarget = false;
+    LastAttackTime = -1.0;
+    PatrolAreaRadius = -1.0f;
+    ReleaseAttackToken();
+
+    if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+    {
+        Significance->UnregisterEnemy(this);
+    }
+
+    // Parked at the crowd manager, so splash damage there must not reach it; ActivateFromPool registers it again
+    if (UDamageableSpatialSubsystem* DamageableIndex = GetWorld()->GetSubsystem<UDamageableSpatialSubsystem>())
+    {
+        DamageableIndex->UnregisterDamageable(HealthComponent);
+    }
+
+    if (UWetnessSubsystem* Wetness = GetWorld()->GetSubsystem<UWetnessSubsystem>())
+    {
+        Wetness->ClearCharacter(this);
+    }
+
+    if (AAIController* AICon = Cast<AAIController>(GetController()))
+    {
+        if (UBrainComponent* Brain = AICon->GetBrainComponent())
+        {
+            Brain->StopLogic(TEXT("Pooled"));
+        }
+        if (UBlackboardComponent* BBComp = AICon->GetBlackboardComponent())
+        {
+            BBComp->ClearValue(TEXT("TargetActor"));
+            BBComp->ClearValue(TEXT("PatrolLocation"));
+            BBComp->ClearValue(TEXT("InvestigateLocation"));
+        }
+        AICon->ClearFocus(EAIFocusPriority::Gameplay);
+        AICon->StopMovement();
+    }
+
+    if (AIPerceptionComponent)
+    {
+        AIPerceptionComponent->SetSenseEnabled(UAISense_Sight::StaticClass(), false);
+    }
+
+    GetCharacterMovement()->StopMovementImmediately();
+    GetCharacterMovement()->DisableMovement();
+    GetCharacterMovement()->SetComponentTickEnabled(false);
+    GetMesh()->SetComponentTickEnabled(false);
+    UnregisterAnimationSharing();
+
+    SetActorHiddenInGame(true);
+    SetActorEnableCollision(false);
+    SetActorTickEnabled(false);
+
+    if (CurrentWeapon)
+    {
+        CurrentWeapon->SetActorHiddenInGame(true);
+    }
+
+    UObjectChurnSubsystem::ClusterPooledActor(this);
+}
+
+void AEnemyCharacter::ReviveToPool()
+{
+    if (bIsDead)
+    {
+        bIsDead = false;
+
+        // Cancels the destruction scheduled by OnDeath
+        SetLifeSpan(0.0f);
+
+        GetMesh()->SetSimulatePhysics(false);
+        GetMesh()->SetCollisionProfileName(MeshCollisionProfileName);
+        GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+        GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+        GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    }
+
+    if (!bIsPooled)
     {
-        CurrentWeapon->Fire();
+        DeactivateToPool();
     }
 }
+
+void AEnemyCharacter::ActivateFromPool(const FTransform& SpawnTransform, float InitialHealth)
+{
+    UObjectChurnSubsystem::UnclusterPooledActor(this);
+    bIsPooled = false;
+
+    SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(true);
+    SetActorTickEnabled(true);
+
+    if (CurrentWeapon)
+    {
+        CurrentWeapon->SetActorHiddenInGame(false);
+    }
+
+    if (HealthComponent)
+    {
+        HealthComponent->SetHealth(InitialHealth);
+    }
+
+    GetCharacterMovement()->SetComponentTickEnabled(true);
+    GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+    GetMesh()->SetComponentTickEnabled(true);
+
+    if (AIPerceptionComponent)
+    {
+        AIPerceptionComponent->SetSenseEnabled(UAISense_Sight::StaticClass(), true);
+    }
+
+    if (AAIController* AICon = Cast<AAIController>(GetController()))
+    {
+        if (UBrainComponent* Brain = AICon->GetBrainComponent())
+        {
+            Brain->RestartLogic();
+        }
+    }
+
+    if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>())
+    {
+        Significance->RegisterEnemy(this);
+    }
+
+    if (UDamageableSpatialSubsystem* DamageableIndex = GetWorld()->GetSubsystem<UDamageableSpatialSubsystem>())
+    {
+        DamageableIndex->RegisterDamageable(HealthComponent);
+    }
+
+    RegisterAnimationSharing();
+}
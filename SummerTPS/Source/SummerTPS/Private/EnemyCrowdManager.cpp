@@ -0,0 +1,423 @@
+#include "EnemyCrowdManager.h"
+#include "SummerTPS.h"
+#include "EnemyCharacter.h"
+#include "HealthComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "NavigationSystem.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Crowd Tick"), STAT_EnemyCrowd_Tick, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Enemy Crowd Move Kernel"), STAT_EnemyCrowd_Move, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Crowd Proxies"), STAT_EnemyCrowd_NumProxies, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Crowd Promoted"), STAT_EnemyCrowd_NumPromoted, STATGROUP_SummerTPS);
+
+namespace EnemyCrowd
+{
+	static const FTransform HiddenInstanceTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+}
+
+AEnemyCrowdManager::AEnemyCrowdManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	ProxyInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("ProxyInstances"));
+	RootComponent = ProxyInstances;
+	ProxyInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	ProxyInstances->SetCanEverAffectNavigation(false);
+	ProxyInstances->NumCustomDataFloats = 1;
+
+	MaxProxies = 256;
+	ActorPoolSize = 24;
+	EngagementRange = 2500.0f;
+	DemotionRange = 3500.0f;
+	ProxyWalkSpeed = 250.0f;
+	PatrolRadius = 1000.0f;
+	IdleTimeRange = FVector2D(2.0f, 5.0f);
+	MaxNavQueriesPerFrame = 8;
+	ProxyMeshZOffset = 0.0f;
+
+	NextGoalQueryIndex = 0;
+	NumLiveProxies = 0;
+	NumPromoted = 0;
+}
+
+void AEnemyCrowdManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const int32 Capacity = Align(MaxProxies, 4);
+
+	PosX.SetNumZeroed(Capacity);
+	PosY.SetNumZeroed(Capacity);
+	PosZ.SetNumZeroed(Capacity);
+	GoalX.SetNumZeroed(Capacity);
+	GoalY.SetNumZeroed(Capacity);
+	GoalZ.SetNumZeroed(Capacity);
+	VelX.SetNumZeroed(Capacity);
+	VelY.SetNumZeroed(Capacity);
+	Speed.SetNumZeroed(Capacity);
+	DistSqToPlayer.SetNumZeroed(Capacity);
+	Health.SetNumZeroed(Capacity);
+	IdleTimeLeft.SetNumZeroed(Capacity);
+	PatrolOrigin.SetNumZeroed(Capacity);
+	State.Init(EEnemyCrowdProxyState::Free, Capacity);
+	PromotedActors.SetNum(Capacity);
+
+	// Padding slots past MaxProxies stay Free forever, they only exist so the kernel can run on whole vectors
+	FreeSlots.Reserve(MaxProxies);
+	for (int32 Index = MaxProxies - 1; Index >= 0; --Index)
+	{
+		FreeSlots.Add(Index);
+	}
+
+	InstanceTransforms.Init(EnemyCrowd::HiddenInstanceTransform, Capacity);
+	ProxyInstances->ClearInstances();
+	ProxyInstances->AddInstances(InstanceTransforms, false, true);
+
+	if (EnemyClass)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = this;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		for (int32 Count = 0; Count < ActorPoolSize; ++Count)
+		{
+			if (AEnemyCharacter* Enemy = GetWorld()->SpawnActor<AEnemyCharacter>(EnemyClass, GetActorLocation(), FRotator::ZeroRotator, SpawnParams))
+			{
+				Enemy->DeactivateToPool();
+				InactiveActors.Add(Enemy);
+			}
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("EnemyClass not set in %s, proxies will never be promoted."), *GetName());
+	}
+}
+
+int32 AEnemyCrowdManager::AddProxy(const FVector& Location, float InitialHealth)
+{
+	if (FreeSlots.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	if (InitialHealth < 0.0f)
+	{
+		const AEnemyCharacter* EnemyCDO = EnemyClass ? EnemyClass->GetDefaultObject<AEnemyCharacter>() : nullptr;
+		InitialHealth = (EnemyCDO && EnemyCDO->GetHealthComponent()) ? EnemyCDO->GetHealthComponent()->GetDefaultHealth() : 100.0f;
+	}
+
+	const int32 Index = FreeSlots.Pop();
+	PosX[Index] = GoalX[Index] = Location.X;
+	PosY[Index] = GoalY[Index] = Location.Y;
+	PosZ[Index] = GoalZ[Index] = Location.Z;
+	VelX[Index] = VelY[Index] = 0.0f;
+	Speed[Index] = 0.0f;
+	Health[Index] = InitialHealth;
+	PatrolOrigin[Index] = Location;
+	State[Index] = EEnemyCrowdProxyState::Idle;
+	IdleTimeLeft[Index] = FMath::FRandRange(IdleTimeRange.X, IdleTimeRange.Y);
+
+	NumLiveProxies++;
+	return Index;
+}
+
+void AEnemyCrowdManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyCrowd_Tick);
+
+	Super::Tick(DeltaTime);
+
+	if (NumLiveProxies == 0)
+	{
+		return;
+	}
+
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	const FVector PlayerLocation = PlayerPawn ? PlayerPawn->GetActorLocation() : FVector(UE_BIG_NUMBER);
+
+	MoveProxies(DeltaTime, PlayerLocation);
+	UpdatePatrolStates(DeltaTime);
+	UpdatePromotions(PlayerLocation);
+	UpdateInstanceTransforms();
+
+	SET_DWORD_STAT(STAT_EnemyCrowd_NumProxies, NumLiveProxies);
+	SET_DWORD_STAT(STAT_EnemyCrowd_NumPromoted, NumPromoted);
+}
+
+void AEnemyCrowdManager::MoveProxies(float DeltaTime, const FVector& PlayerLocation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyCrowd_Move);
+
+	const VectorRegister4Float Dt = VectorSetFloat1(DeltaTime);
+	const VectorRegister4Float InvDt = VectorSetFloat1(DeltaTime > 0.0f ? 1.0f / DeltaTime : 0.0f);
+	const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+	const VectorRegister4Float MinDistSq = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+	const VectorRegister4Float PlayerX = VectorSetFloat1((float)PlayerLocation.X);
+	const VectorRegister4Float PlayerY = VectorSetFloat1((float)PlayerLocation.Y);
+	const VectorRegister4Float PlayerZ = VectorSetFloat1((float)PlayerLocation.Z);
+
+	// Free, idle and promoted proxies have Speed 0, so they run through the same math without moving
+	for (int32 Index = 0; Index < PosX.Num(); Index += 4)
+	{
+		VectorRegister4Float Px = VectorLoad(&PosX[Index]);
+		VectorRegister4Float Py = VectorLoad(&PosY[Index]);
+		VectorRegister4Float Pz = VectorLoad(&PosZ[Index]);
+
+		const VectorRegister4Float Dx = VectorSubtract(VectorLoad(&GoalX[Index]), Px);
+		const VectorRegister4Float Dy = VectorSubtract(VectorLoad(&GoalY[Index]), Py);
+		const VectorRegister4Float Dz = VectorSubtract(VectorLoad(&GoalZ[Index]), Pz);
+
+		const VectorRegister4Float DistSq = VectorMultiplyAdd(Dx, Dx, VectorMultiply(Dy, Dy));
+		const VectorRegister4Float InvDist = VectorReciprocalSqrt(VectorMax(DistSq, MinDistSq));
+
+		// Fraction of the remaining way covered this frame, clamped so proxies stop on their goal
+		const VectorRegister4Float Alpha = VectorMin(VectorMultiply(VectorMultiply(VectorLoad(&Speed[Index]), Dt), InvDist), One);
+		const VectorRegister4Float MoveX = VectorMultiply(Dx, Alpha);
+		const VectorRegister4Float MoveY = VectorMultiply(Dy, Alpha);
+
+		Px = VectorAdd(Px, MoveX);
+		Py = VectorAdd(Py, MoveY);
+		Pz = VectorMultiplyAdd(Dz, Alpha, Pz);
+
+		VectorStore(Px, &PosX[Index]);
+		VectorStore(Py, &PosY[Index]);
+		VectorStore(Pz, &PosZ[Index]);
+		VectorStore(VectorMultiply(MoveX, InvDt), &VelX[Index]);
+		VectorStore(VectorMultiply(MoveY, InvDt), &VelY[Index]);
+
+		const VectorRegister4Float ToPlayerX = VectorSubtract(Px, PlayerX);
+		const VectorRegister4Float ToPlayerY = VectorSubtract(Py, PlayerY);
+		const VectorRegister4Float ToPlayerZ = VectorSubtract(Pz, PlayerZ);
+		const VectorRegister4Float PlayerDistSq = VectorMultiplyAdd(ToPlayerX, ToPlayerX, VectorMultiplyAdd(ToPlayerY, ToPlayerY, VectorMultiply(ToPlayerZ, ToPlayerZ)));
+		VectorStore(PlayerDistSq, &DistSqToPlayer[Index]);
+	}
+}
+
+void AEnemyCrowdManager::UpdatePatrolStates(float DeltaTime)
+{
+	for (int32 Index = 0; Index < State.Num(); ++Index)
+	{
+		if (State[Index] == EEnemyCrowdProxyState::Walking)
+		{
+			if (FMath::Square(GoalX[Index] - PosX[Index]) + FMath::Square(GoalY[Index] - PosY[Index]) <= 1.0f)
+			{
+				State[Index] = EEnemyCrowdProxyState::Idle;
+				Speed[Index] = 0.0f;
+				IdleTimeLeft[Index] = FMath::FRandRange(IdleTimeRange.X, IdleTimeRange.Y);
+				SetWalkingFlag(Index, false);
+			}
+		}
+		else if (State[Index] == EEnemyCrowdProxyState::Idle)
+		{
+			IdleTimeLeft[Index] -= DeltaTime;
+			if (IdleTimeLeft[Index] <= 0.0f)
+			{
+				State[Index] = EEnemyCrowdProxyState::NeedsGoal;
+			}
+		}
+	}
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	int32 QueriesLeft = MaxNavQueriesPerFrame;
+
+	for (int32 Scanned = 0; Scanned < State.Num() && QueriesLeft > 0; ++Scanned)
+	{
+		const int32 Index = NextGoalQueryIndex;
+		NextGoalQueryIndex = (NextGoalQueryIndex + 1) % State.Num();
+
+		if (State[Index] != EEnemyCrowdProxyState::NeedsGoal)
+		{
+			continue;
+		}
+
+		--QueriesLeft;
+
+		// Goals are reachable navmesh points around the patrol origin. The straight walk between them can still cut across
+		// obstacles or off a concave navmesh edge, which is fine for an instance; PromoteProxy puts the actor back on the navmesh
+		FNavLocation Goal;
+		if (NavSys && NavSys->GetRandomReachablePointInRadius(PatrolOrigin[Index], PatrolRadius, Goal))
+		{
+			GoalX[Index] = Goal.Location.X;
+			GoalY[Index] = Goal.Location.Y;
+			GoalZ[Index] = Goal.Location.Z;
+			Speed[Index] = ProxyWalkSpeed;
+			State[Index] = EEnemyCrowdProxyState::Walking;
+			SetWalkingFlag(Index, true);
+		}
+		else
+		{
+			State[Index] = EEnemyCrowdProxyState::Idle;
+			IdleTimeLeft[Index] = FMath::FRandRange(IdleTimeRange.X, IdleTimeRange.Y);
+		}
+	}
+}
+
+void AEnemyCrowdManager::UpdatePromotions(const FVector& PlayerLocation)
+{
+	const float EngagementRangeSq = FMath::Square(EngagementRange);
+	const float DemotionRangeSq = FMath::Square(FMath::Max(DemotionRange, EngagementRange));
+
+	for (int32 Index = 0; Index < State.Num(); ++Index)
+	{
+		if (State[Index] == EEnemyCrowdProxyState::Free)
+		{
+			continue;
+		}
+
+		if (State[Index] == EEnemyCrowdProxyState::Promoted)
+		{
+			AEnemyCharacter* Enemy = PromotedActors[Index].Get();
+			if (!Enemy || Enemy->IsDead())
+			{
+				// Died as a full actor, the actor runs its own death and lifespan
+				FreeProxy(Index);
+			}
+			else if (FVector::DistSquared(Enemy->GetActorLocation(), PlayerLocation) > DemotionRangeSq)
+			{
+				DemoteProxy(Index);
+			}
+		}
+		else if (DistSqToPlayer[Index] < EngagementRangeSq)
+		{
+			PromoteProxy(Index);
+		}
+	}
+}
+
+void AEnemyCrowdManager::PromoteProxy(int32 Index)
+{
+	AEnemyCharacter* Enemy = AcquireActor();
+	if (!Enemy)
+	{
+		// Pool exhausted, stay a proxy and retry next frame
+		return;
+	}
+
+	const FVector Velocity(VelX[Index], VelY[Index], 0.0f);
+	const FRotator Rotation = Velocity.IsNearlyZero() ? FRotator::ZeroRotator : Velocity.Rotation();
+	const float HalfHeight = Enemy->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	// The proxy may stand inside an obstacle or off the navmesh after a straight walk; without navmesh nearby it falls back to
+	// its goal, a navmesh point or the spot it spawned or was demoted at
+	FVector FootLocation(PosX[Index], PosY[Index], PosZ[Index]);
+	FNavLocation Projected;
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSys && NavSys->ProjectPointToNavigation(FootLocation, Projected))
+	{
+		FootLocation = Projected.Location;
+	}
+	else
+	{
+		FootLocation = FVector(GoalX[Index], GoalY[Index], GoalZ[Index]);
+	}
+
+	FVector SpawnLocation = FootLocation + FVector(0.0f, 0.0f, HalfHeight);
+	Enemy->ActivateFromPool(FTransform(Rotation, SpawnLocation), Health[Index]);
+
+	// Only encroachment checks with collision on, which ActivateFromPool just restored; nudge out of other enemies and props
+	if (GetWorld()->FindTeleportSpot(Enemy, SpawnLocation, Rotation) && !SpawnLocation.Equals(Enemy->GetActorLocation()))
+	{
+		Enemy->SetActorLocation(SpawnLocation, false, nullptr, ETeleportType::ResetPhysics);
+	}
+
+	State[Index] = EEnemyCrowdProxyState::Promoted;
+	Speed[Index] = 0.0f;
+	PromotedActors[Index] = Enemy;
+	InstanceTransforms[Index] = EnemyCrowd::HiddenInstanceTransform;
+	NumPromoted++;
+}
+
+void AEnemyCrowdManager::DemoteProxy(int32 Index)
+{
+	AEnemyCharacter* Enemy = PromotedActors[Index].Get();
+	check(Enemy);
+
+	const FVector FootLocation = Enemy->GetActorLocation() - FVector(0.0f, 0.0f, Enemy->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+	PosX[Index] = GoalX[Index] = FootLocation.X;
+	PosY[Index] = GoalY[Index] = FootLocation.Y;
+	PosZ[Index] = GoalZ[Index] = FootLocation.Z;
+	Health[Index] = Enemy->GetHealthComponent() ? Enemy->GetHealthComponent()->GetHealth() : Health[Index];
+
+	ReleaseActor(Enemy);
+	PromotedActors[Index].Reset();
+	NumPromoted--;
+
+	State[Index] = EEnemyCrowdProxyState::Idle;
+	IdleTimeLeft[Index] = FMath::FRandRange(IdleTimeRange.X, IdleTimeRange.Y);
+	SetWalkingFlag(Index, false);
+}
+
+void AEnemyCrowdManager::FreeProxy(int32 Index)
+{
+	if (State[Index] == EEnemyCrowdProxyState::Promoted)
+	{
+		PromotedActors[Index].Reset();
+		NumPromoted--;
+	}
+
+	State[Index] = EEnemyCrowdProxyState::Free;
+	Speed[Index] = 0.0f;
+	InstanceTransforms[Index] = EnemyCrowd::HiddenInstanceTransform;
+	FreeSlots.Add(Index);
+	NumLiveProxies--;
+}
+
+void AEnemyCrowdManager::SetWalkingFlag(int32 Index, bool bWalking)
+{
+	ProxyInstances->SetCustomDataValue(Index, 0, bWalking ? 1.0f : 0.0f, false);
+}
+
+void AEnemyCrowdManager::UpdateInstanceTransforms()
+{
+	for (int32 Index = 0; Index < State.Num(); ++Index)
+	{
+		const EEnemyCrowdProxyState ProxyState = State[Index];
+		if (ProxyState == EEnemyCrowdProxyState::Free || ProxyState == EEnemyCrowdProxyState::Promoted)
+		{
+			continue;
+		}
+
+		FTransform& InstanceTransform = InstanceTransforms[Index];
+		InstanceTransform.SetLocation(FVector(PosX[Index], PosY[Index], PosZ[Index] + ProxyMeshZOffset));
+		InstanceTransform.SetScale3D(FVector::OneVector);
+		if (ProxyState == EEnemyCrowdProxyState::Walking)
+		{
+			InstanceTransform.SetRotation(FRotator(0.0f, FMath::RadiansToDegrees(FMath::Atan2(VelY[Index], VelX[Index])), 0.0f).Quaternion());
+		}
+	}
+
+	ProxyInstances->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, false);
+}
+
+AEnemyCharacter* AEnemyCrowdManager::AcquireActor()
+{
+	// Anything that was killed or destroyed while parked can't be reactivated
+	while (InactiveActors.Num() > 0)
+	{
+		AEnemyCharacter* Enemy = InactiveActors.Pop(false);
+		if (IsValid(Enemy) && !Enemy->IsDead())
+		{
+			return Enemy;
+		}
+	}
+
+	// Actors that died while promoted are gone, replace them up to the pool size
+	if (!EnemyClass || InactiveActors.Num() + NumPromoted >= ActorPoolSize)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AEnemyCharacter>(EnemyClass, GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
+}
+
+void AEnemyCrowdManager::ReleaseActor(AEnemyCharacter* Enemy)
+{
+	Enemy->DeactivateToPool();
+	InactiveActors.Add(Enemy);
+}
@@ -0,0 +1,304 @@
+#include "EnemyDecisionSubsystem.h"
+#include "SummerTPS.h"
+#include "EnemyCharacter.h"
+#include "HealthComponent.h"
+#include "ActorRegistrySubsystem.h"
+#include "AIController.h"
+#include "AISystem.h"
+#include "NavigationSystem.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISense_Sight.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Decisions Gather"), STAT_EnemyDecision_Gather, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Enemy Decisions Decide"), STAT_EnemyDecision_Decide, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Enemy Decisions Commit"), STAT_EnemyDecision_Commit, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Decisions"), STAT_EnemyDecision_Enemies, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Target Switches"), STAT_EnemyDecision_TargetSwitches, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Patrol Points Picked"), STAT_EnemyDecision_PatrolPoints, STATGROUP_SummerTPS);
+
+namespace EnemyDecision
+{
+	static bool Enabled = true;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("summer.AI.ParallelDecisions"),
+		Enabled,
+		TEXT("Run enemy target selection, attack readiness and patrol point choice as one batched phase on worker threads.\n")
+		TEXT("When off, perception writes TargetActor directly and the behavior tree picks patrol points itself."));
+
+	static bool ForceSingleThread = false;
+	static FAutoConsoleVariableRef CVarForceSingleThread(
+		TEXT("summer.AI.ParallelDecisions.SingleThread"),
+		ForceSingleThread,
+		TEXT("Run the decide step on the game thread, to compare against the parallel version."));
+}
+
+UEnemyDecisionSubsystem::UEnemyDecisionSubsystem()
+{
+	MaxTargetDistance = 3000.0f;
+	FacingWeight = 0.25f;
+	TargetSwitchBias = 0.2f;
+	AttackRange = 800.0f;
+	AttackRangeHysteresis = 150.0f;
+	AttackCooldown = 0.5f;
+	PatrolAcceptanceRadius = 150.0f;
+	MinBatchSize = 16;
+
+	TargetActorKeyName = TEXT("TargetActor");
+	AttackReadyKeyName = TEXT("AttackReady");
+	PatrolLocationKeyName = TEXT("PatrolLocation");
+
+	FrameCounter = 0;
+}
+
+bool UEnemyDecisionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UEnemyDecisionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyDecisionSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyDecisionSubsystem::IsEnabled()
+{
+	return EnemyDecision::Enabled;
+}
+
+void UEnemyDecisionSubsystem::Tick(float DeltaTime)
+{
+	if (!EnemyDecision::Enabled)
+	{
+		return;
+	}
+
+	FrameCounter++;
+	Gather(GetWorld()->GetTimeSeconds());
+
+	const int32 NumEnemies = Enemies.Num();
+	if (NumEnemies == 0)
+	{
+		return;
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_EnemyDecision_Decide);
+
+		Decisions.SetNum(NumEnemies, false);
+		const EParallelForFlags Flags = (EnemyDecision::ForceSingleThread || NumEnemies < MinBatchSize) ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+		ParallelFor(TEXT("EnemyDecisions"), NumEnemies, MinBatchSize, [this](int32 Index) { Decide(Index); }, Flags);
+	}
+
+	Commit();
+	INC_DWORD_STAT_BY(STAT_EnemyDecision_Enemies, NumEnemies);
+}
+
+int32 UEnemyDecisionSubsystem::FindOrAddTarget(AActor* Actor)
+{
+	if (const int32* Existing = TargetIndices.Find(Actor))
+	{
+		return *Existing;
+	}
+
+	FTargetSnapshot& Target = Targets.AddDefaulted_GetRef();
+	Target.Actor = Actor;
+	Target.Location = Actor->GetActorLocation();
+
+	const UHealthComponent* Health = Actor->FindComponentByClass<UHealthComponent>();
+	Target.bAlive = !Health || !Health->IsDead();
+
+	return TargetIndices.Add(Actor, Targets.Num() - 1);
+}
+
+void UEnemyDecisionSubsystem::Gather(double Now)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyDecision_Gather);
+
+	Enemies.Reset();
+	Locations.Reset();
+	Forwards.Reset();
+	PatrolOrigins.Reset();
+	PatrolRadii.Reset();
+	TimesSinceAttack.Reset();
+	CurrentTargets.Reset();
+	WasAttackReady.Reset();
+	HasPatrolPoint.Reset();
+	PatrolPoints.Reset();
+	RandomSeeds.Reset();
+	CandidateStarts.Reset();
+	CandidateIndices.Reset();
+	Targets.Reset();
+	TargetIndices.Reset();
+
+	UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	if (!Registry)
+	{
+		return;
+	}
+
+	Registry->ForEachActor<AEnemyCharacter>([this, Now](AEnemyCharacter* Enemy)
+	{
+		if (Enemy->IsDead() || Enemy->IsPooled())
+		{
+			return;
+		}
+
+		const AAIController* AICon = Cast<AAIController>(Enemy->GetController());
+		const UBlackboardComponent* BBComp = AICon ? AICon->GetBlackboardComponent() : nullptr;
+		if (!BBComp)
+		{
+			return;
+		}
+
+		Enemies.Add(Enemy);
+		Locations.Add(Enemy->GetActorLocation());
+		Forwards.Add(Enemy->GetActorForwardVector());
+		PatrolOrigins.Add(Enemy->GetPatrolOrigin());
+		PatrolRadii.Add(Enemy->HasPatrolArea() ? Enemy->GetPatrolAreaRadius() : -1.0f);
+		TimesSinceAttack.Add(Enemy->GetLastAttackTime() < 0.0 ? TNumericLimits<float>::Max() : (float)(Now - Enemy->GetLastAttackTime()));
+		WasAttackReady.Add(BBComp->GetValueAsBool(AttackReadyKeyName));
+		RandomSeeds.Add(GetTypeHash(Enemy->GetUniqueID()) ^ (FrameCounter * 2654435761u));
+
+		const FVector PatrolPoint = BBComp->GetValueAsVector(PatrolLocationKeyName);
+		HasPatrolPoint.Add(FAISystem::IsValidLocation(PatrolPoint));
+		PatrolPoints.Add(PatrolPoint);
+
+		AActor* CurrentTarget = Cast<AActor>(BBComp->GetValueAsObject(TargetActorKeyName));
+		CurrentTargets.Add(CurrentTarget ? FindOrAddTarget(CurrentTarget) : INDEX_NONE);
+
+		CandidateStarts.Add(CandidateIndices.Num());
+		if (UAIPerceptionComponent* Perception = Enemy->GetAIPerceptionComponent())
+		{
+			PerceivedActors.Reset();
+			Perception->GetCurrentlyPerceivedActors(UAISense_Sight::StaticClass(), PerceivedActors);
+			for (AActor* Perceived : PerceivedActors)
+			{
+				if (Perceived)
+				{
+					CandidateIndices.Add(FindOrAddTarget(Perceived));
+				}
+			}
+		}
+	});
+
+	CandidateStarts.Add(CandidateIndices.Num());
+}
+
+void UEnemyDecisionSubsystem::Decide(int32 Index)
+{
+	// Runs on a worker: snapshots in, Decisions[Index] out, nothing else is touched
+	FEnemyDecision& Decision = Decisions[Index];
+	Decision = FEnemyDecision();
+
+	const FVector& Location = Locations[Index];
+	float BestScore = 0.0f;
+
+	for (int32 Candidate = CandidateStarts[Index]; Candidate < CandidateStarts[Index + 1]; ++Candidate)
+	{
+		const int32 TargetIndex = CandidateIndices[Candidate];
+		const FTargetSnapshot& Target = Targets[TargetIndex];
+		if (!Target.bAlive)
+		{
+			continue;
+		}
+
+		const FVector ToTarget = Target.Location - Location;
+		const float Distance = ToTarget.Size();
+		if (Distance > MaxTargetDistance)
+		{
+			continue;
+		}
+
+		// Always above zero in range, so any live candidate beats having none
+		float Score = 1.0f - Distance / MaxTargetDistance + KINDA_SMALL_NUMBER;
+		Score += FacingWeight * FMath::Max(Forwards[Index] | ToTarget.GetSafeNormal(), 0.0f);
+		if (TargetIndex == CurrentTargets[Index])
+		{
+			Score += TargetSwitchBias;
+		}
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			Decision.Target = TargetIndex;
+		}
+	}
+
+	if (Decision.Target != INDEX_NONE)
+	{
+		const float Range = WasAttackReady[Index] ? AttackRange + AttackRangeHysteresis : AttackRange;
+		Decision.bAttackReady = FVector::DistSquared(Location, Targets[Decision.Target].Location) <= FMath::Square(Range)
+			&& TimesSinceAttack[Index] >= AttackCooldown;
+		return;
+	}
+
+	// Patrol areas come from the tree's Find Patrol Point task, which hasn't run yet for this enemy
+	if (PatrolRadii[Index] < 0.0f)
+	{
+		return;
+	}
+
+	if (HasPatrolPoint[Index] && FVector::DistSquared2D(Location, PatrolPoints[Index]) > FMath::Square(PatrolAcceptanceRadius))
+	{
+		return;
+	}
+
+	// A stream per enemy and frame keeps the choice independent of which worker runs it
+	FRandomStream Random(RandomSeeds[Index]);
+	const float Angle = Random.FRandRange(0.0f, 2.0f * PI);
+	const float Radius = PatrolRadii[Index] * FMath::Sqrt(Random.FRandRange(0.1f, 1.0f));
+	Decision.bNewPatrolPoint = true;
+	Decision.PatrolPoint = PatrolOrigins[Index] + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.0f);
+}
+
+void UEnemyDecisionSubsystem::Commit()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyDecision_Commit);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+	for (int32 Index = 0; Index < Enemies.Num(); ++Index)
+	{
+		// Gameplay code between gather and commit can't run, but stay safe against an enemy destroyed by a BT task
+		AEnemyCharacter* Enemy = Enemies[Index];
+		AAIController* AICon = IsValid(Enemy) ? Cast<AAIController>(Enemy->GetController()) : nullptr;
+		UBlackboardComponent* BBComp = AICon ? AICon->GetBlackboardComponent() : nullptr;
+		if (!BBComp)
+		{
+			continue;
+		}
+
+		const FEnemyDecision& Decision = Decisions[Index];
+		if (Decision.Target != CurrentTargets[Index])
+		{
+			// Focus stays with the behavior tree (the attack task), like when perception wrote the key directly
+			if (Decision.Target != INDEX_NONE)
+			{
+				BBComp->SetValueAsObject(TargetActorKeyName, Targets[Decision.Target].Actor);
+			}
+			else
+			{
+				BBComp->ClearValue(TargetActorKeyName);
+			}
+			INC_DWORD_STAT(STAT_EnemyDecision_TargetSwitches);
+		}
+
+		if (Decision.bAttackReady != (WasAttackReady[Index] != 0))
+		{
+			BBComp->SetValueAsBool(AttackReadyKeyName, Decision.bAttackReady);
+		}
+
+		if (Decision.bNewPatrolPoint)
+		{
+			// Navmesh queries stay on the game thread; an unprojectable point is retried with a new one next frame
+			FNavLocation Projected;
+			if (NavSys && NavSys->ProjectPointToNavigation(Decision.PatrolPoint, Projected))
+			{
+				BBComp->SetValueAsVector(PatrolLocationKeyName, Projected.Location);
+				INC_DWORD_STAT(STAT_EnemyDecision_PatrolPoints);
+			}
+		}
+	}
+}
@@ -0,0 +1,189 @@
+#include "EnemySignificanceSubsystem.h"
+#include "SummerTPS.h"
+#include "EnemyCharacter.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Significance Tick"), STAT_EnemySignificance_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies LOD Tier 0"), STAT_EnemySignificance_Tier0, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies LOD Tier 1"), STAT_EnemySignificance_Tier1, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies LOD Tier 2"), STAT_EnemySignificance_Tier2, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies LOD Tier 3+"), STAT_EnemySignificance_Tier3Plus, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Agents Avoiding"), STAT_EnemySignificance_CrowdAvoiding, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Agents Obstacle Only"), STAT_EnemySignificance_CrowdObstacleOnly, STATGROUP_SummerTPS);
+
+UEnemySignificanceSubsystem::UEnemySignificanceSubsystem()
+{
+	HysteresisDistance = 300.0f;
+	MinTimeInTier = 0.5f;
+	OffscreenDistanceScale = 2.0f;
+	MaxEvaluationsPerFrame = 32;
+	NextEvaluationIndex = 0;
+}
+
+void UEnemySignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (Tiers.Num() == 0)
+	{
+		// In the player's face: everything at full rate
+		FEnemyLODTierSettings& Near = Tiers.AddDefaulted_GetRef();
+		Near.MaxDistance = 1500.0f;
+
+		// Mid range: light throttling, pose only while rendered
+		FEnemyLODTierSettings& Mid = Tiers.AddDefaulted_GetRef();
+		Mid.MaxDistance = 3500.0f;
+		Mid.BehaviorTreeTickInterval = 0.1f;
+		Mid.MovementTickInterval = 1.0f / 30.0f;
+		Mid.AnimationTickInterval = 1.0f / 30.0f;
+		Mid.AnimationTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+		Mid.AnimationSignificance = 0.6f;
+		Mid.CrowdAvoidance = EEnemyCrowdAvoidance::Medium;
+
+		// Far side of the beach: navmesh walking, coarse updates
+		FEnemyLODTierSettings& Far = Tiers.AddDefaulted_GetRef();
+		Far.MaxDistance = 7000.0f;
+		Far.BehaviorTreeTickInterval = 0.25f;
+		Far.MovementTickInterval = 0.1f;
+		Far.bUseNavWalking = true;
+		Far.AnimationTickInterval = 0.1f;
+		Far.AnimationTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		Far.AnimationSignificance = 0.3f;
+		Far.CrowdAvoidance = EEnemyCrowdAvoidance::Low;
+
+		// Beyond: no sight, minimal updates
+		FEnemyLODTierSettings& Dormant = Tiers.AddDefaulted_GetRef();
+		Dormant.MaxDistance = TNumericLimits<float>::Max();
+		Dormant.BehaviorTreeTickInterval = 0.5f;
+		Dormant.bEnableSight = false;
+		Dormant.MovementTickInterval = 0.25f;
+		Dormant.bUseNavWalking = true;
+		Dormant.AnimationTickInterval = 0.25f;
+		Dormant.AnimationTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		Dormant.AnimationSignificance = 0.1f;
+		Dormant.CrowdAvoidance = EEnemyCrowdAvoidance::Off;
+	}
+}
+
+bool UEnemySignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemyCharacter* Enemy)
+{
+	if (Enemy && !Entries.ContainsByPredicate([Enemy](const FEnemyEntry& Entry) { return Entry.Enemy.Get() == Enemy; }))
+	{
+		FEnemyEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Enemy = Enemy;
+	}
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemyCharacter* Enemy)
+{
+	Entries.RemoveAllSwap([Enemy](const FEnemyEntry& Entry) { return !Entry.Enemy.IsValid() || Entry.Enemy.Get() == Enemy; });
+}
+
+int32 UEnemySignificanceSubsystem::GetEnemyTier(const AEnemyCharacter* Enemy) const
+{
+	const FEnemyEntry* Entry = Entries.FindByPredicate([Enemy](const FEnemyEntry& Entry) { return Entry.Enemy.Get() == Enemy; });
+	return Entry ? Entry->Tier : INDEX_NONE;
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemySignificance_Tick);
+
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (!PlayerPawn || Entries.Num() == 0 || Tiers.Num() == 0)
+	{
+		return;
+	}
+
+	const FVector PlayerLocation = PlayerPawn->GetActorLocation();
+	const double Now = GetWorld()->GetTimeSeconds();
+	const int32 NumToEvaluate = MaxEvaluationsPerFrame > 0 ? FMath::Min(MaxEvaluationsPerFrame, Entries.Num()) : Entries.Num();
+
+	for (int32 Count = 0; Count < NumToEvaluate; ++Count)
+	{
+		NextEvaluationIndex = NextEvaluationIndex % Entries.Num();
+		FEnemyEntry& Entry = Entries[NextEvaluationIndex++];
+
+		const AEnemyCharacter* Enemy = Entry.Enemy.Get();
+		if (!Enemy)
+		{
+			continue;
+		}
+
+		if (Entry.Tier != INDEX_NONE && Now - Entry.LastTierChangeTime < MinTimeInTier)
+		{
+			continue;
+		}
+
+		float Distance = FVector::Dist(Enemy->GetActorLocation(), PlayerLocation);
+		if (!Enemy->WasRecentlyRendered(0.25f))
+		{
+			Distance *= OffscreenDistanceScale;
+		}
+
+		const int32 NewTier = ComputeTier(Entry, Distance);
+		if (NewTier != Entry.Tier)
+		{
+			ApplyTier(Entry, NewTier, Now);
+		}
+	}
+
+	int32 TierCounts[4] = { 0, 0, 0, 0 };
+	int32 NumCrowdAvoiding = 0;
+	for (const FEnemyEntry& Entry : Entries)
+	{
+		if (Entry.Tier != INDEX_NONE)
+		{
+			TierCounts[FMath::Min(Entry.Tier, 3)]++;
+			NumCrowdAvoiding += Tiers[Entry.Tier].CrowdAvoidance != EEnemyCrowdAvoidance::Off ? 1 : 0;
+		}
+	}
+	SET_DWORD_STAT(STAT_EnemySignificance_Tier0, TierCounts[0]);
+	SET_DWORD_STAT(STAT_EnemySignificance_Tier1, TierCounts[1]);
+	SET_DWORD_STAT(STAT_EnemySignificance_Tier2, TierCounts[2]);
+	SET_DWORD_STAT(STAT_EnemySignificance_Tier3Plus, TierCounts[3]);
+	SET_DWORD_STAT(STAT_EnemySignificance_CrowdAvoiding, NumCrowdAvoiding);
+	SET_DWORD_STAT(STAT_EnemySignificance_CrowdObstacleOnly, TierCounts[0] + TierCounts[1] + TierCounts[2] + TierCounts[3] - NumCrowdAvoiding);
+}
+
+int32 UEnemySignificanceSubsystem::ComputeTier(const FEnemyEntry& Entry, float Distance) const
+{
+	int32 Candidate = Tiers.Num() - 1;
+	for (int32 Tier = 0; Tier < Tiers.Num() - 1; ++Tier)
+	{
+		if (Distance < Tiers[Tier].MaxDistance)
+		{
+			Candidate = Tier;
+			break;
+		}
+	}
+
+	// Becoming more significant happens right at the border, dropping to a cheaper tier only past border + hysteresis
+	if (Entry.Tier != INDEX_NONE && Candidate > Entry.Tier && Distance < Tiers[Entry.Tier].MaxDistance + HysteresisDistance)
+	{
+		return Entry.Tier;
+	}
+
+	return Candidate;
+}
+
+void UEnemySignificanceSubsystem::ApplyTier(FEnemyEntry& Entry, int32 NewTier, double Now)
+{
+	Entry.Tier = NewTier;
+	Entry.LastTierChangeTime = Now;
+
+	if (AEnemyCharacter* Enemy = Entry.Enemy.Get())
+	{
+		Enemy->ApplyLODSettings(Tiers[NewTier]);
+	}
+}
@@ -1,7 +1,7 @@
 #include "EnemySpawnManager.h"
 #include "EnemySpawner.h"
-#include "Kismet/GameplayStatics.h"
-#include "TimerManager.h"
+#include "ActorRegistrySubsystem.h"
+#include "GameplaySnapshotSubsystem.h"
 
 AEnemySpawnManager::AEnemySpawnManager()
 {
@@ -9,6 +9,7 @@ AEnemySpawnManager::AEnemySpawnManager()
 
     bStartSpawningOnBeginPlay = false;
     SpawnActivationDelay = 0.0f;
+    bSpawnersStarted = false;
 }
 
 void AEnemySpawnManager::BeginPlay()
@@ -21,8 +22,7 @@ void AEnemySpawnManager::BeginPlay()
     {
         if (SpawnActivationDelay > 0.0f)
         {
-            FTimerHandle TimerHandle;
-            GetWorldTimerManager().SetTimer(TimerHandle, this, &AEnemySpawnManager::StartAllSpawners, SpawnActivationDelay, false);
+            UCombatClockSubsystem::SetTimer(this, ActivationTimerHandle, &AEnemySpawnManager::StartAllSpawners, SpawnActivationDelay, false);
         }
         else
         {
@@ -31,28 +31,72 @@ void AEnemySpawnManager::BeginPlay()
     }
 }
 
+void AEnemySpawnManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UCombatClockSubsystem::ClearTimer(this, ActivationTimerHandle);
+
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->OnActorRegistered.Remove(ActorRegisteredHandle);
+        Registry->OnActorUnregistered.Remove(ActorUnregisteredHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void AEnemySpawnManager::FindSpawnersInWorld()
 {
-    TArray<AActor*> FoundActors;
-    UGameplayStatics::GetAllActorsOfClassWithTag(GetWorld(), AEnemySpawner::StaticClass(), SpawnerGroupTag, FoundActors);
+    UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+    if (!Registry)
+    {
+        return;
+    }
 
-    for (AActor* Actor : FoundActors)
+    // Spawners that already began play; the ones after us (or in sublevels streamed in later) arrive through OnActorRegistered
+    Registry->ForEachActorWithTag<AEnemySpawner>(SpawnerGroupTag, [this](AEnemySpawner* Spawner)
     {
-        AEnemySpawner* Spawner = Cast<AEnemySpawner>(Actor);
-        if (Spawner)
-        {
-            ManagedSpawners.Add(Spawner);
-        }
+        ManagedSpawners.AddUnique(Spawner);
+    });
+
+    ActorRegisteredHandle = Registry->OnActorRegistered.AddUObject(this, &AEnemySpawnManager::OnActorRegistered);
+    ActorUnregisteredHandle = Registry->OnActorUnregistered.AddUObject(this, &AEnemySpawnManager::OnActorUnregistered);
+}
+
+void AEnemySpawnManager::OnActorRegistered(AActor* Actor)
+{
+    AEnemySpawner* Spawner = Cast<AEnemySpawner>(Actor);
+    if (!Spawner || !Spawner->ActorHasTag(SpawnerGroupTag) || ManagedSpawners.Contains(Spawner))
+    {
+        return;
     }
 
-    if (ManagedSpawners.Num() == 0)
+    ManagedSpawners.Add(Spawner);
+
+    if (bSpawnersStarted)
     {
-        UE_LOG(LogTemp, Warning, TEXT("EnemySpawnManager '%s' found no spawners with tag '%s'."), *GetName(), *SpawnerGroupTag.ToString());
+        Spawner->bSpawnOnBeginPlay = false;
+        Spawner->StartSpawning();
+    }
+}
+
+void AEnemySpawnManager::OnActorUnregistered(AActor* Actor)
+{
+    // Streamed out or destroyed spawners leave the list before their pointer goes stale
+    if (AEnemySpawner* Spawner = Cast<AEnemySpawner>(Actor))
+    {
+        ManagedSpawners.Remove(Spawner);
     }
 }
 
 void AEnemySpawnManager::StartAllSpawners()
 {
+    bSpawnersStarted = true;
+
+    if (ManagedSpawners.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnemySpawnManager '%s' found no spawners with tag '%s'."), *GetName(), *SpawnerGroupTag.ToString());
+    }
+
     for (AEnemySpawner* Spawner : ManagedSpawners)
     {
         if (Spawner)
@@ -62,4 +106,10 @@ void AEnemySpawnManager::StartAllSpawners()
             Spawner->StartSpawning();
         }
     }
+
+    // 웨이브 시작 시점의 상태를 저장해 두고, 재시도는 맵 리로드 대신 스냅샷 복원으로 처리
+    if (UGameplaySnapshotSubsystem* Snapshot = GetWorld()->GetSubsystem<UGameplaySnapshotSubsystem>())
+    {
+        Snapshot->NotifyWaveStarted();
+    }
 }
@@ -1,8 +1,52 @@
 #include "EnemySpawner.h"
 #include "Components/SphereComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "EnemyCharacter.h"
+#include "EnemyCrowdManager.h"
+#include "ActorRegistrySubsystem.h"
+#include "WorldQuerySchedulerSubsystem.h"
+#include "CombatClockSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+    // Spreads Count enemies over every spawner in the world, e.g. "summer.Bench.SpawnEnemies 200" then "stat anim"
+    void SpawnBenchmarkEnemies(const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 50;
+
+        TArray<AEnemySpawner*> Spawners;
+        if (const UActorRegistrySubsystem* Registry = World->GetSubsystem<UActorRegistrySubsystem>())
+        {
+            Registry->ForEachActor<AEnemySpawner>([&Spawners](AEnemySpawner* Spawner)
+            {
+                if (Spawner->EnemyClass)
+                {
+                    Spawners.Add(Spawner);
+                }
+            });
+        }
+
+        if (Spawners.Num() == 0 || Count <= 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("summer.Bench.SpawnEnemies: no spawner with an EnemyClass in the world"));
+            return;
+        }
+
+        for (int32 Index = 0; Index < Spawners.Num(); ++Index)
+        {
+            const int32 Share = Count / Spawners.Num() + (Index < Count % Spawners.Num() ? 1 : 0);
+            Spawners[Index]->SpawnImmediately(Share);
+        }
+
+        UE_LOG(LogTemp, Log, TEXT("summer.Bench.SpawnEnemies: spawned %d enemies over %d spawners"), Count, Spawners.Num());
+    }
+
+    FAutoConsoleCommandWithWorldAndArgs SpawnBenchmarkEnemiesCommand(
+        TEXT("summer.Bench.SpawnEnemies"),
+        TEXT("Spawns N enemy actors spread over all enemy spawners (default 50), for animation and AI cost measurements."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SpawnBenchmarkEnemies));
+}
 
 AEnemySpawner::AEnemySpawner()
 {
@@ -17,78 +61,189 @@ AEnemySpawner::AEnemySpawner()
     bSpawnOnBeginPlay = true;
     bRandomizeSpawnRotation = true;
     EnemiesSpawnedCount = 0;
+    PendingSpawnCount = 0;
+    SpawnGeneration = 0;
+    GroundTraceMaxLatencyFrames = 4;
+    CrowdManager = nullptr;
 }
 
 void AEnemySpawner::BeginPlay()
 {
     Super::BeginPlay();
 
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->RegisterActor(this);
+    }
+
     if (bSpawnOnBeginPlay)
     {
         StartSpawning();
     }
 }
 
+void AEnemySpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->UnregisterActor(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void AEnemySpawner::StartSpawning()
 {
-    if (!EnemyClass)
+    if (!EnemyClass && !CrowdManager)
     {
         UE_LOG(LogTemp, Warning, TEXT("EnemyClass not set in %s"), *GetName());
         return;
     }
 
     EnemiesSpawnedCount = 0;
-    GetWorldTimerManager().SetTimer(SpawnTimerHandle, this, &AEnemySpawner::SpawnEnemy, SpawnInterval, true, 0.0f);
+    UCombatClockSubsystem::SetTimer(this, SpawnTimerHandle, &AEnemySpawner::SpawnEnemy, SpawnInterval, true, 0.0f);
+}
+
+void AEnemySpawner::SpawnImmediately(int32 Count)
+{
+    if (!EnemyClass || Count <= 0)
+    {
+        return;
+    }
+
+    // Actors only, benchmarks measure per-actor animation cost. Counted apart from the wave so its designed size is untouched
+    for (int32 Attempt = 0; Attempt < Count; ++Attempt)
+    {
+        SpawnAtRandomPoint(false, false);
+    }
+}
+
+FEnemySpawnerState AEnemySpawner::CaptureState() const
+{
+    FEnemySpawnerState State;
+    State.EnemiesSpawnedCount = EnemiesSpawnedCount;
+    State.NumberOfEnemiesToSpawn = NumberOfEnemiesToSpawn;
+
+    State.bSpawning = UCombatClockSubsystem::IsTimerActive(this, SpawnTimerHandle);
+    State.TimeUntilNextSpawn = State.bSpawning ? UCombatClockSubsystem::GetTimerRemaining(this, SpawnTimerHandle) : 0.0f;
+    return State;
+}
+
+void AEnemySpawner::RestoreState(const FEnemySpawnerState& State)
+{
+    SpawnGeneration++;
+    PendingSpawnCount = 0;
+    EnemiesSpawnedCount = State.EnemiesSpawnedCount;
+    NumberOfEnemiesToSpawn = State.NumberOfEnemiesToSpawn;
+
+    UCombatClockSubsystem::ClearTimer(this, SpawnTimerHandle);
+    if (State.bSpawning)
+    {
+        UCombatClockSubsystem::SetTimer(this, SpawnTimerHandle, &AEnemySpawner::SpawnEnemy, SpawnInterval, true, State.TimeUntilNextSpawn);
+    }
 }
 
 void AEnemySpawner::SpawnEnemy()
 {
     if (EnemiesSpawnedCount >= NumberOfEnemiesToSpawn)
     {
-        GetWorldTimerManager().ClearTimer(SpawnTimerHandle);
+        UCombatClockSubsystem::ClearTimer(this, SpawnTimerHandle);
         return;
     }
 
+    // The remaining enemies are already waiting for their ground trace
+    if (EnemiesSpawnedCount + PendingSpawnCount >= NumberOfEnemiesToSpawn)
+    {
+        return;
+    }
+
+    SpawnAtRandomPoint(CrowdManager != nullptr, true);
+}
+
+void AEnemySpawner::SpawnAtRandomPoint(bool bUseCrowdManager, bool bCountTowardWave)
+{
     UWorld* const World = GetWorld();
-    if (World && EnemyClass)
+    if (World && (bUseCrowdManager ? CrowdManager != nullptr : EnemyClass != nullptr))
     {
         FVector SpawnOrigin = SpawnVolume->GetComponentLocation();
         float SpawnRadius = SpawnVolume->GetScaledSphereRadius();
-        FVector RandomPoint = UKismetMathLibrary::RandomPointInBoundingBox(SpawnOrigin, FVector(SpawnRadius));
 
-        FHitResult HitResult;
+        // Drawn from the combat stream, one axis per statement so the draw order is fixed
+        const float OffsetX = (UCombatClockSubsystem::FRand(this) * 2.0f - 1.0f) * SpawnRadius;
+        const float OffsetY = (UCombatClockSubsystem::FRand(this) * 2.0f - 1.0f) * SpawnRadius;
+        const float OffsetZ = (UCombatClockSubsystem::FRand(this) * 2.0f - 1.0f) * SpawnRadius;
+        FVector RandomPoint = SpawnOrigin + FVector(OffsetX, OffsetY, OffsetZ);
+
         FVector StartLocation = FVector(RandomPoint.X, RandomPoint.Y, SpawnOrigin.Z + SpawnRadius); // Start trace from high up
         FVector EndLocation = FVector(RandomPoint.X, RandomPoint.Y, SpawnOrigin.Z - SpawnRadius * 2); // And trace down
 
         FCollisionQueryParams CollisionParams;
         CollisionParams.AddIgnoredActor(this);
 
-        FVector SpawnLocation = RandomPoint; // Default to random point if no ground is found
-
-        if (GetWorld()->LineTraceSingleByChannel(HitResult, StartLocation, EndLocation, ECC_Visibility, CollisionParams))
+        // In fixed step combat the spawn has to land on the step that asked for it, not on a later frame
+        const UCombatClockSubsystem* Clock = UCombatClockSubsystem::Get(this);
+        UWorldQuerySchedulerSubsystem* Queries = World->GetSubsystem<UWorldQuerySchedulerSubsystem>();
+        if (!Queries || (Clock && Clock->IsFixedStep()))
         {
-            if (HitResult.bBlockingHit)
-            {
-                SpawnLocation = HitResult.ImpactPoint;
-            }
+            FHitResult HitResult;
+            const bool bHit = World->LineTraceSingleByChannel(HitResult, StartLocation, EndLocation, ECC_Visibility, CollisionParams);
+            FinishSpawn(bHit ? FVector(HitResult.ImpactPoint) : RandomPoint, bUseCrowdManager, bCountTowardWave);
+            return;
         }
 
-        FActorSpawnParameters SpawnParams;
-        SpawnParams.Owner = this;
-        SpawnParams.Instigator = GetInstigator();
-        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
-        FRotator SpawnRotation = FRotator::ZeroRotator;
-        if (bRandomizeSpawnRotation)
+        // Spawning a few frames later is invisible to the player, so the ground trace rides the async query budget
+        if (bCountTowardWave)
         {
-            SpawnRotation.Yaw = FMath::FRand() * 360.0f;
+            PendingSpawnCount++;
         }
+        Queries->SubmitLineTrace(EWorldQueryCategory::Spawning, StartLocation, EndLocation, ECC_Visibility, CollisionParams, GroundTraceMaxLatencyFrames,
+            [WeakThis = TWeakObjectPtr<AEnemySpawner>(this), Generation = SpawnGeneration, RandomPoint, bUseCrowdManager, bCountTowardWave](const FWorldQueryResult& Result)
+            {
+                AEnemySpawner* Spawner = WeakThis.Get();
+
+                // A snapshot restore since the submission already reset the counters
+                if (Spawner && Spawner->SpawnGeneration == Generation)
+                {
+                    if (bCountTowardWave)
+                    {
+                        Spawner->PendingSpawnCount--;
+                    }
+
+                    // Default to random point if no ground is found
+                    Spawner->FinishSpawn(Result.bBlockingHit ? FVector(Result.Hit.ImpactPoint) : RandomPoint, bUseCrowdManager, bCountTowardWave);
+                }
+            });
+    }
+}
 
-        AEnemyCharacter* SpawnedEnemy = World->SpawnActor<AEnemyCharacter>(EnemyClass, SpawnLocation, SpawnRotation, SpawnParams);
+void AEnemySpawner::FinishSpawn(const FVector& SpawnLocation, bool bUseCrowdManager, bool bCountTowardWave)
+{
+    UWorld* const World = GetWorld();
 
-        if (SpawnedEnemy)
+    if (bUseCrowdManager)
+    {
+        if (CrowdManager && CrowdManager->AddProxy(SpawnLocation) != INDEX_NONE && bCountTowardWave)
         {
             EnemiesSpawnedCount++;
         }
+        return;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Owner = this;
+    SpawnParams.Instigator = GetInstigator();
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+    FRotator SpawnRotation = FRotator::ZeroRotator;
+    if (bRandomizeSpawnRotation)
+    {
+        SpawnRotation.Yaw = UCombatClockSubsystem::FRand(this) * 360.0f;
+    }
+
+    AEnemyCharacter* SpawnedEnemy = World->SpawnActor<AEnemyCharacter>(EnemyClass, SpawnLocation, SpawnRotation, SpawnParams);
+
+    if (SpawnedEnemy && bCountTowardWave)
+    {
+        EnemiesSpawnedCount++;
     }
 }
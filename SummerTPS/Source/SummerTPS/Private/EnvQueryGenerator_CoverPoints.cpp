@@ -0,0 +1,65 @@
+#include "EnvQueryGenerator_CoverPoints.h"
+#include "SummerTPS.h"
+#include "CoverSearchSubsystem.h"
+#include "Algo/Unique.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_Point.h"
+
+#define LOCTEXT_NAMESPACE "EnvQueryGenerator"
+
+DECLARE_CYCLE_STAT(TEXT("EQS Generate Cover Points"), STAT_EnvQueryGenerator_CoverPoints, STATGROUP_SummerTPS);
+
+UEnvQueryGenerator_CoverPoints::UEnvQueryGenerator_CoverPoints()
+{
+	ItemType = UEnvQueryItemType_Point::StaticClass();
+	SearchCenter = UEnvQueryContext_Querier::StaticClass();
+	SearchRadius.DefaultValue = 1500.0f;
+}
+
+void UEnvQueryGenerator_CoverPoints::GenerateItems(FEnvQueryInstance& QueryInstance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnvQueryGenerator_CoverPoints);
+
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	const UCoverSearchSubsystem* CoverSearch = QueryInstance.World ? QueryInstance.World->GetSubsystem<UCoverSearchSubsystem>() : nullptr;
+	if (!QueryOwner || !CoverSearch)
+	{
+		return;
+	}
+
+	SearchRadius.BindData(QueryOwner, QueryInstance.QueryID);
+	const float Radius = SearchRadius.GetValue();
+
+	TArray<FVector> Centers;
+	QueryInstance.PrepareContext(SearchCenter, Centers);
+
+	TArray<int32, FFrameArenaAllocator> Indices;
+	for (const FVector& Center : Centers)
+	{
+		CoverSearch->GatherCoverPoints(Center, Radius, Indices);
+	}
+
+	// Overlapping contexts would generate the same point twice
+	if (Centers.Num() > 1)
+	{
+		Indices.Sort();
+		Indices.SetNum(Algo::Unique(Indices));
+	}
+
+	for (const int32 Index : Indices)
+	{
+		QueryInstance.AddItemData<UEnvQueryItemType_Point>(CoverSearch->GetCoverPoint(Index).Location);
+	}
+}
+
+FText UEnvQueryGenerator_CoverPoints::GetDescriptionTitle() const
+{
+	return FText::Format(LOCTEXT("CoverPointsDescriptionTitle", "Cover Points around {0}"), UEnvQueryTypes::DescribeContext(SearchCenter));
+}
+
+FText UEnvQueryGenerator_CoverPoints::GetDescriptionDetails() const
+{
+	return FText::Format(LOCTEXT("CoverPointsDescriptionDetails", "radius: {0}"), FText::FromString(SearchRadius.ToString()));
+}
+
+#undef LOCTEXT_NAMESPACE
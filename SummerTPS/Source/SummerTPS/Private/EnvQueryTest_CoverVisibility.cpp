@@ -0,0 +1,70 @@
+#include "EnvQueryTest_CoverVisibility.h"
+#include "SummerTPS.h"
+#include "CoverSearchSubsystem.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_VectorBase.h"
+
+#define LOCTEXT_NAMESPACE "EnvQueryGenerator"
+
+DECLARE_CYCLE_STAT(TEXT("EQS Test Cover Visibility"), STAT_EnvQueryTest_CoverVisibility, STATGROUP_SummerTPS);
+
+UEnvQueryTest_CoverVisibility::UEnvQueryTest_CoverVisibility()
+{
+	Cost = EEnvTestCost::Low;
+	ValidItemType = UEnvQueryItemType_VectorBase::StaticClass();
+	SetWorkOnFloatValues(true);
+
+	UnknownScore = 0.5f;
+}
+
+void UEnvQueryTest_CoverVisibility::RunTest(FEnvQueryInstance& QueryInstance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnvQueryTest_CoverVisibility);
+
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	UCoverSearchSubsystem* CoverSearch = QueryInstance.World ? QueryInstance.World->GetSubsystem<UCoverSearchSubsystem>() : nullptr;
+	if (!QueryOwner || !CoverSearch)
+	{
+		return;
+	}
+
+	FloatValueMin.BindData(QueryOwner, QueryInstance.QueryID);
+	const float MinThresholdValue = FloatValueMin.GetValue();
+
+	FloatValueMax.BindData(QueryOwner, QueryInstance.QueryID);
+	const float MaxThresholdValue = FloatValueMax.GetValue();
+
+	for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
+	{
+		float Score = 0.0f;
+
+		const int32 PointIndex = CoverSearch->FindCoverPointAt(GetItemLocation(QueryInstance, It.GetIndex()));
+		if (PointIndex != INDEX_NONE)
+		{
+			switch (CoverSearch->RequestVisibility(PointIndex))
+			{
+			case ECoverVisibility::Hidden:
+				Score = 1.0f;
+				break;
+			case ECoverVisibility::Unknown:
+				Score = UnknownScore;
+				break;
+			default:
+				break;
+			}
+		}
+
+		It.SetScore(TestPurpose, FilterType, Score, MinThresholdValue, MaxThresholdValue);
+	}
+}
+
+FText UEnvQueryTest_CoverVisibility::GetDescriptionTitle() const
+{
+	return LOCTEXT("CoverVisibilityDescriptionTitle", "Cover Visibility: hidden from player");
+}
+
+FText UEnvQueryTest_CoverVisibility::GetDescriptionDetails() const
+{
+	return DescribeFloatTestParams();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,124 @@
+#include "FrameArena.h"
+#include "SummerTPS.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame Arena Allocations"), STAT_FrameArena_Allocations, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame Arena Overflows"), STAT_FrameArena_Overflows, STATGROUP_SummerTPS);
+DECLARE_MEMORY_STAT(TEXT("Frame Arena Peak Last Frame"), STAT_FrameArena_PeakLastFrame, STATGROUP_SummerTPS);
+DECLARE_MEMORY_STAT(TEXT("Frame Arena High Water"), STAT_FrameArena_HighWater, STATGROUP_SummerTPS);
+
+namespace FrameArena
+{
+	static int32 SizeKB = 256;
+	static FAutoConsoleVariableRef CVarSizeKB(
+		TEXT("summer.FrameArena.SizeKB"),
+		SizeKB,
+		TEXT("Size of the per-frame scratch arena in KB. Changes apply at the end of the frame; allocations beyond it fall back to the heap."));
+
+	static FAutoConsoleCommand ReportCommand(
+		TEXT("summer.FrameArena.Report"),
+		TEXT("Prints the frame arena size, its high-water mark and how often it overflowed to the heap."),
+		FConsoleCommandDelegate::CreateLambda([]() { FFrameArena::Get().Report(); }));
+}
+
+FFrameArena& FFrameArena::Get()
+{
+	static FFrameArena Arena;
+	return Arena;
+}
+
+FFrameArena::FFrameArena()
+	: Memory(nullptr)
+	, Capacity(0)
+	, Top(0)
+	, Generation(1)
+	, FramePeak(0)
+	, HighWater(0)
+	, NumOverflows(0)
+	, OverflowBytes(0)
+{
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FFrameArena::Reset);
+}
+
+void* FFrameArena::Allocate(SIZE_T Size, uint32 Alignment)
+{
+	if (!IsInGameThread())
+	{
+		return nullptr;
+	}
+
+	if (!Memory)
+	{
+		Capacity = (SIZE_T)FMath::Max(FrameArena::SizeKB, 1) * 1024;
+		Memory = (uint8*)FMemory::Malloc(Capacity, 16);
+	}
+
+	const SIZE_T Start = Align(Top, (SIZE_T)Alignment);
+	if (Start + Size > Capacity)
+	{
+		return nullptr;
+	}
+
+	Top = Start + Size;
+	FramePeak = FMath::Max(FramePeak, Top);
+
+	INC_DWORD_STAT(STAT_FrameArena_Allocations);
+	return Memory + Start;
+}
+
+bool FFrameArena::TryResizeInPlace(void* Ptr, SIZE_T OldSize, SIZE_T NewSize)
+{
+	const SIZE_T Start = (uint8*)Ptr - Memory;
+	if (!IsInGameThread() || Start + OldSize != Top || Start + NewSize > Capacity)
+	{
+		return false;
+	}
+
+	Top = Start + NewSize;
+	FramePeak = FMath::Max(FramePeak, Top);
+	return true;
+}
+
+void FFrameArena::Free(void* Ptr, SIZE_T Size)
+{
+	const SIZE_T Start = (uint8*)Ptr - Memory;
+	if (IsInGameThread() && Start + Size == Top)
+	{
+		Top = Start;
+	}
+}
+
+void FFrameArena::NoteOverflow(SIZE_T Size)
+{
+	NumOverflows++;
+	OverflowBytes += Size;
+
+	INC_DWORD_STAT(STAT_FrameArena_Overflows);
+}
+
+void FFrameArena::Reset()
+{
+	// Scratch arrays are mostly freed by now, so Top says little; the peak is what the frame actually needed
+	HighWater = FMath::Max(HighWater, FramePeak);
+	SET_MEMORY_STAT(STAT_FrameArena_PeakLastFrame, FramePeak);
+	SET_MEMORY_STAT(STAT_FrameArena_HighWater, HighWater);
+
+	Top = 0;
+	FramePeak = 0;
+	Generation++;
+
+	const SIZE_T WantedCapacity = (SIZE_T)FMath::Max(FrameArena::SizeKB, 1) * 1024;
+	if (Memory && WantedCapacity != Capacity)
+	{
+		FMemory::Free(Memory);
+		Memory = nullptr;
+		Capacity = 0;
+	}
+}
+
+void FFrameArena::Report() const
+{
+	UE_LOG(LogTemp, Log, TEXT("Frame arena: %llu KB, high water %llu KB, %llu overflows (%llu KB) to the heap"),
+		(uint64)Capacity / 1024, (uint64)HighWater / 1024, NumOverflows, (uint64)OverflowBytes / 1024);
+}
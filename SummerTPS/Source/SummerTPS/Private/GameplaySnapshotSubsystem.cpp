@@ -0,0 +1,423 @@
+#include "GameplaySnapshotSubsystem.h"
+#include "SummerTPS.h"
+#include "TPSPlayer.h"
+#include "EnemyCharacter.h"
+#include "EnemyCrowdManager.h"
+#include "HealthComponent.h"
+#include "ActorRegistrySubsystem.h"
+#include "ProjectilePoolSubsystem.h"
+#include "WetnessSubsystem.h"
+#include "AIController.h"
+#include "AITypes.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay Snapshot Capture"), STAT_Snapshot_Capture, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Gameplay Snapshot Restore"), STAT_Snapshot_Restore, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Snapshot Enemies Reused"), STAT_Snapshot_EnemiesReused, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Snapshot Enemies Spawned"), STAT_Snapshot_EnemiesSpawned, STATGROUP_SummerTPS);
+
+namespace GameplaySnapshot
+{
+	static void ForEachSnapshotSubsystem(UWorld* World, TFunctionRef<void(UGameplaySnapshotSubsystem&)> Func)
+	{
+		if (UGameplaySnapshotSubsystem* Subsystem = World ? World->GetSubsystem<UGameplaySnapshotSubsystem>() : nullptr)
+		{
+			Func(*Subsystem);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CaptureCommand(
+		TEXT("summer.Snapshot.Capture"),
+		TEXT("Captures the current gameplay state (player, spawners, enemies) for summer.Snapshot.Restore."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			ForEachSnapshotSubsystem(World, [](UGameplaySnapshotSubsystem& Subsystem) { Subsystem.CaptureSnapshot(); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs RestoreCommand(
+		TEXT("summer.Snapshot.Restore"),
+		TEXT("Restores the last gameplay snapshot in place, without reloading the map."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			ForEachSnapshotSubsystem(World, [](UGameplaySnapshotSubsystem& Subsystem) { Subsystem.RestoreSnapshot(); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("summer.Bench.SnapshotRestore"),
+		TEXT("Restores the last gameplay snapshot N times in a row (default 20) and logs the mean and worst restore time."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20;
+			ForEachSnapshotSubsystem(World, [Iterations](UGameplaySnapshotSubsystem& Subsystem) { Subsystem.RunRestoreBenchmark(Iterations); });
+		}));
+}
+
+UGameplaySnapshotSubsystem::UGameplaySnapshotSubsystem()
+{
+	bCaptureOnWaveStart = true;
+	bHasSnapshot = false;
+}
+
+void UGameplaySnapshotSubsystem::Deinitialize()
+{
+	Snapshot = FGameplaySnapshot();
+	bHasSnapshot = false;
+
+	Super::Deinitialize();
+}
+
+bool UGameplaySnapshotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UGameplaySnapshotSubsystem::IsCrowdEnemy(const AEnemyCharacter* Enemy)
+{
+	return Cast<AEnemyCrowdManager>(Enemy->GetOwner()) != nullptr;
+}
+
+void UGameplaySnapshotSubsystem::NotifyWaveStarted()
+{
+	if (bCaptureOnWaveStart)
+	{
+		CaptureSnapshot();
+	}
+}
+
+void UGameplaySnapshotSubsystem::CaptureSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_Snapshot_Capture);
+
+	UWorld* World = GetWorld();
+	const UActorRegistrySubsystem* Registry = World->GetSubsystem<UActorRegistrySubsystem>();
+	if (!Registry)
+	{
+		return;
+	}
+
+	Snapshot = FGameplaySnapshot();
+	Snapshot.CaptureTime = World->GetTimeSeconds();
+
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+	if (ATPSPlayer* Player = PlayerController ? Cast<ATPSPlayer>(PlayerController->GetPawn()) : nullptr)
+	{
+		Snapshot.Player = Player;
+		Snapshot.PlayerTransform = Player->GetActorTransform();
+		Snapshot.PlayerControlRotation = PlayerController->GetControlRotation();
+		Snapshot.PlayerHealth = Player->GetHealthComponent() ? Player->GetHealthComponent()->GetHealth() : 0.0f;
+		Snapshot.PlayerWater = Player->GetWater();
+	}
+
+	Registry->ForEachActor<AEnemySpawner>([this](AEnemySpawner* Spawner)
+	{
+		Snapshot.Spawners.Emplace(Spawner, Spawner->CaptureState());
+	});
+
+	Registry->ForEachActor<AEnemyCharacter>([this](AEnemyCharacter* Enemy)
+	{
+		// Dying enemies are on their way out and pooled ones aren't part of the fight
+		if (Enemy->IsDead() || Enemy->IsPooled() || IsCrowdEnemy(Enemy))
+		{
+			return;
+		}
+
+		FEnemySnapshot& Entry = Snapshot.Enemies.AddDefaulted_GetRef();
+		Entry.Enemy = Enemy;
+		Entry.Class = Enemy->GetClass();
+		Entry.Owner = Enemy->GetOwner();
+		Entry.Transform = Enemy->GetActorTransform();
+		Entry.Health = Enemy->GetHealthComponent() ? Enemy->GetHealthComponent()->GetHealth() : 0.0f;
+
+		const AAIController* AICon = Cast<AAIController>(Enemy->GetController());
+		if (const UBlackboardComponent* Blackboard = AICon ? AICon->GetBlackboardComponent() : nullptr)
+		{
+			CaptureBlackboard(*Blackboard, Entry.Blackboard);
+		}
+	});
+
+	bHasSnapshot = true;
+
+	UE_LOG(LogTemp, Log, TEXT("Gameplay snapshot captured: %d enemies, %d spawners"), Snapshot.Enemies.Num(), Snapshot.Spawners.Num());
+}
+
+bool UGameplaySnapshotSubsystem::RestoreSnapshot()
+{
+	if (!bHasSnapshot)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No gameplay snapshot to restore."));
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_Snapshot_Restore);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Projectiles first, nothing in flight should hit the restored actors
+	if (UProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+	{
+		ProjectilePool->ReleaseAll();
+	}
+
+	for (const TPair<TWeakObjectPtr<AEnemySpawner>, FEnemySpawnerState>& SpawnerEntry : Snapshot.Spawners)
+	{
+		if (AEnemySpawner* Spawner = SpawnerEntry.Key.Get())
+		{
+			Spawner->RestoreState(SpawnerEntry.Value);
+		}
+	}
+
+	RestoreEnemies();
+
+	if (ATPSPlayer* Player = Snapshot.Player.Get())
+	{
+		Player->Revive(Snapshot.PlayerTransform, Snapshot.PlayerControlRotation, Snapshot.PlayerHealth, Snapshot.PlayerWater);
+
+		// Snapshots are taken at wave start and don't carry wetness; enemies are dried when ReviveToPool pools them
+		if (UWetnessSubsystem* Wetness = GetWorld()->GetSubsystem<UWetnessSubsystem>())
+		{
+			Wetness->ClearCharacter(Player);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Gameplay snapshot restored in %.2f ms"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+void UGameplaySnapshotSubsystem::RestoreEnemies()
+{
+	UWorld* World = GetWorld();
+	const UActorRegistrySubsystem* Registry = World->GetSubsystem<UActorRegistrySubsystem>();
+	if (!Registry)
+	{
+		return;
+	}
+
+	// Everything the snapshot may reuse, collected first since spawning below adds to the registry
+	TMap<UClass*, TArray<AEnemyCharacter*>> Available;
+	Registry->ForEachActor<AEnemyCharacter>([&Available](AEnemyCharacter* Enemy)
+	{
+		if (IsValid(Enemy) && !IsCrowdEnemy(Enemy))
+		{
+			Available.FindOrAdd(Enemy->GetClass()).Add(Enemy);
+		}
+	});
+
+	for (TPair<UClass*, TArray<AEnemyCharacter*>>& ClassEntry : Available)
+	{
+		for (AEnemyCharacter* Enemy : ClassEntry.Value)
+		{
+			Enemy->ReviveToPool();
+		}
+	}
+
+	TArray<AEnemyCharacter*> Assigned;
+	Assigned.SetNumZeroed(Snapshot.Enemies.Num());
+
+	// The captured actors take their own entries back, so references to them (e.g. in other blackboards) stay meaningful
+	for (int32 Index = 0; Index < Snapshot.Enemies.Num(); ++Index)
+	{
+		AEnemyCharacter* Enemy = Snapshot.Enemies[Index].Enemy.Get();
+		TArray<AEnemyCharacter*>* Candidates = Enemy ? Available.Find(Enemy->GetClass()) : nullptr;
+		if (Candidates && Candidates->RemoveSwap(Enemy) > 0)
+		{
+			Assigned[Index] = Enemy;
+		}
+	}
+
+	int32 NumReused = 0;
+	int32 NumSpawned = 0;
+
+	for (int32 Index = 0; Index < Snapshot.Enemies.Num(); ++Index)
+	{
+		const FEnemySnapshot& Entry = Snapshot.Enemies[Index];
+		AEnemyCharacter* Enemy = Assigned[Index];
+
+		if (!Enemy)
+		{
+			TArray<AEnemyCharacter*>* Candidates = Available.Find(Entry.Class);
+			if (Candidates && Candidates->Num() > 0)
+			{
+				Enemy = Candidates->Pop();
+			}
+		}
+
+		if (Enemy)
+		{
+			Enemy->SetOwner(Entry.Owner.Get());
+			Enemy->ActivateFromPool(Entry.Transform, Entry.Health);
+			NumReused++;
+		}
+		else if (Entry.Class)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.Owner = Entry.Owner.Get();
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+			Enemy = World->SpawnActor<AEnemyCharacter>(Entry.Class, Entry.Transform, SpawnParams);
+			if (!Enemy)
+			{
+				continue;
+			}
+
+			if (Enemy->GetHealthComponent())
+			{
+				Enemy->GetHealthComponent()->SetHealth(Entry.Health);
+			}
+			NumSpawned++;
+		}
+		else
+		{
+			continue;
+		}
+
+		const AAIController* AICon = Cast<AAIController>(Enemy->GetController());
+		if (UBlackboardComponent* Blackboard = AICon ? AICon->GetBlackboardComponent() : nullptr)
+		{
+			RestoreBlackboard(*Blackboard, Entry.Blackboard);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_Snapshot_EnemiesReused, NumReused);
+	INC_DWORD_STAT_BY(STAT_Snapshot_EnemiesSpawned, NumSpawned);
+}
+
+void UGameplaySnapshotSubsystem::CaptureBlackboard(const UBlackboardComponent& Blackboard, TArray<FBlackboardValueSnapshot>& OutValues)
+{
+	for (const UBlackboardData* Asset = Blackboard.GetBlackboardAsset(); Asset; Asset = Asset->Parent)
+	{
+		for (const FBlackboardEntry& Entry : Asset->Keys)
+		{
+			if (!Entry.KeyType)
+			{
+				continue;
+			}
+
+			FBlackboardValueSnapshot Value;
+			Value.KeyName = Entry.EntryName;
+			Value.KeyType = Entry.KeyType->GetClass();
+
+			if (Entry.KeyType->IsA<UBlackboardKeyType_Object>())
+			{
+				Value.Object = Blackboard.GetValueAsObject(Entry.EntryName);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Vector>())
+			{
+				Value.bIsSet = Blackboard.IsVectorValueSet(Entry.EntryName);
+				Value.Vector = Blackboard.GetValueAsVector(Entry.EntryName);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Rotator>())
+			{
+				Value.Rotator = Blackboard.GetValueAsRotator(Entry.EntryName);
+				Value.bIsSet = FAISystem::IsValidRotation(Value.Rotator);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Float>())
+			{
+				Value.Float = Blackboard.GetValueAsFloat(Entry.EntryName);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Int>())
+			{
+				Value.Int = Blackboard.GetValueAsInt(Entry.EntryName);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Bool>())
+			{
+				Value.bBool = Blackboard.GetValueAsBool(Entry.EntryName);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Name>())
+			{
+				Value.Name = Blackboard.GetValueAsName(Entry.EntryName);
+			}
+			else if (Entry.KeyType->IsA<UBlackboardKeyType_Enum>() || Entry.KeyType->IsA<UBlackboardKeyType_NativeEnum>())
+			{
+				Value.Enum = Blackboard.GetValueAsEnum(Entry.EntryName);
+			}
+			else
+			{
+				// Class and string keys aren't used by the enemy blackboards
+				continue;
+			}
+
+			OutValues.Add(MoveTemp(Value));
+		}
+	}
+}
+
+void UGameplaySnapshotSubsystem::RestoreBlackboard(UBlackboardComponent& Blackboard, const TArray<FBlackboardValueSnapshot>& Values)
+{
+	for (const FBlackboardValueSnapshot& Value : Values)
+	{
+		const UClass* KeyType = Value.KeyType;
+
+		if (!Value.bIsSet)
+		{
+			Blackboard.ClearValue(Value.KeyName);
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Object>())
+		{
+			Blackboard.SetValueAsObject(Value.KeyName, Value.Object.Get());
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Vector>())
+		{
+			Blackboard.SetValueAsVector(Value.KeyName, Value.Vector);
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Rotator>())
+		{
+			Blackboard.SetValueAsRotator(Value.KeyName, Value.Rotator);
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Float>())
+		{
+			Blackboard.SetValueAsFloat(Value.KeyName, Value.Float);
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Int>())
+		{
+			Blackboard.SetValueAsInt(Value.KeyName, Value.Int);
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Bool>())
+		{
+			Blackboard.SetValueAsBool(Value.KeyName, Value.bBool);
+		}
+		else if (KeyType->IsChildOf<UBlackboardKeyType_Name>())
+		{
+			Blackboard.SetValueAsName(Value.KeyName, Value.Name);
+		}
+		else
+		{
+			Blackboard.SetValueAsEnum(Value.KeyName, Value.Enum);
+		}
+	}
+}
+
+void UGameplaySnapshotSubsystem::RunRestoreBenchmark(int32 Iterations)
+{
+	if (!bHasSnapshot || Iterations <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("summer.Bench.SnapshotRestore: no snapshot, run summer.Snapshot.Capture first"));
+		return;
+	}
+
+	double TotalSeconds = 0.0;
+	double WorstSeconds = 0.0;
+
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		RestoreSnapshot();
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		TotalSeconds += Seconds;
+		WorstSeconds = FMath::Max(WorstSeconds, Seconds);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("summer.Bench.SnapshotRestore: %d restores of %d enemies, mean %.3f ms, worst %.3f ms"),
+		Iterations, Snapshot.Enemies.Num(), TotalSeconds * 1000.0 / Iterations, WorstSeconds * 1000.0);
+}
@@ -1,5 +1,10 @@
 #include "HealthComponent.h"
 #include "GameFramework/Actor.h"
+#include "DamageableSpatialSubsystem.h"
+#include "ActorRegistrySubsystem.h"
+#include "InfluenceMapSubsystem.h"
+#include "SummerTPSHUD.h"
+#include "GameFramework/PlayerController.h"
 
 UHealthComponent::UHealthComponent()
 {
@@ -18,6 +23,32 @@ void UHealthComponent::BeginPlay()
     {
         MyOwner->OnTakeAnyDamage.AddDynamic(this, &UHealthComponent::HandleTakeAnyDamage);
     }
+
+    if (UDamageableSpatialSubsystem* DamageableIndex = GetWorld()->GetSubsystem<UDamageableSpatialSubsystem>())
+    {
+        DamageableIndex->RegisterDamageable(this);
+    }
+
+    // Every damageable actor is findable through the registry; actors registering themselves as well are deduplicated there
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->RegisterActor(MyOwner);
+    }
+}
+
+void UHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UDamageableSpatialSubsystem* DamageableIndex = GetWorld()->GetSubsystem<UDamageableSpatialSubsystem>())
+    {
+        DamageableIndex->UnregisterDamageable(this);
+    }
+
+    if (UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+    {
+        Registry->UnregisterActor(GetOwner());
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void UHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser)
@@ -29,7 +60,23 @@ void UHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, c
 
     Health = FMath::Clamp(Health - Damage, 0.0f, DefaultHealth);
 
+    // Lets enemies steer clear of where people are getting hurt
+    if (UInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UInfluenceMapSubsystem>())
+    {
+        InfluenceMap->AddDamage(DamagedActor->GetActorLocation(), Damage);
+    }
+
     OnHealthChanged.Broadcast(this, Health, -Damage, DamageType, InstigatedBy, DamageCauser);
+
+    // Hit marker and damage number for the player who dealt it, batched by the HUD until the end of the frame
+    if (APlayerController* PlayerController = Cast<APlayerController>(InstigatedBy))
+    {
+        ASummerTPSHUD* HUD = PlayerController->GetHUD<ASummerTPSHUD>();
+        if (HUD && DamagedActor != PlayerController->GetPawn())
+        {
+            HUD->NotifyDamageDealt(DamagedActor, Damage, IsDead());
+        }
+    }
 }
 
 float UHealthComponent::GetHealth() const
@@ -41,3 +88,13 @@ bool UHealthComponent::IsDead() const
 {
     return Health <= 0.0f;
 }
+
+float UHealthComponent::GetDefaultHealth() const
+{
+    return DefaultHealth;
+}
+
+void UHealthComponent::SetHealth(float NewHealth)
+{
+    Health = FMath::Clamp(NewHealth, 0.0f, DefaultHealth);
+}
@@ -0,0 +1,501 @@
+#include "InfluenceMapSubsystem.h"
+#include "SummerTPS.h"
+#include "EnemyCharacter.h"
+#include "ActorRegistrySubsystem.h"
+#include "EngineUtils.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "Kismet/GameplayStatics.h"
+#include "DrawDebugHelpers.h"
+
+DECLARE_CYCLE_STAT(TEXT("Influence Map Tick"), STAT_InfluenceMap_Tick, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Influence Map Query"), STAT_InfluenceMap_Query, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Influence Cells Stamped"), STAT_InfluenceMap_CellsStamped, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Influence Stamps"), STAT_InfluenceMap_Stamps, STATGROUP_SummerTPS);
+
+static int32 GInfluenceMapDebugLayer = -1;
+static FAutoConsoleVariableRef CVarInfluenceMapDebugLayer(
+	TEXT("summer.AI.InfluenceMap.Debug"),
+	GInfluenceMapDebugLayer,
+	TEXT("Draws one influence layer around the player (0 threat, 1 density, 2 damage, -1 off)."));
+
+namespace InfluenceMap
+{
+	/** Number of best cells a query tries to project onto the navmesh before giving up */
+	static constexpr int32 MaxProjectedCandidates = 4;
+
+	/** Cells below this are treated as empty by the debug draw */
+	static constexpr float DebugDrawThreshold = 0.05f;
+}
+
+UInfluenceMapSubsystem::UInfluenceMapSubsystem()
+{
+	CellSize = 200.0f;
+	FallbackBounds = FBox(FVector(-10000.0f, -10000.0f, -1000.0f), FVector(10000.0f, 10000.0f, 1000.0f));
+
+	ThreatHalfLife = 1.0f;
+	DensityHalfLife = 0.75f;
+	DamageHalfLife = 4.0f;
+	MaxCellValue = 1.0f;
+
+	ThreatRange = 4000.0f;
+	ThreatHalfWidth = 250.0f;
+	ThreatAmount = 0.5f;
+	ThreatRestampAngle = 5.0f;
+
+	DensityRadius = 300.0f;
+	DensityAmount = 0.25f;
+
+	DamageRadius = 400.0f;
+	DamageAmountPerHealth = 0.02f;
+
+	RestampDistance = 100.0f;
+	RestampInterval = 0.5f;
+
+	ThreatWeight = 2.0f;
+	DensityWeight = 1.0f;
+	DamageWeight = 1.5f;
+	FlankAngleWeight = 1.0f;
+	RetreatDistanceWeight = 1.0f;
+	TravelWeight = 0.5f;
+
+	GridOrigin = FVector2D::ZeroVector;
+	GridWidth = 0;
+	GridHeight = 0;
+	RowStride = 0;
+	GridStartTime = 0.0;
+}
+
+bool UInfluenceMapSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UInfluenceMapSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInfluenceMapSubsystem, STATGROUP_Tickables);
+}
+
+void UInfluenceMapSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// The grid covers the navigable area only; cells outside it could never be walked to anyway
+	FBox Bounds(ForceInit);
+	for (TActorIterator<ANavMeshBoundsVolume> It(&InWorld); It; ++It)
+	{
+		Bounds += It->GetComponentsBoundingBox(true);
+	}
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("InfluenceMapSubsystem: no NavMeshBoundsVolume in %s, using the fallback bounds"), *InWorld.GetName());
+		Bounds = FallbackBounds;
+	}
+
+	GridOrigin = FVector2D(Bounds.Min);
+	GridWidth = FMath::Max(1, FMath::CeilToInt((Bounds.Max.X - Bounds.Min.X) / CellSize));
+	GridHeight = FMath::Max(1, FMath::CeilToInt((Bounds.Max.Y - Bounds.Min.Y) / CellSize));
+	RowStride = Align(GridWidth, 4);
+	GridStartTime = InWorld.GetTimeSeconds();
+
+	for (FLayer& Layer : Layers)
+	{
+		Layer.Values.SetNumZeroed(RowStride * GridHeight);
+		Layer.StampTimes.SetNumZeroed(RowStride * GridHeight);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("InfluenceMapSubsystem: %dx%d cells of %.0f cm (%.1f KB)"), GridWidth, GridHeight, CellSize,
+		(int32)EInfluenceLayer::Count * RowStride * GridHeight * 2 * sizeof(float) / 1024.0f);
+}
+
+float UInfluenceMapSubsystem::GetGridTime() const
+{
+	return (float)(GetWorld()->GetTimeSeconds() - GridStartTime);
+}
+
+float UInfluenceMapSubsystem::GetHalfLife(EInfluenceLayer Layer) const
+{
+	switch (Layer)
+	{
+	case EInfluenceLayer::Threat:
+		return ThreatHalfLife;
+	case EInfluenceLayer::Density:
+		return DensityHalfLife;
+	default:
+		return DamageHalfLife;
+	}
+}
+
+FIntPoint UInfluenceMapSubsystem::ToCell(const FVector2D& Location) const
+{
+	const FVector2D Local = (Location - GridOrigin) / CellSize;
+	return FIntPoint(FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y));
+}
+
+void UInfluenceMapSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InfluenceMap_Tick);
+
+	if (!HasGrid())
+	{
+		return;
+	}
+
+	const float Now = GetGridTime();
+	StampThreat(Now);
+	StampDensity(Now);
+
+	if (GInfluenceMapDebugLayer >= 0 && GInfluenceMapDebugLayer < (int32)EInfluenceLayer::Count)
+	{
+		if (const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0))
+		{
+			const FIntPoint Center = ToCell(FVector2D(PlayerPawn->GetActorLocation()));
+			const int32 DebugCells = 20;
+			const float Z = PlayerPawn->GetActorLocation().Z - 80.0f;
+
+			for (int32 Y = FMath::Max(0, Center.Y - DebugCells); Y <= FMath::Min(GridHeight - 1, Center.Y + DebugCells); ++Y)
+			{
+				for (int32 X = FMath::Max(0, Center.X - DebugCells); X <= FMath::Min(GridWidth - 1, Center.X + DebugCells); ++X)
+				{
+					const float Value = ReadCell((EInfluenceLayer)GInfluenceMapDebugLayer, Y * RowStride + X, Now);
+					if (Value > InfluenceMap::DebugDrawThreshold)
+					{
+						const FVector CellCenter(GetCellCenter(X, Y), Z);
+						const FColor Color = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, Value / MaxCellValue).ToFColor(true);
+						DrawDebugSolidBox(GetWorld(), CellCenter, FVector(CellSize * 0.45f, CellSize * 0.45f, 2.0f), Color);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool UInfluenceMapSubsystem::ShouldRestamp(const FSourceStamp& Stamp, const FVector2D& Location, const FVector2D& Direction, float Now) const
+{
+	if (Stamp.Time < 0.0f || Now - Stamp.Time >= RestampInterval)
+	{
+		return true;
+	}
+
+	if (FVector2D::DistSquared(Stamp.Location, Location) >= FMath::Square(RestampDistance))
+	{
+		return true;
+	}
+
+	return !Direction.IsZero() && FVector2D::DotProduct(Stamp.Direction, Direction) < FMath::Cos(FMath::DegreesToRadians(ThreatRestampAngle));
+}
+
+void UInfluenceMapSubsystem::StampThreat(float Now)
+{
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	if (!PlayerPawn)
+	{
+		return;
+	}
+
+	const FVector2D Location(PlayerPawn->GetActorLocation());
+	const FVector2D Aim = FVector2D(PlayerPawn->GetBaseAimRotation().Vector()).GetSafeNormal();
+	if (Aim.IsZero() || !ShouldRestamp(PlayerStamp, Location, Aim, Now))
+	{
+		return;
+	}
+
+	StampSegment(EInfluenceLayer::Threat, Location, Location + Aim * ThreatRange, ThreatHalfWidth, ThreatAmount, Now);
+
+	PlayerStamp.Location = Location;
+	PlayerStamp.Direction = Aim;
+	PlayerStamp.Time = Now;
+}
+
+void UInfluenceMapSubsystem::StampDensity(float Now)
+{
+	const UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>();
+	if (!Registry)
+	{
+		return;
+	}
+
+	Registry->ForEachActor<AEnemyCharacter>([this, Now](AEnemyCharacter* Enemy)
+	{
+		if (Enemy->IsDead() || Enemy->IsPooled())
+		{
+			return;
+		}
+
+		const FVector2D Location(Enemy->GetActorLocation());
+		FSourceStamp& Stamp = EnemyStamps.FindOrAdd(Enemy);
+		if (ShouldRestamp(Stamp, Location, FVector2D::ZeroVector, Now))
+		{
+			StampRadial(EInfluenceLayer::Density, Location, DensityRadius, DensityAmount, Now);
+			Stamp.Location = Location;
+			Stamp.Time = Now;
+		}
+	});
+
+	// Drop sources that died or went back to the pool; their stamps simply decay away
+	for (auto It = EnemyStamps.CreateIterator(); It; ++It)
+	{
+		const AEnemyCharacter* Enemy = Cast<AEnemyCharacter>(It.Key().Get());
+		if (!Enemy || Enemy->IsDead() || Enemy->IsPooled())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UInfluenceMapSubsystem::AddDamage(const FVector& Location, float Amount)
+{
+	if (HasGrid() && Amount > 0.0f)
+	{
+		StampRadial(EInfluenceLayer::Damage, FVector2D(Location), DamageRadius, Amount * DamageAmountPerHealth, GetGridTime());
+	}
+}
+
+template <typename ContributionFunc>
+void UInfluenceMapSubsystem::StampArea(EInfluenceLayer Layer, const FBox2D& Area, float Now, ContributionFunc&& Contribution)
+{
+	const FIntPoint MinCell = ToCell(Area.Min);
+	const FIntPoint MaxCell = ToCell(Area.Max);
+
+	// Start on a multiple of four so every step covers four cells of the same (padded) row
+	const int32 MinX = FMath::Max(0, MinCell.X) & ~3;
+	const int32 MaxX = FMath::Min(GridWidth - 1, MaxCell.X);
+	const int32 MinY = FMath::Max(0, MinCell.Y);
+	const int32 MaxY = FMath::Min(GridHeight - 1, MaxCell.Y);
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return;
+	}
+
+	FLayer& Data = Layers[(int32)Layer];
+	float* Values = Data.Values.GetData();
+	float* StampTimes = Data.StampTimes.GetData();
+
+	const VectorRegister4Float NowV = VectorSetFloat1(Now);
+	const VectorRegister4Float NegInvHalfLife = VectorSetFloat1(-1.0f / FMath::Max(GetHalfLife(Layer), KINDA_SMALL_NUMBER));
+	const VectorRegister4Float MaxValue = VectorSetFloat1(MaxCellValue);
+	const VectorRegister4Float LaneOffsets = VectorMultiply(MakeVectorRegisterFloat(0.5f, 1.5f, 2.5f, 3.5f), VectorSetFloat1(CellSize));
+
+	int32 NumCells = 0;
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		const float CellY = (float)GridOrigin.Y + (Y + 0.5f) * CellSize;
+
+		for (int32 X = MinX; X <= MaxX; X += 4)
+		{
+			const int32 Index = Y * RowStride + X;
+			const VectorRegister4Float CellX = VectorAdd(VectorSetFloat1((float)GridOrigin.X + X * CellSize), LaneOffsets);
+
+			// Bring the four cells up to date (value * 2^(-age / half life)), add the source and saturate
+			const VectorRegister4Float Age = VectorSubtract(NowV, VectorLoad(StampTimes + Index));
+			VectorRegister4Float Value = VectorMultiply(VectorLoad(Values + Index), VectorExp2(VectorMultiply(Age, NegInvHalfLife)));
+			Value = VectorMin(VectorAdd(Value, Contribution(CellX, CellY)), MaxValue);
+
+			VectorStore(Value, Values + Index);
+			VectorStore(NowV, StampTimes + Index);
+		}
+
+		NumCells += Align(MaxX - MinX + 1, 4);
+	}
+
+	INC_DWORD_STAT_BY(STAT_InfluenceMap_CellsStamped, NumCells);
+	INC_DWORD_STAT(STAT_InfluenceMap_Stamps);
+}
+
+void UInfluenceMapSubsystem::StampRadial(EInfluenceLayer Layer, const FVector2D& Center, float Radius, float Amount, float Now)
+{
+	const VectorRegister4Float CenterX = VectorSetFloat1((float)Center.X);
+	const VectorRegister4Float AmountV = VectorSetFloat1(Amount);
+	const VectorRegister4Float NegAmountOverRadius = VectorSetFloat1(-Amount / Radius);
+	const float CenterY = (float)Center.Y;
+
+	// Linear falloff: Amount * (1 - Distance / Radius), clamped at 0
+	StampArea(Layer, FBox2D(Center - FVector2D(Radius), Center + FVector2D(Radius)), Now,
+		[&](const VectorRegister4Float& CellX, float CellY)
+		{
+			const VectorRegister4Float DX = VectorSubtract(CellX, CenterX);
+			const VectorRegister4Float DistanceSq = VectorMultiplyAdd(DX, DX, VectorSetFloat1(FMath::Square(CellY - CenterY)));
+			const VectorRegister4Float Falloff = VectorMultiplyAdd(VectorSqrt(DistanceSq), NegAmountOverRadius, AmountV);
+			return VectorMax(Falloff, VectorZeroFloat());
+		});
+}
+
+void UInfluenceMapSubsystem::StampSegment(EInfluenceLayer Layer, const FVector2D& Start, const FVector2D& End, float HalfWidth, float Amount, float Now)
+{
+	const FVector2D Delta = End - Start;
+	const float InvLengthSq = 1.0f / FMath::Max((float)Delta.SizeSquared(), KINDA_SMALL_NUMBER);
+
+	const VectorRegister4Float StartX = VectorSetFloat1((float)Start.X);
+	const VectorRegister4Float DeltaX = VectorSetFloat1((float)Delta.X);
+	const VectorRegister4Float DeltaY = VectorSetFloat1((float)Delta.Y);
+	const VectorRegister4Float InvLengthSqV = VectorSetFloat1(InvLengthSq);
+	const VectorRegister4Float AmountV = VectorSetFloat1(Amount);
+	const VectorRegister4Float NegAmountOverWidth = VectorSetFloat1(-Amount / HalfWidth);
+	const VectorRegister4Float HalfV = VectorSetFloat1(0.5f);
+	const float StartY = (float)Start.Y;
+
+	FBox2D Area(ForceInit);
+	Area += Start;
+	Area += End;
+
+	// Distance to the closest point on the segment, linear falloff across the width and down to half strength at the far end
+	StampArea(Layer, Area.ExpandBy(HalfWidth), Now,
+		[&](const VectorRegister4Float& CellX, float CellY)
+		{
+			const VectorRegister4Float PX = VectorSubtract(CellX, StartX);
+			const VectorRegister4Float PY = VectorSetFloat1(CellY - StartY);
+			const VectorRegister4Float Along = VectorMultiply(VectorMultiplyAdd(PX, DeltaX, VectorMultiply(PY, DeltaY)), InvLengthSqV);
+			const VectorRegister4Float T = VectorMin(VectorMax(Along, VectorZeroFloat()), VectorOneFloat());
+
+			const VectorRegister4Float EX = VectorNegateMultiplyAdd(T, DeltaX, PX);
+			const VectorRegister4Float EY = VectorNegateMultiplyAdd(T, DeltaY, PY);
+			const VectorRegister4Float Distance = VectorSqrt(VectorMultiplyAdd(EX, EX, VectorMultiply(EY, EY)));
+
+			const VectorRegister4Float Falloff = VectorMax(VectorMultiplyAdd(Distance, NegAmountOverWidth, AmountV), VectorZeroFloat());
+			return VectorMultiply(Falloff, VectorNegateMultiplyAdd(T, HalfV, VectorOneFloat()));
+		});
+}
+
+float UInfluenceMapSubsystem::ReadCell(EInfluenceLayer Layer, int32 Index, float Now) const
+{
+	const FLayer& Data = Layers[(int32)Layer];
+	const float Value = Data.Values[Index];
+	return Value > 0.0f ? Value * FMath::Exp2(-(Now - Data.StampTimes[Index]) / FMath::Max(GetHalfLife(Layer), KINDA_SMALL_NUMBER)) : 0.0f;
+}
+
+float UInfluenceMapSubsystem::SampleLayer(EInfluenceLayer Layer, const FVector& Location) const
+{
+	const FIntPoint Cell = ToCell(FVector2D(Location));
+	if (!HasGrid() || Cell.X < 0 || Cell.Y < 0 || Cell.X >= GridWidth || Cell.Y >= GridHeight)
+	{
+		return 0.0f;
+	}
+
+	return ReadCell(Layer, Cell.Y * RowStride + Cell.X, GetGridTime());
+}
+
+bool UInfluenceMapSubsystem::FindFlankPosition(const FVector& QuerierLocation, const AActor* Target, float MinRange, float MaxRange, FVector& OutLocation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InfluenceMap_Query);
+
+	if (!HasGrid() || !Target || MaxRange <= 0.0f)
+	{
+		return false;
+	}
+
+	const float Now = GetGridTime();
+	const FVector2D TargetLocation(Target->GetActorLocation());
+	const FVector2D TargetForward = FVector2D(Target->GetActorForwardVector()).GetSafeNormal();
+	const FVector2D Querier(QuerierLocation);
+	const FIntPoint MinCell = ToCell(TargetLocation - FVector2D(MaxRange));
+	const FIntPoint MaxCell = ToCell(TargetLocation + FVector2D(MaxRange));
+
+	TArray<FCandidate, TInlineAllocator<InfluenceMap::MaxProjectedCandidates + 1>> Best;
+
+	for (int32 Y = FMath::Max(0, MinCell.Y); Y <= FMath::Min(GridHeight - 1, MaxCell.Y); ++Y)
+	{
+		for (int32 X = FMath::Max(0, MinCell.X); X <= FMath::Min(GridWidth - 1, MaxCell.X); ++X)
+		{
+			const FVector2D CellCenter = GetCellCenter(X, Y);
+			const FVector2D ToCellDir = CellCenter - TargetLocation;
+			const float Distance = (float)ToCellDir.Size();
+			if (Distance < MinRange || Distance > MaxRange)
+			{
+				continue;
+			}
+
+			const int32 Index = Y * RowStride + X;
+
+			// Side-on to the target scores 1, straight in front or behind its facing scores 0
+			const float Sideways = 1.0f - FMath::Abs((float)FVector2D::DotProduct(ToCellDir / Distance, TargetForward));
+
+			const float Score = FlankAngleWeight * Sideways
+				- ThreatWeight * ReadCell(EInfluenceLayer::Threat, Index, Now)
+				- DensityWeight * ReadCell(EInfluenceLayer::Density, Index, Now)
+				- DamageWeight * ReadCell(EInfluenceLayer::Damage, Index, Now)
+				- TravelWeight * (float)FVector2D::Distance(Querier, CellCenter) / MaxRange;
+
+			Best.Add({ CellCenter, Score });
+			Best.Sort([](const FCandidate& A, const FCandidate& B) { return A.Score > B.Score; });
+			if (Best.Num() > InfluenceMap::MaxProjectedCandidates)
+			{
+				Best.Pop();
+			}
+		}
+	}
+
+	return ProjectBestCandidate(Best, (float)Target->GetActorLocation().Z, OutLocation);
+}
+
+bool UInfluenceMapSubsystem::FindRetreatPosition(const FVector& QuerierLocation, const FVector& ThreatLocation, float SearchRadius, FVector& OutLocation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InfluenceMap_Query);
+
+	if (!HasGrid() || SearchRadius <= 0.0f)
+	{
+		return false;
+	}
+
+	const float Now = GetGridTime();
+	const FVector2D Querier(QuerierLocation);
+	const FVector2D Threat(ThreatLocation);
+	const float CurrentThreatDistance = (float)FVector2D::Distance(Querier, Threat);
+	const FIntPoint MinCell = ToCell(Querier - FVector2D(SearchRadius));
+	const FIntPoint MaxCell = ToCell(Querier + FVector2D(SearchRadius));
+
+	TArray<FCandidate, TInlineAllocator<InfluenceMap::MaxProjectedCandidates + 1>> Best;
+
+	for (int32 Y = FMath::Max(0, MinCell.Y); Y <= FMath::Min(GridHeight - 1, MaxCell.Y); ++Y)
+	{
+		for (int32 X = FMath::Max(0, MinCell.X); X <= FMath::Min(GridWidth - 1, MaxCell.X); ++X)
+		{
+			const FVector2D CellCenter = GetCellCenter(X, Y);
+			if (FVector2D::DistSquared(CellCenter, Querier) > FMath::Square(SearchRadius))
+			{
+				continue;
+			}
+
+			const int32 Index = Y * RowStride + X;
+			const float DistanceGained = (float)FVector2D::Distance(CellCenter, Threat) - CurrentThreatDistance;
+
+			// Density counts half: retreating next to other enemies is still better than staying in the open
+			const float Score = RetreatDistanceWeight * DistanceGained / SearchRadius
+				- ThreatWeight * ReadCell(EInfluenceLayer::Threat, Index, Now)
+				- 0.5f * DensityWeight * ReadCell(EInfluenceLayer::Density, Index, Now)
+				- DamageWeight * ReadCell(EInfluenceLayer::Damage, Index, Now);
+
+			Best.Add({ CellCenter, Score });
+			Best.Sort([](const FCandidate& A, const FCandidate& B) { return A.Score > B.Score; });
+			if (Best.Num() > InfluenceMap::MaxProjectedCandidates)
+			{
+				Best.Pop();
+			}
+		}
+	}
+
+	return ProjectBestCandidate(Best, (float)QuerierLocation.Z, OutLocation);
+}
+
+bool UInfluenceMapSubsystem::ProjectBestCandidate(TConstArrayView<FCandidate> Candidates, float Z, FVector& OutLocation) const
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys)
+	{
+		return false;
+	}
+
+	// Cells are coarse, so allow snapping anywhere inside the cell and a generous height range for dunes
+	const FVector QueryExtent(CellSize * 0.5f, CellSize * 0.5f, 500.0f);
+	for (const FCandidate& Candidate : Candidates)
+	{
+		FNavLocation Projected;
+		if (NavSys->ProjectPointToNavigation(FVector(Candidate.Location, Z), Projected, QueryExtent))
+		{
+			OutLocation = Projected.Location;
+			return true;
+		}
+	}
+
+	return false;
+}
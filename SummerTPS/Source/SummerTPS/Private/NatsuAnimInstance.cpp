@@ -0,0 +1,61 @@
+#include "NatsuAnimInstance.h"
+#include "SummerTPS.h"
+#include "TPSPlayer.h"
+
+DECLARE_CYCLE_STAT(TEXT("Natsu Anim PreUpdate (GT)"), STAT_NatsuAnim_PreUpdate, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Natsu Anim Update (Worker)"), STAT_NatsuAnim_Update, STATGROUP_SummerTPS);
+
+void FNatsuAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NatsuAnim_PreUpdate);
+
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	if (const UNatsuAnimInstance* NatsuInstance = Cast<UNatsuAnimInstance>(InAnimInstance))
+	{
+		MinMoveSpeed = NatsuInstance->MinMoveSpeed;
+		AimInterpSpeed = NatsuInstance->AimInterpSpeed;
+		AimYawRange = NatsuInstance->AimYawRange;
+		AimPitchRange = NatsuInstance->AimPitchRange;
+	}
+
+	// Plain copies only, everything derived from them is computed in Update
+	const ATPSPlayer* Player = Cast<ATPSPlayer>(InAnimInstance->TryGetPawnOwner());
+	bHasPlayer = Player != nullptr;
+	if (!Player)
+	{
+		return;
+	}
+
+	ControlRotation = Player->GetBaseAimRotation();
+	ActorRotation = Player->GetActorRotation();
+	Velocity = Player->GetVelocity();
+	bIsAiming = Player->IsAiming();
+	bIsSprinting = Player->IsSprinting();
+	bIsCovered = Player->IsCovered();
+	bIsEnteringCover = Player->IsEnteringCover();
+	bIsExitingCover = Player->IsExitingCover();
+}
+
+void FNatsuAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NatsuAnim_Update);
+
+	Super::Update(DeltaSeconds);
+
+	if (!bHasPlayer)
+	{
+		return;
+	}
+
+	GroundSpeed = Velocity.Size2D();
+	bShouldMove = GroundSpeed > MinMoveSpeed;
+	Direction = bShouldMove ? ActorRotation.UnrotateVector(Velocity).Rotation().Yaw : 0.0f;
+
+	const FRotator AimDelta = (ControlRotation - ActorRotation).GetNormalized();
+	const float TargetYaw = FMath::Clamp(AimDelta.Yaw, AimYawRange.X, AimYawRange.Y);
+	const float TargetPitch = FMath::Clamp(AimDelta.Pitch, AimPitchRange.X, AimPitchRange.Y);
+
+	AimYaw = FMath::FInterpTo(AimYaw, TargetYaw, DeltaSeconds, AimInterpSpeed);
+	AimPitch = FMath::FInterpTo(AimPitch, TargetPitch, DeltaSeconds, AimInterpSpeed);
+}
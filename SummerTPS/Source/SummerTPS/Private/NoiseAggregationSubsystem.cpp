@@ -0,0 +1,154 @@
+#include "NoiseAggregationSubsystem.h"
+#include "SummerTPS.h"
+#include "EnemyCharacter.h"
+#include "HealthComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Noise Aggregation Tick"), STAT_NoiseAggregation_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noise Reports"), STAT_NoiseAggregation_Reports, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noise Events (merged)"), STAT_NoiseAggregation_Events, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noise Deliveries"), STAT_NoiseAggregation_Deliveries, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noise Delivery Queue"), STAT_NoiseAggregation_Queue, STATGROUP_SummerTPS);
+
+UNoiseAggregationSubsystem::UNoiseAggregationSubsystem()
+{
+	MaxDeliveriesPerFrame = 16;
+	MaxDeliveryDelay = 1.0f;
+	DeliveryHead = 0;
+}
+
+bool UNoiseAggregationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNoiseAggregationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNoiseAggregationSubsystem, STATGROUP_Tickables);
+}
+
+void UNoiseAggregationSubsystem::ReportNoise(AActor* Source, const FVector& Location, float Loudness, float MaxRange, FName Kind)
+{
+	if (Loudness <= 0.0f || MaxRange <= 0.0f)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_NoiseAggregation_Reports);
+
+	FMergedNoise* Noise = PendingNoises.FindByPredicate([Source, Kind](const FMergedNoise& Pending)
+	{
+		return Pending.Source.Get() == Source && Pending.Kind == Kind;
+	});
+
+	if (!Noise)
+	{
+		Noise = &PendingNoises.AddDefaulted_GetRef();
+		Noise->Source = Source;
+		Noise->Kind = Kind;
+	}
+
+	Noise->WeightedLocation += Location * Loudness;
+	Noise->TotalLoudness += Loudness;
+	Noise->Loudness = FMath::Max(Noise->Loudness, Loudness);
+	Noise->MaxRange = FMath::Max(Noise->MaxRange, MaxRange);
+	Noise->NumReports++;
+}
+
+void UNoiseAggregationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NoiseAggregation_Tick);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	GatherListeners(Now);
+	Deliver(Now);
+
+	SET_DWORD_STAT(STAT_NoiseAggregation_Queue, DeliveryQueue.Num() - DeliveryHead);
+}
+
+void UNoiseAggregationSubsystem::GatherListeners(double Now)
+{
+	if (PendingNoises.Num() == 0)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_NoiseAggregation_Events, PendingNoises.Num());
+
+	const UDamageableSpatialSubsystem* DamageableIndex = GetWorld()->GetSubsystem<UDamageableSpatialSubsystem>();
+	if (!DamageableIndex)
+	{
+		PendingNoises.Reset();
+		return;
+	}
+
+	for (const FMergedNoise& Noise : PendingNoises)
+	{
+		const FVector Location = Noise.WeightedLocation / Noise.TotalLoudness;
+		const float Range = Noise.MaxRange * Noise.Loudness;
+
+		DamageableIndex->QueryRadius(Location, Range, ListenerScratch);
+		for (const FDamageableQueryHit& Hit : ListenerScratch)
+		{
+			AEnemyCharacter* Enemy = Cast<AEnemyCharacter>(Hit.HealthComponent->GetOwner());
+			if (!Enemy || Enemy->IsPooled())
+			{
+				continue;
+			}
+
+			// One queued delivery per enemy: a louder or newer noise replaces the waiting one in place
+			const TWeakObjectPtr<AEnemyCharacter> EnemyKey(Enemy);
+			if (const int32* QueuedIndex = QueuedEnemies.Find(EnemyKey))
+			{
+				FNoiseDelivery& Queued = DeliveryQueue[*QueuedIndex];
+				Queued.Source = Noise.Source;
+				Queued.Location = Location;
+				Queued.Loudness = Noise.Loudness;
+				Queued.Time = Now;
+				continue;
+			}
+
+			QueuedEnemies.Add(EnemyKey, DeliveryQueue.Num());
+			DeliveryQueue.Add({ EnemyKey, Noise.Source, Location, Noise.Loudness, Now });
+		}
+	}
+
+	PendingNoises.Reset();
+}
+
+void UNoiseAggregationSubsystem::Deliver(double Now)
+{
+	int32 NumDelivered = 0;
+	while (DeliveryHead < DeliveryQueue.Num() && NumDelivered < MaxDeliveriesPerFrame)
+	{
+		const FNoiseDelivery& Delivery = DeliveryQueue[DeliveryHead++];
+		QueuedEnemies.Remove(Delivery.Enemy);
+
+		AEnemyCharacter* Enemy = Delivery.Enemy.Get();
+		if (!Enemy || Now - Delivery.Time > MaxDeliveryDelay)
+		{
+			continue;
+		}
+
+		Enemy->OnNoiseHeard(Delivery.Location, Delivery.Loudness, Delivery.Source.Get());
+		++NumDelivered;
+	}
+
+	INC_DWORD_STAT_BY(STAT_NoiseAggregation_Deliveries, NumDelivered);
+
+	if (DeliveryHead == DeliveryQueue.Num())
+	{
+		DeliveryQueue.Reset();
+		DeliveryHead = 0;
+	}
+	else if (DeliveryHead > DeliveryQueue.Num() / 2)
+	{
+		DeliveryQueue.RemoveAt(0, DeliveryHead);
+		DeliveryHead = 0;
+
+		for (int32 Index = 0; Index < DeliveryQueue.Num(); ++Index)
+		{
+			QueuedEnemies.Add(DeliveryQueue[Index].Enemy, Index);
+		}
+	}
+}
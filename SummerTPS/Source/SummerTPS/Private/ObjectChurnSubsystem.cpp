@@ -0,0 +1,384 @@
+#include "ObjectChurnSubsystem.h"
+#include "SummerTPS.h"
+#include "ActorRegistrySubsystem.h"
+#include "EnemyCharacter.h"
+#include "ProjectilePoolSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Object Churn Tick"), STAT_ObjectChurn_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("UObject Creations / s"), STAT_ObjectChurn_CreatedPerSecond, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("UObject Destructions / s"), STAT_ObjectChurn_DestroyedPerSecond, STATGROUP_SummerTPS);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last GC Pause (ms)"), STAT_ObjectChurn_LastGCPause, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Actors Clustered"), STAT_ObjectChurn_Clustered, STATGROUP_SummerTPS);
+
+namespace ObjectChurn
+{
+	/** GC pauses kept for the report */
+	static constexpr int32 MaxGCSamples = 128;
+
+	static int32 ClusterPools = 1;
+	static FAutoConsoleVariableRef CVarClusterPools(
+		TEXT("summer.Churn.ClusterPools"),
+		ClusterPools,
+		TEXT("Put inactive pooled projectiles and enemies into GC clusters (also needs gc.CreateGCClusters)."));
+
+	static void ForEachMonitor(UWorld* World, TFunctionRef<void(UObjectChurnSubsystem&)> Func)
+	{
+		if (UObjectChurnSubsystem* Monitor = World ? World->GetSubsystem<UObjectChurnSubsystem>() : nullptr)
+		{
+			Func(*Monitor);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("summer.Churn.Report"),
+		TEXT("Prints the classes with the most UObject churn and the GC pauses grouped by combat intensity."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			ForEachMonitor(World, [](UObjectChurnSubsystem& Monitor) { Monitor.ReportStats(); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs ResetCommand(
+		TEXT("summer.Churn.Reset"),
+		TEXT("Clears the accumulated churn and GC statistics."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			ForEachMonitor(World, [](UObjectChurnSubsystem& Monitor) { Monitor.ResetStats(); });
+		}));
+
+	static bool AreClustersEnabled()
+	{
+		static const IConsoleVariable* CreateGCClusters = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.CreateGCClusters"));
+		return ClusterPools != 0 && CreateGCClusters && CreateGCClusters->GetInt() != 0;
+	}
+}
+
+UObjectChurnSubsystem::UObjectChurnSubsystem()
+{
+	WindowSeconds = 1.0f;
+	DefaultBudgetPerSecond = 200;
+	WarningCooldown = 10.0f;
+	HeavyCombatIntensity = 20;
+
+	bListening = false;
+	UntrackedDestroyed = 0;
+	WindowCreated = 0;
+	WindowDestroyed = 0;
+	WindowStart = 0.0;
+	CombatIntensity = 0;
+	GCStartTime = 0.0;
+	NextGCSample = 0;
+	NumGCs = 0;
+}
+
+void UObjectChurnSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if !UE_BUILD_SHIPPING
+	GUObjectArray.AddUObjectCreateListener(this);
+	GUObjectArray.AddUObjectDeleteListener(this);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UObjectChurnSubsystem::OnPreGarbageCollect);
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UObjectChurnSubsystem::OnPostGarbageCollect);
+	bListening = true;
+#endif
+
+	WindowStart = FPlatformTime::Seconds();
+}
+
+void UObjectChurnSubsystem::Deinitialize()
+{
+	OnUObjectArrayShutdown();
+
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().RemoveAll(this);
+	FCoreUObjectDelegates::GetPostGarbageCollect().RemoveAll(this);
+
+	Super::Deinitialize();
+}
+
+bool UObjectChurnSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UObjectChurnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UObjectChurnSubsystem, STATGROUP_Tickables);
+}
+
+void UObjectChurnSubsystem::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	const UClass* Class = Object->GetClass();
+
+	FScopeLock ScopeLock(&Lock);
+
+	FClassChurn* Churn = Classes.Find(Class);
+	if (!Churn)
+	{
+		Churn = &Classes.Add(Class);
+		Churn->ClassName = Class->GetFName();
+	}
+
+	Churn->WindowCreated++;
+	WindowCreated++;
+}
+
+void UObjectChurnSubsystem::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index)
+{
+	// Only the pointer is used as a key, the class isn't dereferenced
+	const UClass* Class = Object->GetClass();
+
+	FScopeLock ScopeLock(&Lock);
+
+	if (FClassChurn* Churn = Classes.Find(Class))
+	{
+		Churn->WindowDestroyed++;
+	}
+	else
+	{
+		UntrackedDestroyed++;
+	}
+	WindowDestroyed++;
+}
+
+void UObjectChurnSubsystem::OnUObjectArrayShutdown()
+{
+	if (bListening)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		GUObjectArray.RemoveUObjectDeleteListener(this);
+		bListening = false;
+	}
+}
+
+void UObjectChurnSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ObjectChurn_Tick);
+
+	// Real time, a hitch must not make the rates look lower than they were
+	const double Now = FPlatformTime::Seconds();
+	if (bListening && Now - WindowStart >= WindowSeconds)
+	{
+		CombatIntensity = MeasureCombatIntensity();
+		CloseWindow(Now);
+	}
+}
+
+void UObjectChurnSubsystem::CloseWindow(double Now)
+{
+	const double Elapsed = FMath::Max(Now - WindowStart, (double)KINDA_SMALL_NUMBER);
+	WindowStart = Now;
+
+	FScopeLock ScopeLock(&Lock);
+
+	SET_DWORD_STAT(STAT_ObjectChurn_CreatedPerSecond, FMath::RoundToInt(WindowCreated / Elapsed));
+	SET_DWORD_STAT(STAT_ObjectChurn_DestroyedPerSecond, FMath::RoundToInt(WindowDestroyed / Elapsed));
+	WindowCreated = 0;
+	WindowDestroyed = 0;
+
+	for (TPair<const UClass*, FClassChurn>& Pair : Classes)
+	{
+		FClassChurn& Churn = Pair.Value;
+		if (Churn.WindowCreated == 0 && Churn.WindowDestroyed == 0)
+		{
+			Churn.LastRate = 0.0f;
+			continue;
+		}
+
+		Churn.TotalCreated += Churn.WindowCreated;
+		Churn.TotalDestroyed += Churn.WindowDestroyed;
+		Churn.LastRate = (float)(FMath::Max(Churn.WindowCreated, Churn.WindowDestroyed) / Elapsed);
+		Churn.PeakRate = FMath::Max(Churn.PeakRate, Churn.LastRate);
+		Churn.WindowCreated = 0;
+		Churn.WindowDestroyed = 0;
+
+		const int32 Budget = GetBudget(Churn.ClassName);
+		if (Churn.LastRate > Budget && (Churn.LastWarningTime < 0.0 || Now - Churn.LastWarningTime >= WarningCooldown))
+		{
+			Churn.LastWarningTime = Now;
+			UE_LOG(LogTemp, Warning, TEXT("%s churns %.0f objects/s, over its budget of %d/s (combat intensity %d)"),
+				*Churn.ClassName.ToString(), Churn.LastRate, Budget, CombatIntensity);
+		}
+	}
+}
+
+int32 UObjectChurnSubsystem::GetBudget(FName ClassName) const
+{
+	const int32* Budget = ClassBudgetsPerSecond.Find(ClassName);
+	return Budget ? *Budget : DefaultBudgetPerSecond;
+}
+
+int32 UObjectChurnSubsystem::MeasureCombatIntensity() const
+{
+	int32 Intensity = 0;
+
+	if (const UProjectilePoolSubsystem* Projectiles = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+	{
+		Intensity += Projectiles->GetNumInFlight();
+	}
+
+	if (const UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		Registry->ForEachActor<AEnemyCharacter>([&Intensity](AEnemyCharacter* Enemy)
+		{
+			if (!Enemy->IsPooled() && !Enemy->IsDead())
+			{
+				Intensity++;
+			}
+		});
+	}
+
+	return Intensity;
+}
+
+void UObjectChurnSubsystem::OnPreGarbageCollect()
+{
+	GCStartTime = FPlatformTime::Seconds();
+}
+
+void UObjectChurnSubsystem::OnPostGarbageCollect()
+{
+	if (GCStartTime <= 0.0)
+	{
+		return;
+	}
+
+	FGCSample Sample;
+	Sample.PauseMs = (float)((FPlatformTime::Seconds() - GCStartTime) * 1000.0);
+	Sample.CombatIntensity = CombatIntensity;
+	GCStartTime = 0.0;
+
+	if (GCSamples.Num() < ObjectChurn::MaxGCSamples)
+	{
+		GCSamples.Add(Sample);
+	}
+	else
+	{
+		GCSamples[NextGCSample] = Sample;
+	}
+	NextGCSample = (NextGCSample + 1) % ObjectChurn::MaxGCSamples;
+	NumGCs++;
+
+	SET_FLOAT_STAT(STAT_ObjectChurn_LastGCPause, Sample.PauseMs);
+}
+
+void UObjectChurnSubsystem::ReportStats() const
+{
+	TArray<FClassChurn> Sorted;
+	uint64 Untracked;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Classes.GenerateValueArray(Sorted);
+		Untracked = UntrackedDestroyed;
+	}
+
+	Sorted.Sort([](const FClassChurn& A, const FClassChurn& B) { return A.PeakRate > B.PeakRate; });
+
+	UE_LOG(LogTemp, Log, TEXT("UObject churn, top classes by peak rate (%llu destructions of untracked classes):"), Untracked);
+	for (int32 Index = 0; Index < FMath::Min(Sorted.Num(), 20); ++Index)
+	{
+		const FClassChurn& Churn = Sorted[Index];
+		if (Churn.PeakRate <= 0.0f)
+		{
+			break;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("  %-40s peak %6.0f/s  last %6.0f/s  budget %5d/s  created %8llu  destroyed %8llu"),
+			*Churn.ClassName.ToString(), Churn.PeakRate, Churn.LastRate, GetBudget(Churn.ClassName), Churn.TotalCreated, Churn.TotalDestroyed);
+	}
+
+	if (GCSamples.Num() == 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("No garbage collection since the monitor started."));
+		return;
+	}
+
+	// Idle, light and heavy combat
+	float TotalPause[3] = { 0.0f, 0.0f, 0.0f };
+	float MaxPause[3] = { 0.0f, 0.0f, 0.0f };
+	int32 Count[3] = { 0, 0, 0 };
+
+	double SumX = 0.0, SumY = 0.0, SumXX = 0.0, SumYY = 0.0, SumXY = 0.0;
+	for (const FGCSample& Sample : GCSamples)
+	{
+		const int32 Bucket = Sample.CombatIntensity == 0 ? 0 : (Sample.CombatIntensity < HeavyCombatIntensity ? 1 : 2);
+		TotalPause[Bucket] += Sample.PauseMs;
+		MaxPause[Bucket] = FMath::Max(MaxPause[Bucket], Sample.PauseMs);
+		Count[Bucket]++;
+
+		SumX += Sample.CombatIntensity;
+		SumY += Sample.PauseMs;
+		SumXX += FMath::Square((double)Sample.CombatIntensity);
+		SumYY += FMath::Square((double)Sample.PauseMs);
+		SumXY += Sample.CombatIntensity * (double)Sample.PauseMs;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Garbage collection: %llu passes, the last %d by combat intensity:"), NumGCs, GCSamples.Num());
+
+	const TCHAR* BucketNames[3] = { TEXT("idle"), TEXT("light combat"), TEXT("heavy combat") };
+	for (int32 Bucket = 0; Bucket < 3; ++Bucket)
+	{
+		if (Count[Bucket] > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("  %-12s %4d passes  avg %7.2f ms  max %7.2f ms"),
+				BucketNames[Bucket], Count[Bucket], TotalPause[Bucket] / Count[Bucket], MaxPause[Bucket]);
+		}
+	}
+
+	// Pearson correlation between pause length and intensity, undefined while either never varies
+	const double N = GCSamples.Num();
+	const double Denominator = FMath::Sqrt(FMath::Max(N * SumXX - SumX * SumX, 0.0) * FMath::Max(N * SumYY - SumY * SumY, 0.0));
+	if (Denominator > UE_DOUBLE_SMALL_NUMBER)
+	{
+		UE_LOG(LogTemp, Log, TEXT("  Pause/intensity correlation: %.2f"), (N * SumXY - SumX * SumY) / Denominator);
+	}
+}
+
+void UObjectChurnSubsystem::ResetStats()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Entries stay, dropping them would turn later destructions of these classes into untracked ones
+	for (TPair<const UClass*, FClassChurn>& Pair : Classes)
+	{
+		const FName ClassName = Pair.Value.ClassName;
+		Pair.Value = FClassChurn();
+		Pair.Value.ClassName = ClassName;
+	}
+	UntrackedDestroyed = 0;
+	WindowCreated = 0;
+	WindowDestroyed = 0;
+	WindowStart = FPlatformTime::Seconds();
+
+	GCSamples.Reset();
+	NextGCSample = 0;
+	NumGCs = 0;
+}
+
+void UObjectChurnSubsystem::ClusterPooledActor(AActor* Actor)
+{
+	if (!ObjectChurn::AreClustersEnabled() || !Actor || !Actor->CanBeClusterRoot() || Actor->IsActorBeingDestroyed())
+	{
+		return;
+	}
+
+	UWorld* World = Actor->GetWorld();
+	if (!World || World->bIsTearingDown || Actor->HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot))
+	{
+		return;
+	}
+
+	Actor->CreateCluster();
+
+	INC_DWORD_STAT(STAT_ObjectChurn_Clustered);
+}
+
+void UObjectChurnSubsystem::UnclusterPooledActor(AActor* Actor)
+{
+	// Once active its references change every frame, which a cluster doesn't track
+	if (Actor && Actor->HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot))
+	{
+		GUObjectClusters.DissolveCluster(Actor);
+	}
+}
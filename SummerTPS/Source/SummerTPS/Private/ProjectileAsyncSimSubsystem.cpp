@@ -0,0 +1,448 @@
+#include "ProjectileAsyncSimSubsystem.h"
+#include "SummerTPS.h"
+#include "SummerTPSProjectile.h"
+#include "SDFCollisionSubsystem.h"
+#include "EnemyCharacter.h"
+#include "ActorRegistrySubsystem.h"
+#include "CombatClockSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PBDRigidsSolver.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Async Sim Step"), STAT_ProjectileAsyncSim_Step, STATGROUP_SummerTPS);
+DECLARE_CYCLE_STAT(TEXT("Projectile Async Sim Consume"), STAT_ProjectileAsyncSim_Consume, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Async Projectiles"), STAT_ProjectileAsyncSim_Live, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Projectile Hits"), STAT_ProjectileAsyncSim_Hits, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Projectile Handbacks"), STAT_ProjectileAsyncSim_Handbacks, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Projectile Dynamic Hits"), STAT_ProjectileAsyncSim_DynamicHits, STATGROUP_SummerTPS);
+
+namespace ProjectileAsyncSim
+{
+	static bool Enabled = false;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("summer.Projectile.AsyncSim"),
+		Enabled,
+		TEXT("Simulate projectiles inside distance field coverage on the physics thread. Needs Tick Physics Async in the physics settings. Applies to projectiles launched afterwards."));
+}
+
+void FProjectileSimCallback::OnPreSimulate_Internal()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileAsyncSim_Step);
+
+	if (const FProjectileSimInput* Input = GetConsumerInput_Internal())
+	{
+		ApplyInput(*Input);
+	}
+
+	const float Dt = GetDeltaTime_Internal();
+	FProjectileSimOutput& Output = GetProducerOutputData_Internal();
+
+	for (int32 Index = Projectiles.Num() - 1; Index >= 0; --Index)
+	{
+		if (!StepProjectile(Projectiles[Index], Dt, Output))
+		{
+			Projectiles.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	Output.States.Reserve(Projectiles.Num());
+	for (const FSimProjectile& Projectile : Projectiles)
+	{
+		FProjectileSimState& State = Output.States.AddDefaulted_GetRef();
+		State.Id = Projectile.Launch.Id;
+		State.Location = Projectile.Location;
+		State.Velocity = Projectile.Velocity;
+	}
+
+	SET_DWORD_STAT(STAT_ProjectileAsyncSim_Live, Projectiles.Num());
+}
+
+void FProjectileSimCallback::ApplyInput(const FProjectileSimInput& Input)
+{
+	if (Input.SDF)
+	{
+		SDF = Input.SDF;
+	}
+
+	if (Input.bHasTargets)
+	{
+		Targets = Input.Targets;
+	}
+
+	for (const FProjectileSimLaunch& Launch : Input.Launches)
+	{
+		if (Launch.Id <= LastLaunchId)
+		{
+			continue;
+		}
+
+		FSimProjectile& Projectile = Projectiles.AddDefaulted_GetRef();
+		Projectile.Launch = Launch;
+		Projectile.Location = Launch.Location;
+		Projectile.Velocity = Launch.Velocity;
+		LastLaunchId = Launch.Id;
+	}
+
+	for (const int32 Id : Input.Removals)
+	{
+		Projectiles.RemoveAllSwap([Id](const FSimProjectile& Projectile) { return Projectile.Launch.Id == Id; }, false);
+	}
+}
+
+bool FProjectileSimCallback::StepProjectile(FSimProjectile& Projectile, float Dt, FProjectileSimOutput& Output) const
+{
+	const FProjectileSimLaunch& Launch = Projectile.Launch;
+
+	Projectile.Age += Dt;
+	if (Launch.Lifetime > 0.0f && Projectile.Age >= Launch.Lifetime)
+	{
+		FProjectileSimEvent& Event = Output.Events.AddDefaulted_GetRef();
+		Event.Id = Launch.Id;
+		Event.Type = EProjectileSimEvent::Expired;
+		Event.Location = Projectile.Location;
+		Event.Velocity = Projectile.Velocity;
+		return false;
+	}
+
+	// Same integration as USDFCollisionSubsystem::PredictPath, so the aim preview matches the flight
+	const FVector NextVelocity = Projectile.Velocity + FVector(0.0f, 0.0f, Launch.GravityZ * Dt);
+	const FVector NextLocation = Projectile.Location + (Projectile.Velocity + NextVelocity) * (0.5f * Dt);
+	const FVector Segment = NextLocation - Projectile.Location;
+	const float SegmentLengthSq = Segment.SizeSquared();
+
+	// Closest approach of the step to each capsule; at projectile speeds a step is a few dozen cm, close enough to first contact
+	const FProjectileSimTarget* HitTarget = nullptr;
+	FVector TargetPathPoint = FVector::ZeroVector;
+	FVector TargetAxisPoint = FVector::ZeroVector;
+	float TargetTime = TNumericLimits<float>::Max();
+
+	for (const FProjectileSimTarget& Target : Targets)
+	{
+		if (Target.Id == Launch.OwnerId)
+		{
+			continue;
+		}
+
+		const FVector HalfAxis(0.0f, 0.0f, Target.HalfSegment);
+		FVector OnPath, OnAxis;
+		FMath::SegmentDistToSegmentSafe(Projectile.Location, NextLocation, Target.Center - HalfAxis, Target.Center + HalfAxis, OnPath, OnAxis);
+		if (FVector::DistSquared(OnPath, OnAxis) > FMath::Square(Target.Radius + Launch.Radius))
+		{
+			continue;
+		}
+
+		const float Time = SegmentLengthSq > UE_KINDA_SMALL_NUMBER ? ((OnPath - Projectile.Location) | Segment) / SegmentLengthSq : 0.0f;
+		if (Time < TargetTime)
+		{
+			HitTarget = &Target;
+			TargetPathPoint = OnPath;
+			TargetAxisPoint = OnAxis;
+			TargetTime = Time;
+		}
+	}
+
+	FSDFTraceHit StaticHit;
+	const ESDFTraceResult StaticResult = SDF ? SDF->SphereTrace(Projectile.Location, NextLocation, Launch.Radius, StaticHit) : ESDFTraceResult::NoCoverage;
+
+	if (StaticResult == ESDFTraceResult::Hit && (!HitTarget || StaticHit.Time <= TargetTime))
+	{
+		FProjectileSimEvent& Event = Output.Events.AddDefaulted_GetRef();
+		Event.Id = Launch.Id;
+		Event.Type = EProjectileSimEvent::Hit;
+		Event.Location = StaticHit.Location;
+		Event.Velocity = Projectile.Velocity;
+		Event.ImpactPoint = StaticHit.ImpactPoint;
+		Event.ImpactNormal = StaticHit.ImpactNormal;
+		INC_DWORD_STAT(STAT_ProjectileAsyncSim_Hits);
+		return false;
+	}
+
+	if (HitTarget)
+	{
+		const FVector Normal = (TargetPathPoint - TargetAxisPoint).GetSafeNormal(UE_SMALL_NUMBER, -Segment.GetSafeNormal());
+
+		FProjectileSimEvent& Event = Output.Events.AddDefaulted_GetRef();
+		Event.Id = Launch.Id;
+		Event.Type = EProjectileSimEvent::Hit;
+		Event.Location = TargetPathPoint;
+		Event.Velocity = Projectile.Velocity;
+		Event.ImpactPoint = TargetAxisPoint + Normal * HitTarget->Radius;
+		Event.ImpactNormal = Normal;
+		Event.TargetId = HitTarget->Id;
+		INC_DWORD_STAT(STAT_ProjectileAsyncSim_Hits);
+		return false;
+	}
+
+	if (StaticResult == ESDFTraceResult::NoCoverage)
+	{
+		// Handed back from the start of the step, which was still covered, so the game thread sweeps the rest with physics
+		FProjectileSimEvent& Event = Output.Events.AddDefaulted_GetRef();
+		Event.Id = Launch.Id;
+		Event.Type = EProjectileSimEvent::NoCoverage;
+		Event.Location = Projectile.Location;
+		Event.Velocity = Projectile.Velocity;
+		return false;
+	}
+
+	Projectile.Location = NextLocation;
+	Projectile.Velocity = NextVelocity;
+	return true;
+}
+
+UProjectileAsyncSimSubsystem::UProjectileAsyncSimSubsystem()
+{
+	Callback = nullptr;
+	NextId = 0;
+}
+
+void UProjectileAsyncSimSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FPhysScene* PhysScene = InWorld.GetPhysicsScene();
+	Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr;
+	if (!Solver)
+	{
+		return;
+	}
+
+	Callback = Solver->CreateAndRegisterSimCallbackObject_External<FProjectileSimCallback>();
+
+	if (FProjectileSimInput* Input = Callback->GetProducerInputData_External())
+	{
+		Input->SDF = InWorld.GetSubsystem<USDFCollisionSubsystem>();
+	}
+}
+
+void UProjectileAsyncSimSubsystem::Deinitialize()
+{
+	if (Callback)
+	{
+		FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+		if (Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr)
+		{
+			Solver->UnregisterAndFreeSimCallbackObject_External(Callback);
+		}
+		Callback = nullptr;
+	}
+
+	Projectiles.Empty();
+	TargetActors.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UProjectileAsyncSimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UProjectileAsyncSimSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileAsyncSimSubsystem, STATGROUP_Tickables);
+}
+
+bool UProjectileAsyncSimSubsystem::IsAvailable() const
+{
+	if (!ProjectileAsyncSim::Enabled || !Callback)
+	{
+		return false;
+	}
+
+	// Results arrive on wall clock timing, fixed step combat moves projectiles on its own steps instead
+	const UCombatClockSubsystem* Clock = GetWorld()->GetSubsystem<UCombatClockSubsystem>();
+	if (Clock && Clock->IsFixedStep())
+	{
+		return false;
+	}
+
+	// On the synchronous physics tick the steps follow the frame time, which gains nothing over the movement component
+	if (!UPhysicsSettings::Get()->bTickPhysicsAsync)
+	{
+		return false;
+	}
+
+	// Without baked volumes every launch would come straight back
+	const USDFCollisionSubsystem* SDF = GetWorld()->GetSubsystem<USDFCollisionSubsystem>();
+	return SDF && SDF->HasVolumes();
+}
+
+int32 UProjectileAsyncSimSubsystem::Launch(ASummerTPSProjectile* Projectile, const FVector& Velocity, float Radius, float GravityZ, float Lifetime)
+{
+	FProjectileSimInput* Input = Callback ? Callback->GetProducerInputData_External() : nullptr;
+	if (!Projectile || !Input)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Id = NextId++;
+
+	FProjectileSimLaunch& Launch = Input->Launches.AddDefaulted_GetRef();
+	Launch.Id = Id;
+	Launch.Location = Projectile->GetActorLocation();
+	Launch.Velocity = Velocity;
+	Launch.Radius = Radius;
+	Launch.GravityZ = GravityZ;
+	Launch.Lifetime = Lifetime;
+	Launch.OwnerId = Projectile->GetOwner() ? Projectile->GetOwner()->GetUniqueID() : 0;
+
+	Projectiles.Add(Id, Projectile);
+	return Id;
+}
+
+void UProjectileAsyncSimSubsystem::Remove(int32 Id)
+{
+	if (Projectiles.Remove(Id) == 0)
+	{
+		return;
+	}
+
+	if (FProjectileSimInput* Input = Callback ? Callback->GetProducerInputData_External() : nullptr)
+	{
+		Input->Removals.Add(Id);
+	}
+}
+
+void UProjectileAsyncSimSubsystem::Tick(float DeltaTime)
+{
+	if (!Callback)
+	{
+		return;
+	}
+
+	ConsumeOutputs();
+	SendTargets();
+}
+
+void UProjectileAsyncSimSubsystem::SendTargets()
+{
+	FProjectileSimInput* Input = Callback->GetProducerInputData_External();
+	if (!Input)
+	{
+		return;
+	}
+
+	Input->bHasTargets = true;
+	Input->Targets.Reset();
+
+	// Stale entries only cost a map slot until the character is gone
+	for (auto It = TargetActors.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	auto AddTarget = [this, Input](ACharacter* Character)
+	{
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		if (!Capsule || !Capsule->IsCollisionEnabled())
+		{
+			return;
+		}
+
+		FProjectileSimTarget& Target = Input->Targets.AddDefaulted_GetRef();
+		Target.Id = Character->GetUniqueID();
+		Target.Center = Capsule->GetComponentLocation();
+		Target.Radius = Capsule->GetScaledCapsuleRadius();
+		Target.HalfSegment = Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+		TargetActors.Add(Target.Id, Character);
+	};
+
+	if (const UActorRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UActorRegistrySubsystem>())
+	{
+		Registry->ForEachActor<AEnemyCharacter>([&AddTarget](AEnemyCharacter* Enemy)
+		{
+			if (!Enemy->IsPooled() && !Enemy->IsDead())
+			{
+				AddTarget(Enemy);
+			}
+		});
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (ACharacter* Character = PlayerController ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr)
+		{
+			AddTarget(Character);
+		}
+	}
+}
+
+void UProjectileAsyncSimSubsystem::ConsumeOutputs()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileAsyncSim_Consume);
+
+	bool bHasStates = false;
+
+	// Events of every step since the last frame, in order; transforms only from the newest step
+	while (Chaos::TSimCallbackOutputHandle<FProjectileSimOutput> Output = Callback->PopOutputData_External())
+	{
+		for (const FProjectileSimEvent& Event : Output->Events)
+		{
+			HandleEvent(Event);
+		}
+
+		LatestStates = MoveTemp(Output->States);
+		bHasStates = true;
+	}
+
+	if (!bHasStates)
+	{
+		return;
+	}
+
+	for (const FProjectileSimState& State : LatestStates)
+	{
+		ASummerTPSProjectile* Projectile = Projectiles.FindRef(State.Id).Get();
+		if (!Projectile || Projectile->GetAsyncSimId() != State.Id)
+		{
+			continue;
+		}
+
+		// Removes the projectile from the simulation on a hit
+		if (Projectile->SweepDynamicObjects(State.Location))
+		{
+			INC_DWORD_STAT(STAT_ProjectileAsyncSim_DynamicHits);
+			continue;
+		}
+
+		Projectile->SetActorLocationAndRotation(State.Location, State.Velocity.Rotation());
+	}
+}
+
+void UProjectileAsyncSimSubsystem::HandleEvent(const FProjectileSimEvent& Event)
+{
+	TWeakObjectPtr<ASummerTPSProjectile> WeakProjectile;
+	if (!Projectiles.RemoveAndCopyValue(Event.Id, WeakProjectile))
+	{
+		// Removed on the game thread while the step was running
+		return;
+	}
+
+	ASummerTPSProjectile* Projectile = WeakProjectile.Get();
+	if (!Projectile || Projectile->GetAsyncSimId() != Event.Id)
+	{
+		return;
+	}
+
+	// A dynamic or physics body between the last applied transform and the event comes first
+	if (Projectile->SweepDynamicObjects(Event.Location))
+	{
+		INC_DWORD_STAT(STAT_ProjectileAsyncSim_DynamicHits);
+		return;
+	}
+
+	if (Event.Type == EProjectileSimEvent::NoCoverage)
+	{
+		INC_DWORD_STAT(STAT_ProjectileAsyncSim_Handbacks);
+	}
+
+	AActor* HitActor = Event.TargetId != 0 ? TargetActors.FindRef(Event.TargetId).Get() : nullptr;
+	Projectile->OnAsyncSimEvent(Event, HitActor);
+}
@@ -0,0 +1,102 @@
+#include "ProjectilePoolSubsystem.h"
+#include "SummerTPS.h"
+#include "SummerTPSProjectile.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Spawned"), STAT_ProjectilePool_Spawned, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Reused"), STAT_ProjectilePool_Reused, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilePool_InFlight, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Pooled"), STAT_ProjectilePool_Free, STATGROUP_SummerTPS);
+
+void UProjectilePoolSubsystem::Deinitialize()
+{
+	InFlight.Empty();
+	Free.Empty();
+
+	SET_DWORD_STAT(STAT_ProjectilePool_InFlight, 0);
+	SET_DWORD_STAT(STAT_ProjectilePool_Free, 0);
+
+	Super::Deinitialize();
+}
+
+bool UProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ASummerTPSProjectile* UProjectilePoolSubsystem::Acquire(TSubclassOf<ASummerTPSProjectile> Class, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	if (!Class)
+	{
+		return nullptr;
+	}
+
+	for (int32 Index = Free.Num() - 1; Index >= 0; --Index)
+	{
+		ASummerTPSProjectile* Projectile = Free[Index];
+		if (!IsValid(Projectile))
+		{
+			Free.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Projectile->GetClass() == Class)
+		{
+			Free.RemoveAtSwap(Index);
+			Projectile->SetOwner(Owner);
+			Projectile->SetInstigator(Instigator);
+			Projectile->ActivateFromPool(SpawnTransform);
+			InFlight.Add(Projectile);
+
+			INC_DWORD_STAT(STAT_ProjectilePool_Reused);
+			SET_DWORD_STAT(STAT_ProjectilePool_InFlight, InFlight.Num());
+			SET_DWORD_STAT(STAT_ProjectilePool_Free, Free.Num());
+			return Projectile;
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.Instigator = Instigator;
+
+	ASummerTPSProjectile* Projectile = GetWorld()->SpawnActor<ASummerTPSProjectile>(Class, SpawnTransform, SpawnParams);
+	if (Projectile)
+	{
+		InFlight.Add(Projectile);
+
+		INC_DWORD_STAT(STAT_ProjectilePool_Spawned);
+		SET_DWORD_STAT(STAT_ProjectilePool_InFlight, InFlight.Num());
+	}
+	return Projectile;
+}
+
+bool UProjectilePoolSubsystem::Release(ASummerTPSProjectile* Projectile)
+{
+	if (InFlight.RemoveSwap(Projectile) == 0)
+	{
+		return false;
+	}
+
+	Projectile->DeactivateToPool();
+	Free.Add(Projectile);
+
+	SET_DWORD_STAT(STAT_ProjectilePool_InFlight, InFlight.Num());
+	SET_DWORD_STAT(STAT_ProjectilePool_Free, Free.Num());
+	return true;
+}
+
+void UProjectilePoolSubsystem::ReleaseAll()
+{
+	for (ASummerTPSProjectile* Projectile : InFlight)
+	{
+		if (IsValid(Projectile))
+		{
+			Projectile->DeactivateToPool();
+			Free.Add(Projectile);
+		}
+	}
+	InFlight.Reset();
+
+	SET_DWORD_STAT(STAT_ProjectilePool_InFlight, 0);
+	SET_DWORD_STAT(STAT_ProjectilePool_Free, Free.Num());
+}
@@ -0,0 +1,174 @@
+#include "SDFCollisionSubsystem.h"
+#include "SummerTPS.h"
+#include "SDFCollisionVolume.h"
+
+DECLARE_CYCLE_STAT(TEXT("SDF Sphere Trace"), STAT_SDFCollision_SphereTrace, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SDF Traces"), STAT_SDFCollision_Traces, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SDF Trace Steps"), STAT_SDFCollision_Steps, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SDF Traces Without Coverage"), STAT_SDFCollision_NoCoverage, STATGROUP_SummerTPS);
+
+namespace SDFCollision
+{
+	/** Clearance at which a sphere counts as touching, about the 8-bit quantization error of the default band */
+	static constexpr float HitTolerance = 1.0f;
+
+	/** Bound on the number of samples per trace; steps never get shorter than a quarter voxel */
+	static constexpr int32 MaxTraceSteps = 64;
+}
+
+void USDFCollisionSubsystem::RegisterVolume(ASDFCollisionVolume* Volume)
+{
+	if (Volume)
+	{
+		FWriteScopeLock WriteLock(VolumesLock);
+		Volumes.AddUnique(Volume);
+	}
+}
+
+void USDFCollisionSubsystem::UnregisterVolume(ASDFCollisionVolume* Volume)
+{
+	FWriteScopeLock WriteLock(VolumesLock);
+	Volumes.Remove(Volume);
+}
+
+bool USDFCollisionSubsystem::HasCoverage(const FVector& Point) const
+{
+	FReadScopeLock ReadLock(VolumesLock);
+	return FindVolume(Point) != nullptr;
+}
+
+bool USDFCollisionSubsystem::HasVolumes() const
+{
+	FReadScopeLock ReadLock(VolumesLock);
+	return Volumes.Num() > 0;
+}
+
+const ASDFCollisionVolume* USDFCollisionSubsystem::FindVolume(const FVector& Point) const
+{
+	for (const ASDFCollisionVolume* Volume : Volumes)
+	{
+		if (Volume && Volume->Contains(Point))
+		{
+			return Volume;
+		}
+	}
+	return nullptr;
+}
+
+bool USDFCollisionSubsystem::SampleDistance(const FVector& Point, float& OutDistance) const
+{
+	FReadScopeLock ReadLock(VolumesLock);
+	const ASDFCollisionVolume* Volume = FindVolume(Point);
+	if (!Volume)
+	{
+		return false;
+	}
+
+	OutDistance = Volume->SampleDistance(Point);
+	return true;
+}
+
+bool USDFCollisionSubsystem::SampleDistanceAndNormal(const FVector& Point, float& OutDistance, FVector& OutNormal) const
+{
+	FReadScopeLock ReadLock(VolumesLock);
+	const ASDFCollisionVolume* Volume = FindVolume(Point);
+	if (!Volume)
+	{
+		return false;
+	}
+
+	FVector Gradient;
+	OutDistance = Volume->SampleDistanceAndGradient(Point, Gradient);
+	OutNormal = Gradient.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+	return true;
+}
+
+ESDFTraceResult USDFCollisionSubsystem::SphereTrace(const FVector& Start, const FVector& End, float Radius, FSDFTraceHit& OutHit) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_SDFCollision_SphereTrace);
+	INC_DWORD_STAT(STAT_SDFCollision_Traces);
+
+	FReadScopeLock ReadLock(VolumesLock);
+
+	const FVector Delta = End - Start;
+	const float Length = Delta.Size();
+	const FVector Direction = Length > UE_KINDA_SMALL_NUMBER ? Delta / Length : FVector::ZeroVector;
+
+	const ASDFCollisionVolume* Volume = nullptr;
+	float Travelled = 0.0f;
+
+	for (int32 Step = 0; Step < SDFCollision::MaxTraceSteps; ++Step)
+	{
+		INC_DWORD_STAT(STAT_SDFCollision_Steps);
+
+		const FVector Position = Start + Direction * Travelled;
+		if (!Volume || !Volume->Contains(Position))
+		{
+			Volume = FindVolume(Position);
+			if (!Volume)
+			{
+				INC_DWORD_STAT(STAT_SDFCollision_NoCoverage);
+				return ESDFTraceResult::NoCoverage;
+			}
+		}
+
+		const float Clearance = Volume->SampleDistance(Position) - Radius;
+		if (Clearance <= SDFCollision::HitTolerance)
+		{
+			FVector Gradient;
+			const float SurfaceDistance = Volume->SampleDistanceAndGradient(Position, Gradient);
+
+			OutHit.Location = Position;
+			OutHit.ImpactNormal = Gradient.GetSafeNormal(UE_SMALL_NUMBER, -Direction);
+			OutHit.ImpactPoint = Position - OutHit.ImpactNormal * SurfaceDistance;
+			OutHit.Time = Length > UE_KINDA_SMALL_NUMBER ? Travelled / Length : 0.0f;
+			return ESDFTraceResult::Hit;
+		}
+
+		if (Travelled >= Length)
+		{
+			return ESDFTraceResult::Miss;
+		}
+
+		// The sphere can safely advance by its clearance, the minimum step keeps grazing traces from stalling
+		Travelled = FMath::Min(Travelled + FMath::Max(Clearance, Volume->GetVoxelSize() * 0.25f), Length);
+	}
+
+	// Out of steps before reaching the end: let physics finish the segment rather than skip geometry
+	INC_DWORD_STAT(STAT_SDFCollision_NoCoverage);
+	return ESDFTraceResult::NoCoverage;
+}
+
+ESDFTraceResult USDFCollisionSubsystem::PredictPath(const FVector& Start, const FVector& LaunchVelocity, float Radius, float MaxSimTime, float SimFrequency, float GravityZ, TArray<FVector, FFrameArenaAllocator>& OutPath, FSDFTraceHit& OutHit) const
+{
+	OutPath.Reset();
+	OutPath.Add(Start);
+
+	const float StepTime = 1.0f / FMath::Max(SimFrequency, 1.0f);
+	FVector Position = Start;
+	FVector Velocity = LaunchVelocity;
+
+	for (float SimTime = 0.0f; SimTime < MaxSimTime; SimTime += StepTime)
+	{
+		const float Dt = FMath::Min(StepTime, MaxSimTime - SimTime);
+		const FVector NextVelocity = Velocity + FVector(0.0f, 0.0f, GravityZ * Dt);
+		const FVector NextPosition = Position + (Velocity + NextVelocity) * (0.5f * Dt);
+
+		const ESDFTraceResult Result = SphereTrace(Position, NextPosition, Radius, OutHit);
+		if (Result == ESDFTraceResult::NoCoverage)
+		{
+			return Result;
+		}
+		if (Result == ESDFTraceResult::Hit)
+		{
+			OutPath.Add(OutHit.Location);
+			return Result;
+		}
+
+		OutPath.Add(NextPosition);
+		Position = NextPosition;
+		Velocity = NextVelocity;
+	}
+
+	return ESDFTraceResult::Miss;
+}
@@ -0,0 +1,312 @@
+#include "SDFCollisionVolume.h"
+#include "SDFCollisionSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+
+namespace SDFCollision
+{
+	/**
+	 * Trilinear interpolation of the 8 voxel corners (index = x + 2y + 4z), four lanes at a time.
+	 * The gradient falls out of the same lane differences, in distance per voxel.
+	 */
+	static float Trilinear(const float Corners[8], const FVector& Fraction, FVector* OutGradient)
+	{
+		// Lanes: (y0z0, y1z0, y0z1, y1z1) at x = 0 and x = 1
+		const VectorRegister4Float X0 = MakeVectorRegisterFloat(Corners[0], Corners[2], Corners[4], Corners[6]);
+		const VectorRegister4Float X1 = MakeVectorRegisterFloat(Corners[1], Corners[3], Corners[5], Corners[7]);
+		const VectorRegister4Float DX = VectorSubtract(X1, X0);
+		const VectorRegister4Float AlongX = VectorMultiplyAdd(DX, VectorSetFloat1((float)Fraction.X), X0);
+
+		// Lanes: (z0, z1, z0, z1) at y = 0 and y = 1
+		const VectorRegister4Float Y0 = VectorSwizzle(AlongX, 0, 2, 0, 2);
+		const VectorRegister4Float Y1 = VectorSwizzle(AlongX, 1, 3, 1, 3);
+		const VectorRegister4Float DY = VectorSubtract(Y1, Y0);
+		const VectorRegister4Float FY = VectorSetFloat1((float)Fraction.Y);
+
+		alignas(16) float AlongY[4];
+		VectorStoreAligned(VectorMultiplyAdd(DY, FY, Y0), AlongY);
+
+		if (OutGradient)
+		{
+			const VectorRegister4Float DXY0 = VectorSwizzle(DX, 0, 2, 0, 2);
+			const VectorRegister4Float DXY1 = VectorSwizzle(DX, 1, 3, 1, 3);
+
+			alignas(16) float GradX[4];
+			alignas(16) float GradY[4];
+			VectorStoreAligned(VectorMultiplyAdd(VectorSubtract(DXY1, DXY0), FY, DXY0), GradX);
+			VectorStoreAligned(DY, GradY);
+
+			*OutGradient = FVector(
+				FMath::Lerp(GradX[0], GradX[1], (float)Fraction.Z),
+				FMath::Lerp(GradY[0], GradY[1], (float)Fraction.Z),
+				AlongY[1] - AlongY[0]);
+		}
+
+		return FMath::Lerp(AlongY[0], AlongY[1], (float)Fraction.Z);
+	}
+}
+
+ASDFCollisionVolume::ASDFCollisionVolume()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	Bounds->InitBoxExtent(FVector(5000.0f, 5000.0f, 1000.0f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetMobility(EComponentMobility::Static);
+	RootComponent = Bounds;
+
+	VoxelSize = 50.0f;
+	BrickResolution = 8;
+	MaxDistance = 200.0f;
+	BakeObjectTypes.Add(ECC_WorldStatic);
+
+	BakedOrigin = FVector::ZeroVector;
+	BrickCounts = FIntVector::ZeroValue;
+	BakedVoxelSize = VoxelSize;
+	BakedBrickResolution = BrickResolution;
+	BakedMaxDistance = MaxDistance;
+	bBakedCompleteCoverage = false;
+}
+
+void ASDFCollisionVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!HasBakedData())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SDFCollisionVolume %s has no baked data, projectiles fall back to physics"), *GetName());
+		return;
+	}
+
+	// Projectiles ignore physics static collision inside registered volumes, so a hole in the field would be a hole in the level
+	if (!bBakedCompleteCoverage)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SDFCollisionVolume %s doesn't cover all its static geometry (see the bake log, or bake again), projectiles fall back to physics"), *GetName());
+		return;
+	}
+
+	if (USDFCollisionSubsystem* SDF = GetWorld()->GetSubsystem<USDFCollisionSubsystem>())
+	{
+		SDF->RegisterVolume(this);
+	}
+}
+
+void ASDFCollisionVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USDFCollisionSubsystem* SDF = GetWorld()->GetSubsystem<USDFCollisionSubsystem>())
+	{
+		SDF->UnregisterVolume(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASDFCollisionVolume::Bake()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	Modify();
+
+	BakedVoxelSize = VoxelSize;
+	BakedBrickResolution = BrickResolution;
+	BakedMaxDistance = MaxDistance;
+
+	const FBox Box = Bounds->Bounds.GetBox();
+	const float BrickWorldSize = BakedVoxelSize * BakedBrickResolution;
+	const FVector Size = Box.GetSize();
+
+	BakedOrigin = Box.Min;
+	BrickCounts = FIntVector(
+		FMath::Max(1, FMath::CeilToInt(Size.X / BrickWorldSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Y / BrickWorldSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Z / BrickWorldSize)));
+
+	BrickTable.Init(INDEX_NONE, BrickCounts.X * BrickCounts.Y * BrickCounts.Z);
+	BrickSamples.Reset();
+
+	FCollisionObjectQueryParams ObjectParams;
+	for (const TEnumAsByte<ECollisionChannel>& ObjectType : BakeObjectTypes)
+	{
+		ObjectParams.AddObjectTypesToQuery(ObjectType);
+	}
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SDFCollisionBake), false, this);
+
+	const int32 SamplesPerEdge = BakedBrickResolution + 1;
+	const int32 SamplesPerBrick = GetSamplesPerBrick();
+	const FVector BrickExtent(BrickWorldSize * 0.5f);
+
+	TArray<FOverlapResult> Overlaps;
+	TArray<UPrimitiveComponent*> Primitives;
+	int32 NumStoredBricks = 0;
+
+	// Non-static primitives and primitives without simple collision (e.g. complex as simple meshes) can't be baked
+	TSet<const UPrimitiveComponent*> SkippedPrimitives;
+
+	for (int32 BrickZ = 0; BrickZ < BrickCounts.Z; ++BrickZ)
+	{
+		for (int32 BrickY = 0; BrickY < BrickCounts.Y; ++BrickY)
+		{
+			for (int32 BrickX = 0; BrickX < BrickCounts.X; ++BrickX)
+			{
+				const FVector BrickMin = BakedOrigin + FVector(BrickX, BrickY, BrickZ) * BrickWorldSize;
+
+				// Anything within the band of the brick box can influence its samples
+				Overlaps.Reset();
+				World->OverlapMultiByObjectType(Overlaps, BrickMin + BrickExtent, FQuat::Identity, ObjectParams, FCollisionShape::MakeBox(BrickExtent + FVector(BakedMaxDistance)), QueryParams);
+
+				Primitives.Reset();
+				for (const FOverlapResult& Overlap : Overlaps)
+				{
+					UPrimitiveComponent* Primitive = Overlap.GetComponent();
+					if (!Primitive)
+					{
+						continue;
+					}
+
+					if (Primitive->Mobility == EComponentMobility::Static)
+					{
+						Primitives.AddUnique(Primitive);
+					}
+					else if (!SkippedPrimitives.Contains(Primitive))
+					{
+						SkippedPrimitives.Add(Primitive);
+						UE_LOG(LogTemp, Warning, TEXT("SDFCollisionVolume %s: %s is not Static and can't be baked"), *GetName(), *Primitive->GetReadableName());
+					}
+				}
+
+				if (Primitives.Num() == 0)
+				{
+					continue;
+				}
+
+				BrickTable[(BrickZ * BrickCounts.Y + BrickY) * BrickCounts.X + BrickX] = NumStoredBricks++;
+				uint8* Samples = &BrickSamples[BrickSamples.AddUninitialized(SamplesPerBrick)];
+
+				for (int32 Z = 0; Z < SamplesPerEdge; ++Z)
+				{
+					for (int32 Y = 0; Y < SamplesPerEdge; ++Y)
+					{
+						for (int32 X = 0; X < SamplesPerEdge; ++X)
+						{
+							const FVector SamplePoint = BrickMin + FVector(X, Y, Z) * BakedVoxelSize;
+
+							// Physics reports 0 inside a body, so the field is clamped at the surface instead of going negative
+							float Distance = BakedMaxDistance;
+							for (UPrimitiveComponent* Primitive : Primitives)
+							{
+								FVector ClosestPoint;
+								const float PrimitiveDistance = Primitive->GetDistanceToCollision(SamplePoint, ClosestPoint);
+								if (PrimitiveDistance >= 0.0f)
+								{
+									Distance = FMath::Min(Distance, PrimitiveDistance);
+								}
+								else if (!SkippedPrimitives.Contains(Primitive))
+								{
+									SkippedPrimitives.Add(Primitive);
+									UE_LOG(LogTemp, Warning, TEXT("SDFCollisionVolume %s: %s has no simple collision to sample"),
+										*GetName(), *Primitive->GetReadableName());
+								}
+							}
+
+							Samples[(Z * SamplesPerEdge + Y) * SamplesPerEdge + X] = (uint8)FMath::RoundToInt(FMath::Clamp(Distance / BakedMaxDistance, 0.0f, 1.0f) * 255.0f);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SDFCollisionVolume %s: baked %d of %d bricks (%.1f KB)"), *GetName(), NumStoredBricks, BrickTable.Num(),
+		(BrickSamples.Num() * sizeof(uint8) + BrickTable.Num() * sizeof(int32)) / 1024.0f);
+
+	bBakedCompleteCoverage = SkippedPrimitives.Num() == 0;
+	if (!bBakedCompleteCoverage)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SDFCollisionVolume %s: %d primitives were skipped, the volume stays unused in play until they are fixed or moved out of it"),
+			*GetName(), SkippedPrimitives.Num());
+	}
+}
+
+void ASDFCollisionVolume::ClearBakedData()
+{
+	Modify();
+
+	BrickTable.Empty();
+	BrickSamples.Empty();
+	BrickCounts = FIntVector::ZeroValue;
+	bBakedCompleteCoverage = false;
+}
+
+bool ASDFCollisionVolume::Contains(const FVector& Point) const
+{
+	if (!HasBakedData())
+	{
+		return false;
+	}
+
+	const FVector BakedSize = FVector(BrickCounts) * (BakedVoxelSize * BakedBrickResolution);
+	return FBox(BakedOrigin, BakedOrigin + BakedSize).IsInsideOrOn(Point);
+}
+
+float ASDFCollisionVolume::DecodeSample(int32 BrickIndex, int32 X, int32 Y, int32 Z) const
+{
+	const int32 SamplesPerEdge = BakedBrickResolution + 1;
+	return BrickSamples[BrickIndex * GetSamplesPerBrick() + (Z * SamplesPerEdge + Y) * SamplesPerEdge + X] * (BakedMaxDistance / 255.0f);
+}
+
+void ASDFCollisionVolume::GatherCorners(const FVector& Point, float OutCorners[8], FVector& OutFraction) const
+{
+	const FVector Local = (Point - BakedOrigin) / BakedVoxelSize;
+	const FIntVector MaxVoxel = BrickCounts * BakedBrickResolution - FIntVector(1);
+
+	const FIntVector Voxel(
+		FMath::Clamp(FMath::FloorToInt(Local.X), 0, MaxVoxel.X),
+		FMath::Clamp(FMath::FloorToInt(Local.Y), 0, MaxVoxel.Y),
+		FMath::Clamp(FMath::FloorToInt(Local.Z), 0, MaxVoxel.Z));
+
+	OutFraction = (Local - FVector(Voxel)).BoundToBox(FVector::ZeroVector, FVector::OneVector);
+
+	const FIntVector Brick = Voxel / BakedBrickResolution;
+	const FIntVector InBrick = Voxel - Brick * BakedBrickResolution;
+	const int32 BrickIndex = BrickTable[(Brick.Z * BrickCounts.Y + Brick.Y) * BrickCounts.X + Brick.X];
+
+	if (BrickIndex == INDEX_NONE)
+	{
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			OutCorners[Corner] = BakedMaxDistance;
+		}
+		return;
+	}
+
+	// The apron sample row means InBrick + 1 is always inside the same brick
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		OutCorners[Corner] = DecodeSample(BrickIndex, InBrick.X + (Corner & 1), InBrick.Y + ((Corner >> 1) & 1), InBrick.Z + ((Corner >> 2) & 1));
+	}
+}
+
+float ASDFCollisionVolume::SampleDistance(const FVector& Point) const
+{
+	float Corners[8];
+	FVector Fraction;
+	GatherCorners(Point, Corners, Fraction);
+	return SDFCollision::Trilinear(Corners, Fraction, nullptr);
+}
+
+float ASDFCollisionVolume::SampleDistanceAndGradient(const FVector& Point, FVector& OutGradient) const
+{
+	float Corners[8];
+	FVector Fraction;
+	GatherCorners(Point, Corners, Fraction);
+
+	const float Distance = SDFCollision::Trilinear(Corners, Fraction, &OutGradient);
+	OutGradient /= BakedVoxelSize;
+	return Distance;
+}
@@ -0,0 +1,271 @@
+#include "SplashDecalSubsystem.h"
+#include "SummerTPS.h"
+#include "Components/DecalComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Splash Decal Add"), STAT_SplashDecal_Add, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Splash Decals Placed"), STAT_SplashDecal_Placed, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Splash Decals Merged"), STAT_SplashDecal_Merged, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Splash Decals Recycled"), STAT_SplashDecal_Recycled, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Splash Decals Live"), STAT_SplashDecal_Live, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Splash Decal Capacity"), STAT_SplashDecal_Capacity, STATGROUP_SummerTPS);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Splash Decal Recycles / s"), STAT_SplashDecal_RecycleRate, STATGROUP_SummerTPS);
+
+namespace SplashDecal
+{
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("summer.Decals.Report"),
+		TEXT("Prints the splash decal ring capacity, live decals and merge and recycle counts."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			if (const USplashDecalSubsystem* Decals = World ? World->GetSubsystem<USplashDecalSubsystem>() : nullptr)
+			{
+				Decals->ReportStats();
+			}
+		}));
+}
+
+USplashDecalSubsystem::USplashDecalSubsystem()
+{
+	Capacity = 96;
+	MaxDecalsPerSurface = 12;
+	SurfaceCellSize = 500.0f;
+	MergeDistanceRatio = 0.5f;
+	MergeGrowth = 0.1f;
+	MaxMergedScale = 1.6f;
+	FadeStartDelay = 6.0f;
+	FadeDuration = 2.0f;
+
+	NextSlot = 0;
+	NumLive = 0;
+	NextExpireTime = TNumericLimits<double>::Max();
+	NumPlaced = 0;
+	NumMerged = 0;
+	NumRecycled = 0;
+	WindowRecycled = 0;
+	WindowStart = 0.0;
+	RecyclesPerSecond = 0.0f;
+}
+
+void USplashDecalSubsystem::Deinitialize()
+{
+	for (UDecalComponent* Decal : Components)
+	{
+		if (Decal)
+		{
+			Decal->DestroyComponent();
+		}
+	}
+	Components.Empty();
+	Slots.Empty();
+
+	SET_DWORD_STAT(STAT_SplashDecal_Live, 0);
+	SET_DWORD_STAT(STAT_SplashDecal_Capacity, 0);
+
+	Super::Deinitialize();
+}
+
+bool USplashDecalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USplashDecalSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USplashDecalSubsystem, STATGROUP_Tickables);
+}
+
+void USplashDecalSubsystem::CreateSlots()
+{
+	Components.Reserve(Capacity);
+	Slots.SetNum(Capacity);
+
+	for (int32 Index = 0; Index < Capacity; ++Index)
+	{
+		UDecalComponent* Decal = NewObject<UDecalComponent>(this);
+		Decal->SetVisibility(false);
+		Decal->RegisterComponentWithWorld(GetWorld());
+		Components.Add(Decal);
+	}
+
+	SET_DWORD_STAT(STAT_SplashDecal_Capacity, Capacity);
+}
+
+void USplashDecalSubsystem::AddSplash(UMaterialInterface* Material, const FVector& Location, const FVector& Normal, float Size, const UPrimitiveComponent* Surface)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SplashDecal_Add);
+
+	if (!Material || Size <= 0.0f)
+	{
+		return;
+	}
+
+	if (Components.Num() == 0)
+	{
+		CreateSlots();
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	FSurfaceKey SurfaceKey;
+	SurfaceKey.Component = Surface;
+	SurfaceKey.Cell = FIntVector(
+		FMath::FloorToInt(Location.X / SurfaceCellSize),
+		FMath::FloorToInt(Location.Y / SurfaceCellSize),
+		FMath::FloorToInt(Location.Z / SurfaceCellSize));
+
+	// A linear pass over the ring is cheap at its size and impact rates, and finds everything a placement needs
+	int32 MergeIndex = INDEX_NONE;
+	int32 OldestOnSurface = INDEX_NONE;
+	int32 NumOnSurface = 0;
+	const float MergeDistanceSq = FMath::Square(Size * MergeDistanceRatio);
+
+	for (int32 Index = 0; Index < Slots.Num(); ++Index)
+	{
+		const FDecalSlot& Slot = Slots[Index];
+		if (Slot.ExpireTime < 0.0 || !(Slot.Surface == SurfaceKey))
+		{
+			continue;
+		}
+
+		NumOnSurface++;
+		if (OldestOnSurface == INDEX_NONE || Slot.PlacedTime < Slots[OldestOnSurface].PlacedTime)
+		{
+			OldestOnSurface = Index;
+		}
+
+		if (MergeIndex == INDEX_NONE && Slot.Material == TObjectKey<UMaterialInterface>(Material)
+			&& FVector::DistSquared(Slot.Location, Location) <= MergeDistanceSq && (Slot.Normal | Normal) > 0.9f)
+		{
+			MergeIndex = Index;
+		}
+	}
+
+	if (MergeIndex != INDEX_NONE)
+	{
+		FDecalSlot& Slot = Slots[MergeIndex];
+		Slot.Size = FMath::Min(Slot.Size * (1.0f + MergeGrowth), Slot.BaseSize * MaxMergedScale);
+		ApplySlot(MergeIndex, Now, false);
+
+		NumMerged++;
+		INC_DWORD_STAT(STAT_SplashDecal_Merged);
+		return;
+	}
+
+	int32 Index;
+	if (NumOnSurface >= MaxDecalsPerSurface)
+	{
+		Index = OldestOnSurface;
+	}
+	else
+	{
+		Index = NextSlot;
+		NextSlot = (NextSlot + 1) % Slots.Num();
+	}
+
+	FDecalSlot& Slot = Slots[Index];
+	if (Slot.ExpireTime >= 0.0)
+	{
+		NumRecycled++;
+		WindowRecycled++;
+		INC_DWORD_STAT(STAT_SplashDecal_Recycled);
+	}
+	else
+	{
+		NumLive++;
+	}
+
+	Slot.Surface = SurfaceKey;
+	Slot.Material = Material;
+	Slot.Location = Location;
+	Slot.Normal = Normal;
+	Slot.BaseSize = Size;
+	Slot.Size = Size;
+	Slot.PlacedTime = Now;
+
+	UDecalComponent* Decal = Components[Index];
+	Decal->SetDecalMaterial(Material);
+	ApplySlot(Index, Now, true);
+
+	NumPlaced++;
+	INC_DWORD_STAT(STAT_SplashDecal_Placed);
+	SET_DWORD_STAT(STAT_SplashDecal_Live, NumLive);
+}
+
+void USplashDecalSubsystem::ApplySlot(int32 Index, double Now, bool bNewPlacement)
+{
+	FDecalSlot& Slot = Slots[Index];
+	UDecalComponent* Decal = Components[Index];
+
+	if (bNewPlacement)
+	{
+		// Decals project along their X axis; a random roll keeps repeated splashes from looking stamped
+		FRotator Rotation = (-Slot.Normal).Rotation();
+		Rotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+		Decal->SetWorldLocationAndRotation(Slot.Location, Rotation);
+	}
+
+	// Thin along the projection axis so the splash doesn't bleed onto geometry behind the surface
+	Decal->DecalSize = FVector(Slot.Size * 0.5f, Slot.Size, Slot.Size);
+
+	// Recreating the render state restarts the renderer-side fade from now
+	Decal->SetFadeOut(FadeStartDelay, FadeDuration, false);
+	Decal->SetVisibility(true);
+	Decal->MarkRenderStateDirty();
+
+	Slot.ExpireTime = Now + FadeStartDelay + FadeDuration;
+	NextExpireTime = FMath::Min(NextExpireTime, Slot.ExpireTime);
+}
+
+void USplashDecalSubsystem::Tick(float DeltaTime)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	if (Now >= NextExpireTime)
+	{
+		HideExpired(Now);
+	}
+
+	if (Now - WindowStart >= 1.0)
+	{
+		RecyclesPerSecond = WindowRecycled / (float)(Now - WindowStart);
+		WindowRecycled = 0;
+		WindowStart = Now;
+		SET_FLOAT_STAT(STAT_SplashDecal_RecycleRate, RecyclesPerSecond);
+	}
+}
+
+void USplashDecalSubsystem::HideExpired(double Now)
+{
+	NextExpireTime = TNumericLimits<double>::Max();
+
+	for (int32 Index = 0; Index < Slots.Num(); ++Index)
+	{
+		FDecalSlot& Slot = Slots[Index];
+		if (Slot.ExpireTime < 0.0)
+		{
+			continue;
+		}
+
+		if (Now >= Slot.ExpireTime)
+		{
+			Slot.ExpireTime = -1.0;
+			Components[Index]->SetVisibility(false);
+			NumLive--;
+		}
+		else
+		{
+			NextExpireTime = FMath::Min(NextExpireTime, Slot.ExpireTime);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_SplashDecal_Live, NumLive);
+}
+
+void USplashDecalSubsystem::ReportStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("Splash decals: capacity %d (%s), %d live, %llu placed, %llu merged, %llu recycled, %.1f recycles/s"),
+		Capacity, Components.Num() > 0 ? TEXT("allocated") : TEXT("not allocated yet"), NumLive, NumPlaced, NumMerged, NumRecycled, RecyclesPerSecond);
+}
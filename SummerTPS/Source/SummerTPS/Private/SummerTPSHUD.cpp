@@ -0,0 +1,299 @@
+#include "SummerTPSHUD.h"
+#include "SummerTPS.h"
+#include "SummerTPSHUDViewModel.h"
+#include "HitMarkerWidget.h"
+#include "DamageNumberWidget.h"
+#include "TPSPlayer.h"
+#include "HealthComponent.h"
+#include "Blueprint/UserWidget.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("HUD Tick"), STAT_SummerTPSHUD_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HUD Damage Numbers Shown"), STAT_SummerTPSHUD_NumbersShown, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("HUD Damage Numbers Dropped"), STAT_SummerTPSHUD_NumbersDropped, STATGROUP_SummerTPS);
+
+ASummerTPSHUD::ASummerTPSHUD()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	HitMarkerPoolSize = 3;
+	HitMarkerDuration = 0.25f;
+	DamageNumberPoolSize = 24;
+	DamageNumberDuration = 0.8f;
+	DamageNumberOffset = FVector(0.0f, 0.0f, 100.0f);
+
+	NextHitMarker = 0;
+	NextDamageNumber = 0;
+	PendingHits = 0;
+	bPendingKill = false;
+}
+
+void ASummerTPSHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ViewModel = NewObject<USummerTPSHUDViewModel>(this);
+
+	if (!PlayerOwner || !PlayerOwner->IsLocalController())
+	{
+		return;
+	}
+
+	if (OverlayWidgetClass)
+	{
+		OverlayWidget = CreateWidget<UUserWidget>(PlayerOwner, OverlayWidgetClass);
+		if (OverlayWidget)
+		{
+			OverlayWidget->AddToViewport();
+		}
+	}
+
+	// Created once and kept in the viewport, showing one only toggles its visibility
+	if (HitMarkerClass)
+	{
+		for (int32 Index = 0; Index < HitMarkerPoolSize; ++Index)
+		{
+			if (UHitMarkerWidget* Marker = CreateWidget<UHitMarkerWidget>(PlayerOwner, HitMarkerClass))
+			{
+				Marker->AddToViewport(1);
+				Marker->SetVisibility(ESlateVisibility::Collapsed);
+				HitMarkers.Add(Marker);
+				HitMarkerExpireTimes.Add(-1.0);
+			}
+		}
+	}
+
+	if (DamageNumberClass)
+	{
+		for (int32 Index = 0; Index < DamageNumberPoolSize; ++Index)
+		{
+			if (UDamageNumberWidget* Number = CreateWidget<UDamageNumberWidget>(PlayerOwner, DamageNumberClass))
+			{
+				Number->AddToViewport(1);
+				Number->SetAlignmentInViewport(FVector2D(0.5f, 0.5f));
+				Number->SetVisibility(ESlateVisibility::Collapsed);
+				DamageNumbers.Add(Number);
+				DamageNumberAnchors.Add(FVector::ZeroVector);
+				DamageNumberExpireTimes.Add(-1.0);
+			}
+		}
+	}
+
+	PendingDamage.Reserve(DamageNumbers.Num());
+
+	PlayerOwner->OnPossessedPawnChanged.AddDynamic(this, &ASummerTPSHUD::HandlePossessedPawnChanged);
+	BindPlayer(Cast<ATPSPlayer>(PlayerOwner->GetPawn()));
+}
+
+void ASummerTPSHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnbindPlayer();
+
+	if (PlayerOwner)
+	{
+		PlayerOwner->OnPossessedPawnChanged.RemoveDynamic(this, &ASummerTPSHUD::HandlePossessedPawnChanged);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASummerTPSHUD::HandlePossessedPawnChanged(APawn* OldPawn, APawn* NewPawn)
+{
+	BindPlayer(Cast<ATPSPlayer>(NewPawn));
+}
+
+void ASummerTPSHUD::BindPlayer(ATPSPlayer* Player)
+{
+	if (BoundPlayer.Get() == Player)
+	{
+		return;
+	}
+
+	UnbindPlayer();
+	if (!Player)
+	{
+		return;
+	}
+
+	BoundPlayer = Player;
+
+	if (UHealthComponent* HealthComp = Player->GetHealthComponent())
+	{
+		HealthComp->OnHealthChanged.AddDynamic(this, &ASummerTPSHUD::HandleHealthChanged);
+	}
+
+	FiredHandle = Player->OnFired.AddWeakLambda(this, [this](ATPSPlayer*) { ViewModel->AddShot(); });
+	WaterChangedHandle = Player->OnWaterChanged.AddWeakLambda(this, [this](ATPSPlayer* Changed)
+	{
+		ViewModel->SetWater(Changed->GetWater(), Changed->UsesWater() ? Changed->GetMaxWater() : 0.0f);
+	});
+	CoverChangedHandle = Player->OnCoverChanged.AddWeakLambda(this, [this](ATPSPlayer* Changed) { ViewModel->SetCovered(Changed->IsCovered()); });
+	RevivedHandle = Player->OnRevived.AddUObject(this, &ASummerTPSHUD::RefreshFromPlayer);
+
+	RefreshFromPlayer(Player);
+	ViewModel->MarkAllDirty();
+}
+
+void ASummerTPSHUD::UnbindPlayer()
+{
+	ATPSPlayer* Player = BoundPlayer.Get();
+	BoundPlayer.Reset();
+	if (!Player)
+	{
+		return;
+	}
+
+	if (UHealthComponent* HealthComp = Player->GetHealthComponent())
+	{
+		HealthComp->OnHealthChanged.RemoveDynamic(this, &ASummerTPSHUD::HandleHealthChanged);
+	}
+
+	Player->OnFired.Remove(FiredHandle);
+	Player->OnWaterChanged.Remove(WaterChangedHandle);
+	Player->OnCoverChanged.Remove(CoverChangedHandle);
+	Player->OnRevived.Remove(RevivedHandle);
+}
+
+void ASummerTPSHUD::RefreshFromPlayer(ATPSPlayer* Player)
+{
+	if (const UHealthComponent* HealthComp = Player->GetHealthComponent())
+	{
+		ViewModel->SetHealth(HealthComp->GetHealth(), HealthComp->GetDefaultHealth(), Player->IsDead());
+	}
+	ViewModel->SetWater(Player->GetWater(), Player->UsesWater() ? Player->GetMaxWater() : 0.0f);
+	ViewModel->SetCovered(Player->IsCovered());
+}
+
+void ASummerTPSHUD::HandleHealthChanged(UHealthComponent* OwningHealthComp, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser)
+{
+	ViewModel->SetHealth(Health, OwningHealthComp->GetDefaultHealth(), OwningHealthComp->IsDead());
+}
+
+void ASummerTPSHUD::NotifyDamageDealt(AActor* Victim, float Damage, bool bKilled)
+{
+	if (!Victim || (HitMarkers.Num() == 0 && DamageNumbers.Num() == 0))
+	{
+		return;
+	}
+
+	PendingHits++;
+	bPendingKill |= bKilled;
+
+	// Direct hit and splash on the same victim in one frame show as one number
+	FPendingDamage* Pending = PendingDamage.FindByPredicate([Victim](const FPendingDamage& Entry) { return Entry.Victim.Get() == Victim; });
+	if (!Pending)
+	{
+		Pending = &PendingDamage.AddDefaulted_GetRef();
+		Pending->Victim = Victim;
+	}
+
+	Pending->Location = Victim->GetActorLocation() + DamageNumberOffset;
+	Pending->Damage += Damage;
+	Pending->bKilled |= bKilled;
+}
+
+void ASummerTPSHUD::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SummerTPSHUD_Tick);
+
+	Super::Tick(DeltaSeconds);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	ShowPendingDamage(Now);
+	UpdateWidgets(Now);
+
+	if (ViewModel)
+	{
+		ViewModel->Flush();
+	}
+}
+
+void ASummerTPSHUD::ShowPendingDamage(double Now)
+{
+	if (PendingHits == 0)
+	{
+		return;
+	}
+
+	// One marker per frame whatever the hit count, the widget gets the count to scale itself
+	if (HitMarkers.Num() > 0)
+	{
+		UHitMarkerWidget* Marker = HitMarkers[NextHitMarker];
+		Marker->SetVisibility(ESlateVisibility::HitTestInvisible);
+		Marker->OnShow(PendingHits, bPendingKill);
+		HitMarkerExpireTimes[NextHitMarker] = Now + HitMarkerDuration;
+		NextHitMarker = (NextHitMarker + 1) % HitMarkers.Num();
+	}
+
+	if (DamageNumbers.Num() > 0)
+	{
+		if (PendingDamage.Num() > DamageNumbers.Num())
+		{
+			PendingDamage.Sort([](const FPendingDamage& A, const FPendingDamage& B) { return A.Damage > B.Damage; });
+			INC_DWORD_STAT_BY(STAT_SummerTPSHUD_NumbersDropped, PendingDamage.Num() - DamageNumbers.Num());
+		}
+
+		const int32 NumToShow = FMath::Min(PendingDamage.Num(), DamageNumbers.Num());
+		for (int32 Index = 0; Index < NumToShow; ++Index)
+		{
+			const FPendingDamage& Pending = PendingDamage[Index];
+
+			// Ring order, so a full pool recycles the number that has been up the longest
+			UDamageNumberWidget* Number = DamageNumbers[NextDamageNumber];
+			DamageNumberAnchors[NextDamageNumber] = Pending.Location;
+			DamageNumberExpireTimes[NextDamageNumber] = Now + DamageNumberDuration;
+			NextDamageNumber = (NextDamageNumber + 1) % DamageNumbers.Num();
+
+			Number->SetVisibility(ESlateVisibility::HitTestInvisible);
+			Number->OnShow(Pending.Damage, Pending.bKilled);
+		}
+
+		INC_DWORD_STAT_BY(STAT_SummerTPSHUD_NumbersShown, NumToShow);
+	}
+
+	PendingDamage.Reset();
+	PendingHits = 0;
+	bPendingKill = false;
+}
+
+void ASummerTPSHUD::UpdateWidgets(double Now)
+{
+	for (int32 Index = 0; Index < HitMarkers.Num(); ++Index)
+	{
+		if (HitMarkerExpireTimes[Index] >= 0.0 && Now >= HitMarkerExpireTimes[Index])
+		{
+			HitMarkerExpireTimes[Index] = -1.0;
+			HitMarkers[Index]->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+
+	for (int32 Index = 0; Index < DamageNumbers.Num(); ++Index)
+	{
+		if (DamageNumberExpireTimes[Index] < 0.0)
+		{
+			continue;
+		}
+
+		UDamageNumberWidget* Number = DamageNumbers[Index];
+		if (Now >= DamageNumberExpireTimes[Index])
+		{
+			DamageNumberExpireTimes[Index] = -1.0;
+			Number->SetVisibility(ESlateVisibility::Collapsed);
+			continue;
+		}
+
+		// The camera moves every frame, so the anchor is reprojected; behind the camera the number is hidden until it expires
+		FVector2D ScreenPosition;
+		const bool bOnScreen = PlayerOwner->ProjectWorldLocationToScreen(DamageNumberAnchors[Index], ScreenPosition, true);
+		if (bOnScreen)
+		{
+			Number->SetPositionInViewport(ScreenPosition, true);
+		}
+
+		const ESlateVisibility Visibility = bOnScreen ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Hidden;
+		if (Number->GetVisibility() != Visibility)
+		{
+			Number->SetVisibility(Visibility);
+		}
+	}
+}
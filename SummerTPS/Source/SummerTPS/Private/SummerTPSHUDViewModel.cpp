@@ -0,0 +1,97 @@
+#include "SummerTPSHUDViewModel.h"
+
+USummerTPSHUDViewModel::USummerTPSHUDViewModel()
+{
+	Health = 0.0f;
+	MaxHealth = 0.0f;
+	bIsDead = false;
+	Water = 0.0f;
+	MaxWater = 0.0f;
+	ShotsThisFrame = 0;
+	bIsCovered = false;
+
+	PendingShots = 0;
+	bHealthDirty = false;
+	bWaterDirty = false;
+	bCoverDirty = false;
+}
+
+float USummerTPSHUDViewModel::GetHealthPercent() const
+{
+	return MaxHealth > 0.0f ? Health / MaxHealth : 0.0f;
+}
+
+float USummerTPSHUDViewModel::GetWaterPercent() const
+{
+	return MaxWater > 0.0f ? Water / MaxWater : 1.0f;
+}
+
+void USummerTPSHUDViewModel::SetHealth(float InHealth, float InMaxHealth, bool bInIsDead)
+{
+	if (Health != InHealth || MaxHealth != InMaxHealth || bIsDead != bInIsDead)
+	{
+		Health = InHealth;
+		MaxHealth = InMaxHealth;
+		bIsDead = bInIsDead;
+		bHealthDirty = true;
+	}
+}
+
+void USummerTPSHUDViewModel::SetWater(float InWater, float InMaxWater)
+{
+	if (Water != InWater || MaxWater != InMaxWater)
+	{
+		Water = InWater;
+		MaxWater = InMaxWater;
+		bWaterDirty = true;
+	}
+}
+
+void USummerTPSHUDViewModel::AddShot()
+{
+	PendingShots++;
+}
+
+void USummerTPSHUDViewModel::SetCovered(bool bInIsCovered)
+{
+	if (bIsCovered != bInIsCovered)
+	{
+		bIsCovered = bInIsCovered;
+		bCoverDirty = true;
+	}
+}
+
+void USummerTPSHUDViewModel::MarkAllDirty()
+{
+	bHealthDirty = true;
+	bWaterDirty = true;
+	bCoverDirty = true;
+}
+
+void USummerTPSHUDViewModel::Flush()
+{
+	if (bHealthDirty)
+	{
+		bHealthDirty = false;
+		OnHealthChanged.Broadcast(this);
+	}
+
+	if (bWaterDirty)
+	{
+		bWaterDirty = false;
+		OnWaterChanged.Broadcast(this);
+	}
+
+	if (PendingShots > 0)
+	{
+		ShotsThisFrame = PendingShots;
+		PendingShots = 0;
+		OnFired.Broadcast(this);
+	}
+
+	if (bCoverDirty)
+	{
+		bCoverDirty = false;
+		OnCoverChanged.Broadcast(this);
+	}
+}
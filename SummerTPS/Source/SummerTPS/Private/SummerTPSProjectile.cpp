@@ -3,9 +3,20 @@
 #include "SummerTPSProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "GameFramework/Pawn.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "SDFCollisionSubsystem.h"
+#include "DamageableSpatialSubsystem.h"
+#include "NoiseAggregationSubsystem.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ObjectChurnSubsystem.h"
+#include "SplashDecalSubsystem.h"
+#include "ProjectileAsyncSimSubsystem.h"
+#include "CombatClockSubsystem.h"
+#include "WetnessSubsystem.h"
+#include "GameFramework/Character.h"
 
 // Sets default values
 ASummerTPSProjectile::ASummerTPSProjectile()
@@ -39,6 +50,27 @@ ASummerTPSProjectile::ASummerTPSProjectile()
 	InitialLifeSpan = 3.0f;
 
 	Damage = 100.0f;
+	HitWetness = 0.2f;
+
+	SplashRadius = 0.0f;
+	SplashDamage = 25.0f;
+	SplashMinimumDamage = 5.0f;
+	SplashFalloffExponent = 1.0f;
+
+	ImpactNoiseLoudness = 0.5f;
+	ImpactNoiseRange = 2000.0f;
+
+	SplashDecal = nullptr;
+	SplashDecalSize = 40.0f;
+
+	bUseSDFCollision = true;
+	bUseAsyncSimulation = true;
+	bStaticCollisionFromSDF = false;
+	DefaultStaticResponse = ECR_Block;
+	LastSDFLocation = FVector::ZeroVector;
+	bIsPooled = false;
+	AsyncSimId = INDEX_NONE;
+	bStepWithCombatClock = false;
 }
 
 // Called when the game starts or when spawned
@@ -48,19 +80,342 @@ void ASummerTPSProjectile::BeginPlay()
 
 	if (SpawnEffect)
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), SpawnEffect, GetActorLocation());
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), SpawnEffect, GetActorLocation(), FRotator::ZeroRotator, FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
+	}
+
+	DefaultStaticResponse = CollisionComp->GetCollisionResponseToChannel(ECC_WorldStatic);
+	LastSDFLocation = GetActorLocation();
+
+	UCombatClockSubsystem* Clock = UCombatClockSubsystem::Get(this);
+	if (Clock && Clock->IsFixedStep())
+	{
+		bStepWithCombatClock = true;
+		CombatStepHandle = Clock->OnCombatStep.AddUObject(this, &ASummerTPSProjectile::OnCombatStep);
+		SetFlightTickEnabled(true);
+		StartLifeSpan(InitialLifeSpan);
+	}
+
+	StartAsyncSimulation();
+}
+
+void ASummerTPSProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCombatClockSubsystem* Clock = UCombatClockSubsystem::Get(this))
+	{
+		Clock->OnCombatStep.Remove(CombatStepHandle);
+	}
+	UCombatClockSubsystem::ClearTimer(this, LifeSpanTimerHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASummerTPSProjectile::LifeSpanExpired()
+{
+	Expire();
+}
+
+void ASummerTPSProjectile::StartLifeSpan(float InLifeSpan)
+{
+	if (!bStepWithCombatClock)
+	{
+		SetLifeSpan(InLifeSpan);
+		return;
+	}
+
+	// The actor lifespan runs on the world timer manager, which doesn't follow the combat steps
+	SetLifeSpan(0.0f);
+	UCombatClockSubsystem::SetTimer(this, LifeSpanTimerHandle, &ASummerTPSProjectile::Expire, InLifeSpan, false);
+}
+
+void ASummerTPSProjectile::SetFlightTickEnabled(bool bEnabled)
+{
+	// Activating the movement component turns its tick back on, so this runs after every Activate
+	const bool bFrameTick = bEnabled && !bStepWithCombatClock;
+	SetActorTickEnabled(bFrameTick);
+	ProjectileMovement->SetComponentTickEnabled(bFrameTick);
+}
+
+void ASummerTPSProjectile::OnCombatStep(int64 StepIndex)
+{
+	if (bIsPooled || AsyncSimId != INDEX_NONE || !ProjectileMovement->IsActive())
+	{
+		return;
+	}
+
+	const UCombatClockSubsystem* Clock = UCombatClockSubsystem::Get(this);
+	ProjectileMovement->TickComponent(Clock->GetFixedStepSize(), LEVELTICK_All, nullptr);
+
+	// The move may have ended the flight through OnHit
+	if (bUseSDFCollision && !bIsPooled)
+	{
+		UpdateSDFCollision();
 	}
 }
 
+void ASummerTPSProjectile::DeactivateToPool()
+{
+	bIsPooled = true;
+	StopAsyncSimulation();
+
+	// Cancels the pending lifespan timer
+	SetLifeSpan(0.0f);
+	UCombatClockSubsystem::ClearTimer(this, LifeSpanTimerHandle);
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	UObjectChurnSubsystem::ClusterPooledActor(this);
+}
+
+void ASummerTPSProjectile::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	UObjectChurnSubsystem::UnclusterPooledActor(this);
+	bIsPooled = false;
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// Same state BeginPlay and the movement component's InitializeComponent leave a freshly spawned projectile in
+	SetStaticCollisionFromSDF(false);
+	LastSDFLocation = SpawnTransform.GetLocation();
+
+	ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	ProjectileMovement->Velocity = SpawnTransform.GetRotation().GetForwardVector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+	SetFlightTickEnabled(true);
+
+	StartLifeSpan(GetClass()->GetDefaultObject<AActor>()->InitialLifeSpan);
+
+	if (SpawnEffect)
+	{
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), SpawnEffect, SpawnTransform.GetLocation(), FRotator::ZeroRotator, FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
+	}
+
+	StartAsyncSimulation();
+}
+
+void ASummerTPSProjectile::StartAsyncSimulation()
+{
+	if (!bUseAsyncSimulation || !bUseSDFCollision || AsyncSimId != INDEX_NONE)
+	{
+		return;
+	}
+
+	UProjectileAsyncSimSubsystem* AsyncSim = GetWorld()->GetSubsystem<UProjectileAsyncSimSubsystem>();
+	if (!AsyncSim || !AsyncSim->IsAvailable())
+	{
+		return;
+	}
+
+	AsyncSimId = AsyncSim->Launch(this, ProjectileMovement->Velocity, CollisionComp->GetScaledSphereRadius(), ProjectileMovement->GetGravityZ(), GetLifeSpan());
+	if (AsyncSimId == INDEX_NONE)
+	{
+		return;
+	}
+
+	// The lifespan timer keeps running here and still ends the flight through Expire
+	ProjectileMovement->Deactivate();
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
+void ASummerTPSProjectile::StopAsyncSimulation()
+{
+	if (AsyncSimId == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (UProjectileAsyncSimSubsystem* AsyncSim = GetWorld()->GetSubsystem<UProjectileAsyncSimSubsystem>())
+	{
+		AsyncSim->Remove(AsyncSimId);
+	}
+	AsyncSimId = INDEX_NONE;
+}
+
+void ASummerTPSProjectile::OnAsyncSimEvent(const FProjectileSimEvent& Event, AActor* HitActor)
+{
+	AsyncSimId = INDEX_NONE;
+
+	switch (Event.Type)
+	{
+	case EProjectileSimEvent::NoCoverage:
+	{
+		// Same state as a projectile that never had async simulation, at the last covered position
+		SetActorLocationAndRotation(Event.Location, Event.Velocity.Rotation());
+		SetActorEnableCollision(true);
+		LastSDFLocation = Event.Location;
+
+		ProjectileMovement->SetUpdatedComponent(CollisionComp);
+		ProjectileMovement->Velocity = Event.Velocity;
+		ProjectileMovement->Activate(true);
+		SetFlightTickEnabled(true);
+		break;
+	}
+
+	case EProjectileSimEvent::Hit:
+		SetActorLocation(Event.Location);
+		if (HitActor)
+		{
+			FHitResult Hit(HitActor, Cast<UPrimitiveComponent>(HitActor->GetRootComponent()), Event.ImpactPoint, Event.ImpactNormal);
+			Hit.Location = Event.Location;
+			OnHit(CollisionComp, HitActor, Hit.GetComponent(), FVector::ZeroVector, Hit);
+		}
+		else
+		{
+			// Static geometry, or a character that was destroyed before the event arrived
+			FSDFTraceHit Hit;
+			Hit.Location = Event.Location;
+			Hit.ImpactPoint = Event.ImpactPoint;
+			Hit.ImpactNormal = Event.ImpactNormal;
+			OnSDFImpact(Hit);
+		}
+		break;
+
+	case EProjectileSimEvent::Expired:
+		Expire();
+		break;
+	}
+}
+
+bool ASummerTPSProjectile::SweepDynamicObjects(const FVector& End)
+{
+	const FVector Start = GetActorLocation();
+	if (bIsPooled || Start.Equals(End))
+	{
+		return false;
+	}
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(ProjectileDynamicSweep), false, this);
+	Params.AddIgnoredActor(GetOwner());
+
+	// Characters come from the capsule snapshots of the async simulation. Static geometry only comes from the distance field
+	// where both ends are covered, since registered volumes baked all of theirs; anywhere else physics has to sweep it
+	const USDFCollisionSubsystem* SDF = GetWorld()->GetSubsystem<USDFCollisionSubsystem>();
+	const bool bStaticFromSDF = SDF && SDF->HasCoverage(Start) && SDF->HasCoverage(End);
+
+	FCollisionResponseParams ResponseParams(CollisionComp->GetCollisionResponseToChannels());
+	ResponseParams.CollisionResponse.SetResponse(ECC_WorldStatic, bStaticFromSDF ? ECR_Ignore : DefaultStaticResponse.GetValue());
+	ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+
+	FHitResult Hit;
+	if (!GetWorld()->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, CollisionComp->GetCollisionObjectType(), CollisionComp->GetCollisionShape(), Params, ResponseParams))
+	{
+		return false;
+	}
+
+	// OnHit lets the flight go on through actors of the same owner, like the weapon
+	AActor* HitActor = Hit.GetActor();
+	if (HitActor && GetOwner() && HitActor->GetOwner() == GetOwner())
+	{
+		return false;
+	}
+
+	StopAsyncSimulation();
+	SetActorLocation(Hit.Location);
+	OnHit(CollisionComp, HitActor, Hit.GetComponent(), FVector::ZeroVector, Hit);
+	return true;
+}
+
+void ASummerTPSProjectile::Expire()
+{
+	if (bIsPooled)
+	{
+		return;
+	}
+
+	StopAsyncSimulation();
+
+	if (UProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+	{
+		if (Pool->Release(this))
+		{
+			return;
+		}
+	}
+
+	Destroy();
+}
+
 // Called every frame
 void ASummerTPSProjectile::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (bIsPooled)
+	{
+		return;
+	}
+
+	if (bUseSDFCollision)
+	{
+		UpdateSDFCollision();
+	}
+}
+
+void ASummerTPSProjectile::UpdateSDFCollision()
+{
+	const USDFCollisionSubsystem* SDF = GetWorld()->GetSubsystem<USDFCollisionSubsystem>();
+	if (!SDF)
+	{
+		return;
+	}
+
+	const FVector CurrentLocation = GetActorLocation();
+
+	FSDFTraceHit Hit;
+	const ESDFTraceResult Result = SDF->SphereTrace(LastSDFLocation, CurrentLocation, CollisionComp->GetScaledSphereRadius(), Hit);
+	LastSDFLocation = CurrentLocation;
+
+	// Outside the baked volumes static geometry has to be swept by physics again
+	SetStaticCollisionFromSDF(Result != ESDFTraceResult::NoCoverage);
+
+	if (Result == ESDFTraceResult::Hit)
+	{
+		OnSDFImpact(Hit);
+	}
+}
+
+void ASummerTPSProjectile::SetStaticCollisionFromSDF(bool bFromSDF)
+{
+	if (bStaticCollisionFromSDF == bFromSDF)
+	{
+		return;
+	}
+
+	bStaticCollisionFromSDF = bFromSDF;
+	CollisionComp->SetCollisionResponseToChannel(ECC_WorldStatic, bFromSDF ? ECR_Ignore : DefaultStaticResponse.GetValue());
+}
+
+void ASummerTPSProjectile::OnSDFImpact(const FSDFTraceHit& Hit)
+{
+	// Same outcome as OnHit against world geometry: no damage target, effect at the impact point
+	SetActorLocation(Hit.Location);
+	ApplySplashDamage(Hit.ImpactPoint, nullptr);
+	ReportImpactNoise(Hit.ImpactPoint);
+	PlaceSplashDecal(Hit.ImpactPoint, Hit.ImpactNormal, nullptr, nullptr);
+
+	if (OverlapEffect)
+	{
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), OverlapEffect, Hit.ImpactPoint, Hit.ImpactNormal.Rotation(), FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
+	}
+
+	Expire();
 }
 
 void ASummerTPSProjectile::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	// A hit and an overlap can both arrive in the frame the projectile went back to the pool
+	if (bIsPooled)
+	{
+		return;
+	}
+
 	AActor* MyOwner = GetOwner();
 
 	// Ignore collision with self, the owner (player), and any other actors the owner owns (like the weapon).
@@ -70,6 +425,15 @@ void ASummerTPSProjectile::OnOverlapBegin(UPrimitiveComponent* OverlappedCompone
 	}
 
 	UGameplayStatics::ApplyDamage(OtherActor, Damage, MyOwner->GetInstigatorController(), this, UDamageType::StaticClass());
+	ApplySplashDamage(bFromSweep ? FVector(SweepResult.ImpactPoint) : GetActorLocation(), OtherActor);
+	ReportImpactNoise(bFromSweep ? FVector(SweepResult.ImpactPoint) : GetActorLocation());
+	SoakHitCharacter(OtherActor, bFromSweep ? FVector(SweepResult.ImpactPoint) : GetActorLocation(), SweepResult.BoneName);
+
+	// Without a sweep there is no surface normal to project along
+	if (bFromSweep)
+	{
+		PlaceSplashDecal(SweepResult.ImpactPoint, SweepResult.ImpactNormal, OtherComp, OtherActor);
+	}
 
 	// If we hit anything else (including world geometry where OtherActor is null), spawn the effect.
 	if (OverlapEffect)
@@ -77,15 +441,21 @@ void ASummerTPSProjectile::OnOverlapBegin(UPrimitiveComponent* OverlappedCompone
 		// Use the impact point from the sweep result for a more accurate spawn location.
 		// Fall back to the actor's transform if the impact point is not available.
 		const FTransform SpawnTransform = bFromSweep ? FTransform(SweepResult.ImpactNormal.Rotation(), SweepResult.ImpactPoint) : GetActorTransform();
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), OverlapEffect, SpawnTransform.GetLocation(), SpawnTransform.GetRotation().Rotator());
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), OverlapEffect, SpawnTransform.GetLocation(), SpawnTransform.GetRotation().Rotator(), FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
 	}
 
-	// Destroy the projectile after the effect has been spawned.
-	Destroy();
+	// Return the projectile after the effect has been spawned.
+	Expire();
 }
 
 void ASummerTPSProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	// A hit and an overlap can both arrive in the frame the projectile went back to the pool
+	if (bIsPooled)
+	{
+		return;
+	}
+
 	AActor* MyOwner = GetOwner();
 
 	// Ignore collision with self, the owner (player), and any other actors the owner owns (like the weapon).
@@ -95,13 +465,80 @@ void ASummerTPSProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActo
 	}
 
 	UGameplayStatics::ApplyDamage(OtherActor, Damage, MyOwner->GetInstigatorController(), this, UDamageType::StaticClass());
+	ApplySplashDamage(Hit.ImpactPoint, OtherActor);
+	ReportImpactNoise(Hit.ImpactPoint);
+	PlaceSplashDecal(Hit.ImpactPoint, Hit.ImpactNormal, OtherComp, OtherActor);
+	SoakHitCharacter(OtherActor, Hit.ImpactPoint, Hit.BoneName);
 
 	// If we hit anything else, spawn the effect at the impact point.
 	if (OverlapEffect)
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), OverlapEffect, Hit.ImpactPoint);
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), OverlapEffect, Hit.ImpactPoint, FRotator::ZeroRotator, FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
 	}
 
-	// Destroy the projectile after the effect has been spawned.
-	Destroy();
+	// Return the projectile after the effect has been spawned.
+	Expire();
+}
+
+void ASummerTPSProjectile::ApplySplashDamage(const FVector& ImpactPoint, AActor* DirectHitActor)
+{
+	if (SplashRadius <= 0.0f)
+	{
+		return;
+	}
+
+	UDamageableSpatialSubsystem* DamageableIndex = GetWorld()->GetSubsystem<UDamageableSpatialSubsystem>();
+	if (!DamageableIndex)
+	{
+		return;
+	}
+
+	AActor* MyOwner = GetOwner();
+	TArray<AActor*, TInlineAllocator<2>> IgnoreActors;
+	IgnoreActors.Add(MyOwner);
+	IgnoreActors.Add(DirectHitActor);
+
+	DamageableIndex->ApplyRadialDamage(ImpactPoint, SplashRadius, SplashDamage, SplashMinimumDamage, SplashFalloffExponent,
+		this, MyOwner ? MyOwner->GetInstigatorController() : nullptr, UDamageType::StaticClass(), IgnoreActors);
+}
+
+void ASummerTPSProjectile::ReportImpactNoise(const FVector& ImpactPoint)
+{
+	if (ImpactNoiseLoudness <= 0.0f)
+	{
+		return;
+	}
+
+	// Attributed to the shooter so all of its impacts in a frame merge into one noise event
+	if (UNoiseAggregationSubsystem* Noise = GetWorld()->GetSubsystem<UNoiseAggregationSubsystem>())
+	{
+		Noise->ReportNoise(GetOwner() ? GetOwner() : this, ImpactPoint, ImpactNoiseLoudness, ImpactNoiseRange, TEXT("Impact"));
+	}
+}
+
+void ASummerTPSProjectile::PlaceSplashDecal(const FVector& ImpactPoint, const FVector& ImpactNormal, const UPrimitiveComponent* Surface, const AActor* HitActor)
+{
+	if (!SplashDecal || SplashDecalSize <= 0.0f || Cast<APawn>(HitActor))
+	{
+		return;
+	}
+
+	if (USplashDecalSubsystem* Decals = GetWorld()->GetSubsystem<USplashDecalSubsystem>())
+	{
+		Decals->AddSplash(SplashDecal, ImpactPoint, ImpactNormal, SplashDecalSize, Surface);
+	}
+}
+
+void ASummerTPSProjectile::SoakHitCharacter(AActor* HitActor, const FVector& ImpactPoint, FName BoneName)
+{
+	ACharacter* Character = Cast<ACharacter>(HitActor);
+	if (!Character || HitWetness <= 0.0f)
+	{
+		return;
+	}
+
+	if (UWetnessSubsystem* Wetness = GetWorld()->GetSubsystem<UWetnessSubsystem>())
+	{
+		Wetness->AddWater(Character, ImpactPoint, BoneName, HitWetness);
+	}
 }
@@ -10,6 +10,14 @@
 #include "DrawDebugHelpers.h"
 #include "NiagaraFunctionLibrary.h"
 #include "HealthComponent.h"
+#include "AttackTokenComponent.h"
+#include "ClothLODComponent.h"
+#include "SDFCollisionSubsystem.h"
+#include "NoiseAggregationSubsystem.h"
+#include "WorldQuerySchedulerSubsystem.h"
+#include "ProjectilePoolSubsystem.h"
+#include "CombatClockSubsystem.h"
+#include "SummerTPSProjectile.h"
 
 // Sets default values
 ATPSPlayer::ATPSPlayer()
@@ -23,6 +31,14 @@ ATPSPlayer::ATPSPlayer()
 	// Initialize automatic fire rate
 	TimeBetweenShots = 0.1f;
 
+	// Gunfire is heard across most of the beach
+	GunfireNoiseLoudness = 1.0f;
+	GunfireNoiseRange = 4000.0f;
+
+	MaxWater = 100.0f;
+	WaterPerShot = 0.0f;
+	Water = MaxWater;
+
 	// Initialize aiming flag
 	bIsAiming = false;
 
@@ -93,6 +109,10 @@ ATPSPlayer::ATPSPlayer()
 	ProjectileSpawnPoint->SetupAttachment(GetMesh()); // Attach to mesh, can be adjusted to a specific socket later
 
 	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("HealthComponent"));
+
+	AttackTokenComponent = CreateDefaultSubobject<UAttackTokenComponent>(TEXT("AttackTokenComponent"));
+
+	ClothLODComponent = CreateDefaultSubobject<UClothLODComponent>(TEXT("ClothLODComponent"));
 }
 
 // Called when the game starts or when spawned
@@ -147,6 +167,10 @@ void ATPSPlayer::BeginPlay()
 	{
 		HealthComponent->OnHealthChanged.AddDynamic(this, &ATPSPlayer::OnHealthChanged);
 	}
+
+	MeshCollisionProfileName = GetMesh()->GetCollisionProfileName();
+
+	Water = MaxWater;
 }
 
 // Called every frame
@@ -182,7 +206,7 @@ void ATPSPlayer::Tick(float DeltaTime)
 		// If currently entering cover, interpolate position
 		if (bIsEnteringCover)
 		{
-			float ElapsedTime = GetWorld()->GetTimeSeconds() - EnterCoverStartTime;
+			float ElapsedTime = UCombatClockSubsystem::GetCombatTime(this) - EnterCoverStartTime;
 			float Alpha = FMath::Clamp(ElapsedTime / EnterCoverDuration, 0.f, 1.f);
 			FVector CurrentLocation = FMath::Lerp(EnterCoverStartLocation, EnterCoverTargetLocation, Alpha);
 			FRotator CurrentRotation = FMath::Lerp(EnterCoverStartRotation, EnterCoverTargetRotation, Alpha);
@@ -208,7 +232,7 @@ void ATPSPlayer::Tick(float DeltaTime)
 	}
 	else if (bIsExitingCover)
 	{
-		float ElapsedTime = GetWorld()->GetTimeSeconds() - ExitCoverStartTime;
+		float ElapsedTime = UCombatClockSubsystem::GetCombatTime(this) - ExitCoverStartTime;
 		float Alpha = FMath::Clamp(ElapsedTime / ExitCoverDuration, 0.f, 1.f);
 		FVector CurrentLocation = FMath::Lerp(ExitCoverStartLocation, ExitCoverTargetLocation, Alpha);
 		SetActorLocation(CurrentLocation);
@@ -240,13 +264,51 @@ void ATPSPlayer::Tick(float DeltaTime)
 		}
 
 		FPredictProjectilePathParams PredictParams(20.f, MuzzleLocation, MuzzleRotation.Vector() * ProjectilePredictionSpeed, 5.f, ECC_Visibility);
-		FPredictProjectilePathResult PredictResult;
 
-		if (UGameplayStatics::PredictProjectilePath(this, PredictParams, PredictResult))
+		// Static geometry from the baked distance field, physics only for dynamic actors along the arc
+		TArray<FVector, FFrameArenaAllocator> PathPoints;
+		FSDFTraceHit SDFHit;
+		const USDFCollisionSubsystem* SDF = GetWorld()->GetSubsystem<USDFCollisionSubsystem>();
+		UWorldQuerySchedulerSubsystem* Queries = GetWorld()->GetSubsystem<UWorldQuerySchedulerSubsystem>();
+		const float GravityZ = FMath::IsNearlyZero(PredictParams.OverrideGravityZ) ? GetWorld()->GetGravityZ() : PredictParams.OverrideGravityZ;
+
+		if (SDF && SDF->PredictPath(MuzzleLocation, PredictParams.LaunchVelocity, PredictParams.ProjectileRadius, PredictParams.MaxSimTime, PredictParams.SimFrequency, GravityZ, PathPoints, SDFHit) != ESDFTraceResult::NoCoverage)
 		{
-			for (int32 i = 0; i < PredictResult.PathData.Num() - 1; ++i)
+			FCollisionObjectQueryParams DynamicObjects;
+			DynamicObjects.AddObjectTypesToQuery(ECC_Pawn);
+			DynamicObjects.AddObjectTypesToQuery(ECC_PhysicsBody);
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TrajectoryPreview), false, this);
+			QueryParams.AddIgnoredActor(SpawnedWeapon);
+
+			for (int32 i = 0; i < PathPoints.Num() - 1; ++i)
+			{
+				FHitResult DynamicHit;
+				bool bHitDynamic;
+				{
+					UWorldQuerySchedulerSubsystem::FScopedQuery QueryScope(Queries, EWorldQueryCategory::TrajectoryPreview);
+					bHitDynamic = GetWorld()->LineTraceSingleByObjectType(DynamicHit, PathPoints[i], PathPoints[i+1], DynamicObjects, QueryParams);
+				}
+				DrawDebugLine(GetWorld(), PathPoints[i], bHitDynamic ? DynamicHit.Location : PathPoints[i+1], FColor::Yellow, false, 0.f, 0, 0.5f);
+				if (bHitDynamic)
+				{
+					break;
+				}
+			}
+		}
+		else
+		{
+			bool bPredicted;
+			{
+				UWorldQuerySchedulerSubsystem::FScopedQuery QueryScope(Queries, EWorldQueryCategory::TrajectoryPreview);
+				bPredicted = UGameplayStatics::PredictProjectilePath(this, PredictParams, TrajectoryPredictResult);
+			}
+
+			if (bPredicted)
 			{
-				DrawDebugLine(GetWorld(), PredictResult.PathData[i].Location, PredictResult.PathData[i+1].Location, FColor::Yellow, false, 0.f, 0, 0.5f);
+				for (int32 i = 0; i < TrajectoryPredictResult.PathData.Num() - 1; ++i)
+				{
+					DrawDebugLine(GetWorld(), TrajectoryPredictResult.PathData[i].Location, TrajectoryPredictResult.PathData[i+1].Location, FColor::Yellow, false, 0.f, 0, 0.5f);
+				}
 			}
 		}
 	}
@@ -305,7 +367,13 @@ void ATPSPlayer::Move(const FInputActionValue& Value)
 			FCollisionQueryParams QueryParams;
 			QueryParams.AddIgnoredActor(this);
 
-			if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams))
+			// Decides this frame's movement, so it can't be deferred
+			UWorldQuerySchedulerSubsystem* Queries = GetWorld()->GetSubsystem<UWorldQuerySchedulerSubsystem>();
+			const bool bWallAhead = Queries
+				? Queries->LineTraceNow(EWorldQueryCategory::PlayerMovement, HitResult, Start, End, ECC_Visibility, QueryParams)
+				: GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams);
+
+			if (bWallAhead)
 			{
 				// Only move if there is a wall to stay in cover
 				AddMovementInput(MoveDirection, 1.f);
@@ -359,12 +427,12 @@ void ATPSPlayer::StartFire()
 {
 	UpdateRotationSettings();
 	Fire(); // Fire immediately on press
-	GetWorldTimerManager().SetTimer(TimerHandle_AutomaticFire, this, &ATPSPlayer::Fire, TimeBetweenShots, true);
+	UCombatClockSubsystem::SetTimer(this, TimerHandle_AutomaticFire, &ATPSPlayer::Fire, TimeBetweenShots, true);
 }
 
 void ATPSPlayer::StopFire()
 {
-	GetWorldTimerManager().ClearTimer(TimerHandle_AutomaticFire);
+	UCombatClockSubsystem::ClearTimer(this, TimerHandle_AutomaticFire);
 	UpdateRotationSettings();
 }
 
@@ -374,7 +442,7 @@ void ATPSPlayer::UpdateRotationSettings()
 	bool bShouldUseControllerRotationYaw = false;
 
 	// If we are aiming OR firing, we want to face the camera direction.
-	if (bIsAiming || GetWorldTimerManager().IsTimerActive(TimerHandle_AutomaticFire))
+	if (bIsAiming || UCombatClockSubsystem::IsTimerActive(this, TimerHandle_AutomaticFire))
 	{
 		bShouldOrientToMovement = false;
 		bShouldUseControllerRotationYaw = true;
@@ -386,6 +454,12 @@ void ATPSPlayer::UpdateRotationSettings()
 
 void ATPSPlayer::Fire()
 {
+	// Tank empty, the trigger does nothing until RefillWater tops it up
+	if (UsesWater() && Water < WaterPerShot)
+	{
+		return;
+	}
+
 	// Implement projectile firing logic here
 	if (ProjectileClass && SpawnedWeapon)
 	{
@@ -412,15 +486,29 @@ void ATPSPlayer::Fire()
 			}
 
 
-			// Spawn the projectile
-			AActor* SpawnedProjectile = World->SpawnActor<AActor>(ProjectileClass, SpawnLocation, SpawnRotation, SpawnParams);
+			// Spawn the projectile, reusing a pooled one when the class supports it
+			AActor* SpawnedProjectile = nullptr;
+			UProjectilePoolSubsystem* ProjectilePool = World->GetSubsystem<UProjectilePoolSubsystem>();
+			if (ProjectilePool && ProjectileClass->IsChildOf<ASummerTPSProjectile>())
+			{
+				SpawnedProjectile = ProjectilePool->Acquire(ProjectileClass.Get(), FTransform(SpawnRotation, SpawnLocation), this, GetInstigator());
+			}
+			else
+			{
+				SpawnedProjectile = World->SpawnActor<AActor>(ProjectileClass, SpawnLocation, SpawnRotation, SpawnParams);
+			}
 			if (SpawnedProjectile)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("Projectile Fired!"));
+				UE_LOG(LogTemp, Verbose, TEXT("Projectile Fired!"));
 
 				if (FireEffect)
 				{
-					UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), FireEffect, SpawnLocation, SpawnRotation);
+					UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), FireEffect, SpawnLocation, SpawnRotation, FVector(1.f), true, true, ENCPoolMethod::AutoRelease);
+				}
+
+				if (UNoiseAggregationSubsystem* Noise = World->GetSubsystem<UNoiseAggregationSubsystem>())
+				{
+					Noise->ReportNoise(this, SpawnLocation, GunfireNoiseLoudness, GunfireNoiseRange, TEXT("Gunfire"));
 				}
 
 				// Update the prediction speed from the spawned projectile
@@ -429,6 +517,13 @@ void ATPSPlayer::Fire()
 				{
 					ProjectilePredictionSpeed = ProjectileMovement->InitialSpeed;
 				}
+
+				if (UsesWater())
+				{
+					Water = FMath::Max(Water - WaterPerShot, 0.0f);
+					OnWaterChanged.Broadcast(this);
+				}
+				OnFired.Broadcast(this);
 			}
 		}
 	}
@@ -473,7 +568,13 @@ void ATPSPlayer::TryEnterCover()
 	QueryParams.AddIgnoredActor(this);
 
 	// For now, we'll use the Visibility channel. We'll create a custom "Cover" channel later.
-	if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams))
+	// Direct response to the cover button, so it runs as a critical query
+	UWorldQuerySchedulerSubsystem* Queries = GetWorld()->GetSubsystem<UWorldQuerySchedulerSubsystem>();
+	const bool bFoundWall = Queries
+		? Queries->LineTraceNow(EWorldQueryCategory::PlayerCover, HitResult, Start, End, ECC_Visibility, QueryParams)
+		: GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams);
+
+	if (bFoundWall)
 	{
 		// If already exiting cover, stop it
 		if (bIsExitingCover)
@@ -483,6 +584,7 @@ void ATPSPlayer::TryEnterCover()
 
 		bIsCovered = true;
 		CoverWallNormal = HitResult.ImpactNormal;
+		OnCoverChanged.Broadcast(this);
 
 		// --- Snap to cover ---
 		// Calculate the new location to snap to the wall
@@ -492,7 +594,7 @@ void ATPSPlayer::TryEnterCover()
 
 		// Set up enter cover animation
 		bIsEnteringCover = true;
-		EnterCoverStartTime = GetWorld()->GetTimeSeconds();
+		EnterCoverStartTime = UCombatClockSubsystem::GetCombatTime(this);
 		EnterCoverStartLocation = GetActorLocation();
 		EnterCoverTargetLocation = TargetLocation;
 		EnterCoverStartRotation = GetActorRotation();
@@ -513,10 +615,11 @@ void ATPSPlayer::TryEnterCover()
 void ATPSPlayer::ExitCover()
 {
 	bIsCovered = false;
+	OnCoverChanged.Broadcast(this);
 
 	// Set up exit cover animation
 	bIsExitingCover = true;
-	ExitCoverStartTime = GetWorld()->GetTimeSeconds();
+	ExitCoverStartTime = UCombatClockSubsystem::GetCombatTime(this);
 	ExitCoverStartLocation = GetActorLocation();
 	ExitCoverTargetLocation = GetActorLocation() + CoverWallNormal * 10.f;
 
@@ -561,4 +664,63 @@ void ATPSPlayer::OnDeath()
 	GetCharacterMovement()->DisableMovement();
 
 	UE_LOG(LogTemp, Warning, TEXT("Player has died!"));
-}
\ No newline at end of file
+}
+
+void ATPSPlayer::Revive(const FTransform& SpawnTransform, const FRotator& ControlRotation, float Health, float InWater)
+{
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+
+	if (bIsDead)
+	{
+		bIsDead = false;
+
+		// Back from the ragdoll onto the capsule
+		GetMesh()->SetSimulatePhysics(false);
+		GetMesh()->SetCollisionProfileName(MeshCollisionProfileName);
+		GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+		GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+		GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+		if (PlayerController)
+		{
+			EnableInput(PlayerController);
+		}
+	}
+
+	// Drop any cover or firing state the snapshot didn't have
+	UCombatClockSubsystem::ClearTimer(this, TimerHandle_AutomaticFire);
+	bIsAiming = false;
+	bIsSprinting = false;
+	bIsCovered = false;
+	bIsEnteringCover = false;
+	bIsExitingCover = false;
+	GetCharacterMovement()->MaxWalkSpeed = DefaultWalkSpeed;
+	UpdateRotationSettings();
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	if (PlayerController)
+	{
+		PlayerController->SetControlRotation(ControlRotation);
+	}
+
+	if (HealthComponent)
+	{
+		HealthComponent->SetHealth(Health);
+	}
+
+	Water = FMath::Clamp(InWater, 0.0f, MaxWater);
+	OnRevived.Broadcast(this);
+}
+
+void ATPSPlayer::RefillWater(float Amount)
+{
+	const float NewWater = FMath::Clamp(Water + Amount, 0.0f, MaxWater);
+	if (NewWater != Water)
+	{
+		Water = NewWater;
+		OnWaterChanged.Broadcast(this);
+	}
+}
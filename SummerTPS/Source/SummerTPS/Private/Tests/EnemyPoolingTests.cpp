@@ -0,0 +1,45 @@
+#include "Microbenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "EnemyCharacter.h"
+#include "HealthComponent.h"
+#include "DamageableSpatialSubsystem.h"
+#include "GameFramework/DamageType.h"
+#include "Engine/World.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPooledEnemySplashTest, "SummerTPS.Pooling.SplashSkipsPooledEnemy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPooledEnemySplashTest::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+
+	const FTransform EnemyTransform(FVector(200.f, 0.f, 0.f));
+	AEnemyCharacter* Enemy = World->SpawnActor<AEnemyCharacter>(AEnemyCharacter::StaticClass(), EnemyTransform);
+	UDamageableSpatialSubsystem* DamageableIndex = World->GetSubsystem<UDamageableSpatialSubsystem>();
+	if (!TestNotNull(TEXT("Enemy"), Enemy) || !TestNotNull(TEXT("Health component"), Enemy->GetHealthComponent()) || !TestNotNull(TEXT("Damageable index"), DamageableIndex))
+	{
+		return false;
+	}
+
+	UHealthComponent* EnemyHealth = Enemy->GetHealthComponent();
+	const float FullHealth = EnemyHealth->GetDefaultHealth();
+	auto Splash = [&]()
+	{
+		return DamageableIndex->ApplyRadialDamage(EnemyTransform.GetLocation(), 300.0f, 10.0f, 5.0f, 1.0f,
+			nullptr, nullptr, UDamageType::StaticClass(), TConstArrayView<AActor*>());
+	};
+
+	// Parked where it was pooled, right in the middle of the splash
+	Enemy->DeactivateToPool();
+	TestEqual(TEXT("Actors damaged by a splash on a pooled enemy"), Splash(), 0);
+	TestEqual(TEXT("Pooled enemy health after the splash"), EnemyHealth->GetHealth(), FullHealth);
+
+	Enemy->ActivateFromPool(EnemyTransform, FullHealth);
+	TestEqual(TEXT("Actors damaged by a splash on the reactivated enemy"), Splash(), 1);
+	TestTrue(TEXT("Reactivated enemy took splash damage"), EnemyHealth->GetHealth() < FullHealth);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
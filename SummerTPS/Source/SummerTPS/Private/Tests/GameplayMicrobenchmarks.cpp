@@ -0,0 +1,322 @@
+#include "Microbenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TPSPlayer.h"
+#include "EnemyCharacter.h"
+#include "EnemyAIController.h"
+#include "EnemySpawner.h"
+#include "HealthComponent.h"
+#include "SummerTPSProjectile.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ActorRegistrySubsystem.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+#include "Perception/AISense_Sight.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+/** Reaches the protected and private entry points the benchmarks time; befriended by the benchmarked classes */
+struct FSummerTPSBenchmarkAccess
+{
+	static void SetUpShooter(ATPSPlayer& Player, AActor* Weapon)
+	{
+		Player.ProjectileClass = ASummerTPSProjectile::StaticClass();
+		Player.SpawnedWeapon = Weapon;
+		Player.ProjectilePredictionSpeed = GetDefault<ASummerTPSProjectile>()->GetProjectileMovement()->InitialSpeed;
+	}
+
+	static void Fire(ATPSPlayer& Player)
+	{
+		Player.Fire();
+	}
+
+	static FVector GetMuzzleLocation(const ATPSPlayer& Player)
+	{
+		return Player.ProjectileSpawnPoint->GetComponentLocation();
+	}
+
+	static float GetProjectilePredictionSpeed(const ATPSPlayer& Player)
+	{
+		return Player.ProjectilePredictionSpeed;
+	}
+
+	static void HandleTakeAnyDamage(UHealthComponent& HealthComponent, float Damage)
+	{
+		HealthComponent.HandleTakeAnyDamage(HealthComponent.GetOwner(), Damage, GetDefault<UDamageType>(), nullptr, nullptr);
+	}
+
+	static void ResetSpawner(AEnemySpawner& Spawner)
+	{
+		UCombatClockSubsystem::ClearTimer(&Spawner, Spawner.SpawnTimerHandle);
+		Spawner.EnemiesSpawnedCount = 0;
+		Spawner.NumberOfEnemiesToSpawn = 1;
+	}
+
+	static void SpawnEnemy(AEnemySpawner& Spawner)
+	{
+		Spawner.SpawnEnemy();
+	}
+
+	static void OnPerceptionUpdated(AEnemyCharacter& Enemy, AActor* Actor, const FAIStimulus& Stimulus)
+	{
+		Enemy.OnPerceptionUpdated(Actor, Stimulus);
+	}
+};
+
+namespace GameplayMicrobenchmarks
+{
+	/** An enemy possessed by an AEnemyAIController with a blackboard holding TargetActor, like BB_EnemyAI */
+	static AEnemyCharacter* SpawnEnemyWithBlackboard(UWorld* World, const FVector& Location)
+	{
+		AEnemyCharacter* Enemy = World->SpawnActor<AEnemyCharacter>(AEnemyCharacter::StaticClass(), FTransform(Location));
+		if (!Enemy)
+		{
+			return nullptr;
+		}
+
+		AEnemyAIController* AICon = Cast<AEnemyAIController>(Enemy->GetController());
+		if (!AICon)
+		{
+			AICon = World->SpawnActor<AEnemyAIController>();
+			AICon->Possess(Enemy);
+		}
+
+		UBlackboardData* BlackboardData = NewObject<UBlackboardData>(AICon);
+		BlackboardData->UpdatePersistentKey<UBlackboardKeyType_Object>(TEXT("TargetActor"));
+
+		UBlackboardComponent* Blackboard = nullptr;
+		AICon->UseBlackboard(BlackboardData, Blackboard);
+		return Enemy;
+	}
+
+	/** Sets a console variable for one benchmark and restores the previous value afterwards */
+	class FScopedConsoleVariableOverride
+	{
+	public:
+		FScopedConsoleVariableOverride(const TCHAR* Name, const TCHAR* Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			if (Variable)
+			{
+				PreviousValue = Variable->GetString();
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedConsoleVariableOverride()
+		{
+			if (Variable)
+			{
+				Variable->Set(*PreviousValue, ECVF_SetByCode);
+			}
+		}
+
+	private:
+		IConsoleVariable* Variable;
+		FString PreviousValue;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerFireMicrobenchmark, "SummerTPS.Benchmark.PlayerFire", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FPlayerFireMicrobenchmark::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld BenchmarkWorld;
+	UWorld* World = BenchmarkWorld.GetWorld();
+
+	ATPSPlayer* Player = World->SpawnActor<ATPSPlayer>(ATPSPlayer::StaticClass(), FTransform::Identity);
+	AActor* Weapon = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	UProjectilePoolSubsystem* ProjectilePool = World->GetSubsystem<UProjectilePoolSubsystem>();
+	if (!TestNotNull(TEXT("Player"), Player) || !TestNotNull(TEXT("Weapon"), Weapon) || !TestNotNull(TEXT("Projectile pool"), ProjectilePool))
+	{
+		return false;
+	}
+
+	FSummerTPSBenchmarkAccess::SetUpShooter(*Player, Weapon);
+
+	// Projectile acquisition, muzzle effect and gunfire noise report; the previous shot is back in the pool before each one
+	FMicrobenchmark Benchmark(TEXT("PlayerFire"), 2000);
+	const FMicrobenchmarkResult Result = Benchmark.Run(
+		[ProjectilePool](int32) { ProjectilePool->ReleaseAll(); },
+		[Player](int32) { FSummerTPSBenchmarkAccess::Fire(*Player); });
+
+	ReportMicrobenchmark(*this, Result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileSpawnToHitMicrobenchmark, "SummerTPS.Benchmark.ProjectileSpawnToHit", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FProjectileSpawnToHitMicrobenchmark::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld BenchmarkWorld;
+	UWorld* World = BenchmarkWorld.GetWorld();
+
+	AActor* Shooter = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	AEnemyCharacter* Target = World->SpawnActor<AEnemyCharacter>(AEnemyCharacter::StaticClass(), FTransform(FVector(500.f, 0.f, 0.f)));
+	UProjectilePoolSubsystem* ProjectilePool = World->GetSubsystem<UProjectilePoolSubsystem>();
+	if (!TestNotNull(TEXT("Shooter"), Shooter) || !TestNotNull(TEXT("Target"), Target) || !TestNotNull(TEXT("Projectile pool"), ProjectilePool))
+	{
+		return false;
+	}
+
+	UHealthComponent* TargetHealth = Target->GetHealthComponent();
+	const FTransform MuzzleTransform(FRotator::ZeroRotator, FVector(100.f, 0.f, 0.f));
+
+	FHitResult Hit;
+	Hit.Location = Target->GetActorLocation();
+	Hit.ImpactPoint = Target->GetActorLocation();
+	Hit.ImpactNormal = FVector(-1.f, 0.f, 0.f);
+
+	// Flight is left to the physics scene; this covers acquisition, the direct hit (damage, health broadcast, impact noise) and the return to the pool
+	FMicrobenchmark Benchmark(TEXT("ProjectileSpawnToHit"), 2000);
+	const FMicrobenchmarkResult Result = Benchmark.Run(
+		[TargetHealth](int32) { TargetHealth->SetHealth(TargetHealth->GetDefaultHealth()); },
+		[&](int32)
+		{
+			if (ASummerTPSProjectile* Projectile = ProjectilePool->Acquire(ASummerTPSProjectile::StaticClass(), MuzzleTransform, Shooter, nullptr))
+			{
+				// Stays below the target's health so it never dies
+				Projectile->Damage = 1.0f;
+				Projectile->OnHit(Projectile->GetCollisionComp(), Target, Target->GetCapsuleComponent(), FVector::ZeroVector, Hit);
+			}
+		});
+
+	TestEqual(TEXT("Projectiles in flight after the last hit"), ProjectilePool->GetNumInFlight(), 0);
+	ReportMicrobenchmark(*this, Result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHealthDamageMicrobenchmark, "SummerTPS.Benchmark.HealthTakeDamage", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHealthDamageMicrobenchmark::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld BenchmarkWorld;
+	UWorld* World = BenchmarkWorld.GetWorld();
+
+	AEnemyCharacter* Target = World->SpawnActor<AEnemyCharacter>(AEnemyCharacter::StaticClass(), FTransform::Identity);
+	if (!TestNotNull(TEXT("Target"), Target) || !TestNotNull(TEXT("Health component"), Target->GetHealthComponent()))
+	{
+		return false;
+	}
+
+	UHealthComponent* TargetHealth = Target->GetHealthComponent();
+
+	// Health update, influence map damage stamp and the OnHealthChanged broadcast to AEnemyCharacter
+	FMicrobenchmark Benchmark(TEXT("HealthTakeDamage"), 10000);
+	const FMicrobenchmarkResult Result = Benchmark.Run(
+		[TargetHealth](int32) { TargetHealth->SetHealth(TargetHealth->GetDefaultHealth()); },
+		[TargetHealth](int32) { FSummerTPSBenchmarkAccess::HandleTakeAnyDamage(*TargetHealth, 1.0f); });
+
+	ReportMicrobenchmark(*this, Result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpawnEnemyMicrobenchmark, "SummerTPS.Benchmark.SpawnEnemy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FSpawnEnemyMicrobenchmark::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld BenchmarkWorld;
+	UWorld* World = BenchmarkWorld.GetWorld();
+
+	AEnemySpawner* Spawner = World->SpawnActorDeferred<AEnemySpawner>(AEnemySpawner::StaticClass(), FTransform::Identity);
+	if (!TestNotNull(TEXT("Spawner"), Spawner))
+	{
+		return false;
+	}
+
+	Spawner->EnemyClass = AEnemyCharacter::StaticClass();
+	Spawner->bSpawnOnBeginPlay = false;
+
+	// Tolerance 0: the ground trace and the spawn both happen inside SpawnEnemy, so one call is one whole enemy
+	Spawner->GroundTraceMaxLatencyFrames = 0;
+	Spawner->FinishSpawning(FTransform::Identity);
+
+	UActorRegistrySubsystem* Registry = World->GetSubsystem<UActorRegistrySubsystem>();
+
+	// Spawning thousands of characters would measure memory growth, not the spawn; each iteration starts from an empty level
+	FMicrobenchmark Benchmark(TEXT("SpawnEnemy"), 300);
+	const FMicrobenchmarkResult Result = Benchmark.Run(
+		[Spawner, Registry](int32)
+		{
+			TArray<AEnemyCharacter*> Enemies;
+			Registry->ForEachActor<AEnemyCharacter>([&Enemies](AEnemyCharacter* Enemy) { Enemies.Add(Enemy); });
+			for (AEnemyCharacter* Enemy : Enemies)
+			{
+				Enemy->Destroy();
+			}
+			FSummerTPSBenchmarkAccess::ResetSpawner(*Spawner);
+		},
+		[Spawner](int32) { FSummerTPSBenchmarkAccess::SpawnEnemy(*Spawner); });
+
+	ReportMicrobenchmark(*this, Result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerceptionUpdateMicrobenchmark, "SummerTPS.Benchmark.PerceptionUpdate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FPerceptionUpdateMicrobenchmark::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld BenchmarkWorld;
+	UWorld* World = BenchmarkWorld.GetWorld();
+
+	AEnemyCharacter* Enemy = GameplayMicrobenchmarks::SpawnEnemyWithBlackboard(World, FVector::ZeroVector);
+	AActor* Target = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(FVector(500.f, 0.f, 0.f)));
+	if (!TestNotNull(TEXT("Enemy"), Enemy) || !TestNotNull(TEXT("Target"), Target))
+	{
+		return false;
+	}
+
+	// With the batched decision phase on (the default) OnPerceptionUpdated only records the stimulus; this times the direct path
+	GameplayMicrobenchmarks::FScopedConsoleVariableOverride DirectPerception(TEXT("summer.AI.ParallelDecisions"), TEXT("0"));
+
+	const UAISense& Sight = *GetDefault<UAISense_Sight>();
+	const FAIStimulus Sensed(Sight, 1.0f, Target->GetActorLocation(), Enemy->GetActorLocation(), FAIStimulus::SensingSucceeded);
+	const FAIStimulus Lost(Sight, 1.0f, Target->GetActorLocation(), Enemy->GetActorLocation(), FAIStimulus::SensingFailed);
+
+	// Alternates between spotting and losing the target, i.e. a TargetActor write and a clear
+	FMicrobenchmark Benchmark(TEXT("PerceptionUpdate"), 10000);
+	const FMicrobenchmarkResult Result = Benchmark.Run(
+		[&](int32 Iteration) { FSummerTPSBenchmarkAccess::OnPerceptionUpdated(*Enemy, Target, Iteration % 2 == 0 ? Sensed : Lost); });
+
+	ReportMicrobenchmark(*this, Result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrajectoryPredictionMicrobenchmark, "SummerTPS.Benchmark.TrajectoryPrediction", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTrajectoryPredictionMicrobenchmark::RunTest(const FString& Parameters)
+{
+	FMicrobenchmarkWorld BenchmarkWorld;
+	UWorld* World = BenchmarkWorld.GetWorld();
+
+	ATPSPlayer* Player = World->SpawnActor<ATPSPlayer>(ATPSPlayer::StaticClass(), FTransform::Identity);
+	AActor* Weapon = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	if (!TestNotNull(TEXT("Player"), Player) || !TestNotNull(TEXT("Weapon"), Weapon))
+	{
+		return false;
+	}
+
+	FSummerTPSBenchmarkAccess::SetUpShooter(*Player, Weapon);
+
+	const FVector MuzzleLocation = FSummerTPSBenchmarkAccess::GetMuzzleLocation(*Player);
+	const FVector LaunchVelocity = Player->GetActorForwardVector() * FSummerTPSBenchmarkAccess::GetProjectilePredictionSpeed(*Player);
+
+	// Same parameters as the fallback path of ATPSPlayer::Tick. The level is empty, so every prediction runs the full 5 seconds of arc
+	FMicrobenchmark Benchmark(TEXT("TrajectoryPrediction"), 1000);
+	const FMicrobenchmarkResult Result = Benchmark.Run(
+		[&](int32)
+		{
+			FPredictProjectilePathParams PredictParams(20.f, MuzzleLocation, LaunchVelocity, 5.f, ECC_Visibility);
+			FPredictProjectilePathResult PredictResult;
+			UGameplayStatics::PredictProjectilePath(Player, PredictParams, PredictResult);
+		});
+
+	ReportMicrobenchmark(*this, Result);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,257 @@
+#include "Microbenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/PlatformTLS.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace Microbenchmark
+{
+	/**
+	 * Forwards everything to the allocator it wraps and counts the allocations of one thread while counting is on.
+	 * Lives for the whole process: another thread may still hold it as GMalloc after it was swapped back out.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		void Install()
+		{
+			check(IsInGameThread() && GMalloc != this);
+			Inner = GMalloc;
+			CountedThreadId = FPlatformTLS::GetCurrentThreadId();
+			GMalloc = this;
+		}
+
+		void Uninstall()
+		{
+			check(IsInGameThread() && GMalloc == this);
+			GMalloc = Inner;
+		}
+
+		void Begin()
+		{
+			NumAllocations = 0;
+			NumBytes = 0;
+			bCounting = true;
+		}
+
+		void End()
+		{
+			bCounting = false;
+		}
+
+		uint64 GetNumAllocations() const { return NumAllocations; }
+		uint64 GetNumBytes() const { return NumBytes; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT) override
+		{
+			Record(Count);
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT) override
+		{
+			Record(Count);
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT) override
+		{
+			RecordRealloc(Original, Count);
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment = DEFAULT_ALIGNMENT) override
+		{
+			RecordRealloc(Original, Count);
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("SummerTPS microbenchmark allocation counter"); }
+
+	private:
+		void Record(SIZE_T Size)
+		{
+			// Only reads of the flag and thread id on other threads, the counters are touched by the counted thread alone
+			if (bCounting && FPlatformTLS::GetCurrentThreadId() == CountedThreadId)
+			{
+				NumAllocations++;
+				NumBytes += Size;
+			}
+		}
+
+		/** Shrinks and Realloc(Ptr, 0) frees aren't allocations; growth counts its extra bytes */
+		void RecordRealloc(void* Original, SIZE_T Count)
+		{
+			if (!Original)
+			{
+				Record(Count);
+				return;
+			}
+
+			SIZE_T OldSize = 0;
+			if (Count > 0 && (!Inner->GetAllocationSize(Original, OldSize) || Count > OldSize))
+			{
+				Record(Count - FMath::Min(OldSize, Count));
+			}
+		}
+
+		FMalloc* Inner = nullptr;
+		uint32 CountedThreadId = 0;
+		volatile bool bCounting = false;
+		uint64 NumAllocations = 0;
+		uint64 NumBytes = 0;
+	};
+
+	static FCountingMalloc& GetCountingMalloc()
+	{
+		static FCountingMalloc CountingMalloc;
+		return CountingMalloc;
+	}
+
+	static double Percentile(const TArray<double>& SortedSamples, int32 Percent)
+	{
+		const int32 Index = FMath::Min(SortedSamples.Num() * Percent / 100, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+}
+
+FMicrobenchmark::FMicrobenchmark(const TCHAR* InName, int32 InIterations, int32 InWarmupIterations)
+	: Name(InName)
+	, Iterations(FMath::Max(InIterations, 1))
+	, WarmupIterations(InWarmupIterations >= 0 ? InWarmupIterations : FMath::Max(InIterations / 10, 1))
+{
+}
+
+FMicrobenchmarkResult FMicrobenchmark::Run(TFunctionRef<void(int32 Iteration)> Setup, TFunctionRef<void(int32 Iteration)> Operation)
+{
+	for (int32 Iteration = 0; Iteration < WarmupIterations; ++Iteration)
+	{
+		Setup(Iteration);
+		Operation(Iteration);
+	}
+
+	// Allocated up front, the harness itself must not show up in the counts
+	TArray<double> Samples;
+	Samples.SetNumUninitialized(Iterations);
+	uint64 TotalAllocations = 0;
+	uint64 TotalBytes = 0;
+
+	Microbenchmark::FCountingMalloc& CountingMalloc = Microbenchmark::GetCountingMalloc();
+	CountingMalloc.Install();
+
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		Setup(WarmupIterations + Iteration);
+
+		CountingMalloc.Begin();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Operation(WarmupIterations + Iteration);
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		CountingMalloc.End();
+
+		Samples[Iteration] = FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1000000.0;
+		TotalAllocations += CountingMalloc.GetNumAllocations();
+		TotalBytes += CountingMalloc.GetNumBytes();
+	}
+
+	CountingMalloc.Uninstall();
+
+	FMicrobenchmarkResult Result;
+	Result.Name = Name;
+	Result.Iterations = Iterations;
+
+	double Total = 0.0;
+	for (double Sample : Samples)
+	{
+		Total += Sample;
+	}
+	Samples.Sort();
+
+	Result.MeanUs = Total / Iterations;
+	Result.P50Us = Microbenchmark::Percentile(Samples, 50);
+	Result.P99Us = Microbenchmark::Percentile(Samples, 99);
+	Result.MinUs = Samples[0];
+	Result.MaxUs = Samples.Last();
+	Result.AllocationsPerOp = (double)TotalAllocations / Iterations;
+	Result.AllocatedBytesPerOp = (double)TotalBytes / Iterations;
+	return Result;
+}
+
+void ReportMicrobenchmark(FAutomationTestBase& Test, const FMicrobenchmarkResult& Result)
+{
+	Test.AddInfo(FString::Printf(TEXT("%s: %d iterations, mean %.3f us, p50 %.3f us, p99 %.3f us, min %.3f us, max %.3f us, %.2f allocations (%.0f bytes) per op"),
+		*Result.Name, Result.Iterations, Result.MeanUs, Result.P50Us, Result.P99Us, Result.MinUs, Result.MaxUs, Result.AllocationsPerOp, Result.AllocatedBytesPerOp));
+
+	const FString Json = FString::Printf(
+		TEXT("{\n")
+		TEXT("\t\"name\": \"%s\",\n")
+		TEXT("\t\"timestamp\": \"%s\",\n")
+		TEXT("\t\"build_configuration\": \"%s\",\n")
+		TEXT("\t\"platform\": \"%s\",\n")
+		TEXT("\t\"iterations\": %d,\n")
+		TEXT("\t\"mean_us\": %.4f,\n")
+		TEXT("\t\"p50_us\": %.4f,\n")
+		TEXT("\t\"p99_us\": %.4f,\n")
+		TEXT("\t\"min_us\": %.4f,\n")
+		TEXT("\t\"max_us\": %.4f,\n")
+		TEXT("\t\"allocations_per_op\": %.4f,\n")
+		TEXT("\t\"allocated_bytes_per_op\": %.1f\n")
+		TEXT("}\n"),
+		*Result.Name,
+		*FDateTime::UtcNow().ToIso8601(),
+		LexToString(FApp::GetBuildConfiguration()),
+		ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()),
+		Result.Iterations,
+		Result.MeanUs,
+		Result.P50Us,
+		Result.P99Us,
+		Result.MinUs,
+		Result.MaxUs,
+		Result.AllocationsPerOp,
+		Result.AllocatedBytesPerOp);
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / Result.Name + TEXT(".json");
+	if (!FFileHelper::SaveStringToFile(Json, *Path))
+	{
+		Test.AddWarning(FString::Printf(TEXT("Could not write %s"), *Path));
+	}
+}
+
+FMicrobenchmarkWorld::FMicrobenchmarkWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("MicrobenchmarkWorld"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+}
+
+FMicrobenchmarkWorld::~FMicrobenchmarkWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+
+class UWorld;
+
+/**
+ * Harness for the SummerTPS.Benchmark.* automation tests.
+ *
+ * Run headless with e.g.
+ *   UnrealEditor-Cmd SummerTPS.uproject -ExecCmds="Automation RunTests SummerTPS.Benchmark; Quit" -unattended -nullrhi -nosplash
+ * Each benchmark logs its numbers to the test output and writes Saved/Benchmarks/<Name>.json, so runs before and after
+ * an optimization can be diffed by a script.
+ */
+
+/** Per-operation numbers of one benchmark. Times are in microseconds */
+struct FMicrobenchmarkResult
+{
+	FString Name;
+	int32 Iterations = 0;
+	double MeanUs = 0.0;
+	double P50Us = 0.0;
+	double P99Us = 0.0;
+	double MinUs = 0.0;
+	double MaxUs = 0.0;
+
+	/** Game thread heap allocations (Malloc and growing Realloc) per operation */
+	double AllocationsPerOp = 0.0;
+	double AllocatedBytesPerOp = 0.0;
+};
+
+/**
+ * Times an operation over many iterations on the game thread.
+ * Setup runs before every iteration outside the timed region, Operation is timed on its own, and the allocations
+ * it makes on the game thread are counted by temporarily routing GMalloc through a counting proxy.
+ */
+class FMicrobenchmark
+{
+public:
+	FMicrobenchmark(const TCHAR* InName, int32 InIterations, int32 InWarmupIterations = -1);
+
+	FMicrobenchmarkResult Run(TFunctionRef<void(int32 Iteration)> Setup, TFunctionRef<void(int32 Iteration)> Operation);
+
+	FMicrobenchmarkResult Run(TFunctionRef<void(int32 Iteration)> Operation)
+	{
+		return Run([](int32) {}, Operation);
+	}
+
+private:
+	FString Name;
+	int32 Iterations;
+
+	/** Untimed iterations first, so pools and caches are warm (defaults to a tenth of Iterations) */
+	int32 WarmupIterations;
+};
+
+/** Adds the result to the test's output and writes Saved/Benchmarks/<Name>.json */
+void ReportMicrobenchmark(FAutomationTestBase& Test, const FMicrobenchmarkResult& Result);
+
+/** A bare game world with begun play and the SummerTPS world subsystems, destroyed with the object */
+class FMicrobenchmarkWorld
+{
+public:
+	FMicrobenchmarkWorld();
+	~FMicrobenchmarkWorld();
+
+	UWorld* GetWorld() const { return World; }
+
+private:
+	UWorld* World;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
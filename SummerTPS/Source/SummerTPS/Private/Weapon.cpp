@@ -11,6 +11,11 @@ AWeapon::AWeapon()
     Mesh->SetupAttachment(Root);
 }
 
+bool AWeapon::CanBeInCluster() const
+{
+    return GetOwner() && GetOwner()->CanBeInCluster();
+}
+
 void AWeapon::Fire()
 {
     // Base fire logic (can be overridden)
@@ -0,0 +1,204 @@
+#include "WetnessSubsystem.h"
+#include "SummerTPS.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Wetness Tick"), STAT_Wetness_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wetness Hits"), STAT_Wetness_Hits, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wetness Material Pushes"), STAT_Wetness_Pushes, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wetness Pushes Skipped"), STAT_Wetness_Skipped, STATGROUP_SummerTPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Wet Characters"), STAT_Wetness_Characters, STATGROUP_SummerTPS);
+
+UWetnessSubsystem::UWetnessSubsystem()
+{
+	DryingHalfLife = 8.0f;
+	QuantizationLevels = 16;
+	CustomPrimitiveDataIndex = 0;
+}
+
+bool UWetnessSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UWetnessSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWetnessSubsystem, STATGROUP_Tickables);
+}
+
+EWetnessRegion UWetnessSubsystem::GetRegionForHit(const ACharacter* Character, const FVector& HitLocation, FName BoneName)
+{
+	if (!BoneName.IsNone())
+	{
+		const FString Bone = BoneName.ToString();
+		if (Bone.Contains(TEXT("head")) || Bone.Contains(TEXT("neck")))
+		{
+			return EWetnessRegion::Head;
+		}
+		if (Bone.Contains(TEXT("arm")) || Bone.Contains(TEXT("hand")) || Bone.Contains(TEXT("clavicle")))
+		{
+			return EWetnessRegion::Arms;
+		}
+		if (Bone.Contains(TEXT("thigh")) || Bone.Contains(TEXT("calf")) || Bone.Contains(TEXT("foot")) || Bone.Contains(TEXT("leg")))
+		{
+			return EWetnessRegion::Legs;
+		}
+		return EWetnessRegion::Torso;
+	}
+
+	// Projectiles usually hit the capsule, which has no bones; split it by height instead
+	const float HalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const float Height = (HitLocation.Z - Character->GetActorLocation().Z + HalfHeight) / FMath::Max(2.0f * HalfHeight, 1.0f);
+	if (Height > 0.85f)
+	{
+		return EWetnessRegion::Head;
+	}
+	return Height < 0.45f ? EWetnessRegion::Legs : EWetnessRegion::Torso;
+}
+
+void UWetnessSubsystem::AddWater(ACharacter* Character, const FVector& HitLocation, FName BoneName, float Amount)
+{
+	if (!Character || Amount <= 0.0f)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_Wetness_Hits);
+
+	FCharacterWetness* Wetness = WetCharacters.FindByPredicate([Character](const FCharacterWetness& Entry) { return Entry.Character.Get() == Character; });
+	if (!Wetness)
+	{
+		Wetness = &WetCharacters.AddDefaulted_GetRef();
+		Wetness->Character = Character;
+	}
+
+	// Folding the drying so far into the stored value keeps the decay a function of one timestamp per region
+	const double Now = GetWorld()->GetTimeSeconds();
+	const int32 Region = (int32)GetRegionForHit(Character, HitLocation, BoneName);
+	Wetness->Value[Region] = FMath::Min(Evaluate(*Wetness, Region, Now) + Amount, 1.0f);
+	Wetness->UpdateTime[Region] = Now;
+	Wetness->bDirty = true;
+}
+
+void UWetnessSubsystem::ClearCharacter(ACharacter* Character)
+{
+	const int32 Index = WetCharacters.IndexOfByPredicate([Character](const FCharacterWetness& Entry) { return Entry.Character.Get() == Character; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		Mesh->SetCustomPrimitiveDataVector4(CustomPrimitiveDataIndex, FVector4(0.0f, 0.0f, 0.0f, 0.0f));
+		INC_DWORD_STAT(STAT_Wetness_Pushes);
+	}
+
+	WetCharacters.RemoveAtSwap(Index, 1, false);
+}
+
+float UWetnessSubsystem::GetWetness(const ACharacter* Character, EWetnessRegion Region) const
+{
+	const FCharacterWetness* Wetness = Find(Character);
+	if (!Wetness || Region == EWetnessRegion::Count)
+	{
+		return 0.0f;
+	}
+
+	return Evaluate(*Wetness, (int32)Region, GetWorld()->GetTimeSeconds());
+}
+
+const UWetnessSubsystem::FCharacterWetness* UWetnessSubsystem::Find(const ACharacter* Character) const
+{
+	return WetCharacters.FindByPredicate([Character](const FCharacterWetness& Entry) { return Entry.Character.Get() == Character; });
+}
+
+float UWetnessSubsystem::Evaluate(const FCharacterWetness& Wetness, int32 Region, double Now) const
+{
+	const double Elapsed = FMath::Max(Now - Wetness.UpdateTime[Region], 0.0);
+	return Wetness.Value[Region] * (float)FMath::Exp2(-Elapsed / DryingHalfLife);
+}
+
+uint8 UWetnessSubsystem::Quantize(float Value) const
+{
+	return (uint8)FMath::Clamp(FMath::RoundToInt(Value * (QuantizationLevels - 1)), 0, QuantizationLevels - 1);
+}
+
+void UWetnessSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Wetness_Tick);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	for (int32 Index = WetCharacters.Num() - 1; Index >= 0; --Index)
+	{
+		FCharacterWetness& Wetness = WetCharacters[Index];
+		if (!Wetness.Character.IsValid())
+		{
+			WetCharacters.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		// Between hits nothing changes on screen until drying crosses the next level
+		if (!Wetness.bDirty && Now < Wetness.NextLevelChangeTime)
+		{
+			continue;
+		}
+
+		if (!Push(Wetness, Now))
+		{
+			WetCharacters.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_Wetness_Characters, WetCharacters.Num());
+}
+
+bool UWetnessSubsystem::Push(FCharacterWetness& Wetness, double Now)
+{
+	Wetness.bDirty = false;
+	Wetness.NextLevelChangeTime = TNumericLimits<double>::Max();
+
+	const float LevelScale = 1.0f / (QuantizationLevels - 1);
+	bool bChanged = false;
+	bool bWet = false;
+	uint8 Levels[NumRegions];
+
+	for (int32 Region = 0; Region < NumRegions; ++Region)
+	{
+		Levels[Region] = Quantize(Evaluate(Wetness, Region, Now));
+		bChanged |= Levels[Region] != Wetness.PushedLevel[Region];
+
+		if (Levels[Region] > 0)
+		{
+			bWet = true;
+
+			// Rounding drops a level once the value falls below half a step under it
+			const float Threshold = (Levels[Region] - 0.5f) * LevelScale;
+			const double ChangeTime = Wetness.UpdateTime[Region] + DryingHalfLife * FMath::Log2(Wetness.Value[Region] / Threshold);
+			Wetness.NextLevelChangeTime = FMath::Min(Wetness.NextLevelChangeTime, ChangeTime);
+		}
+	}
+
+	if (!bChanged)
+	{
+		INC_DWORD_STAT(STAT_Wetness_Skipped);
+		return bWet;
+	}
+
+	// One vector for all regions is a single render state update, and no dynamic material instances are needed
+	if (USkeletalMeshComponent* Mesh = Wetness.Character->GetMesh())
+	{
+		Mesh->SetCustomPrimitiveDataVector4(CustomPrimitiveDataIndex, FVector4(
+			Levels[(int32)EWetnessRegion::Head] * LevelScale,
+			Levels[(int32)EWetnessRegion::Torso] * LevelScale,
+			Levels[(int32)EWetnessRegion::Arms] * LevelScale,
+			Levels[(int32)EWetnessRegion::Legs] * LevelScale));
+		INC_DWORD_STAT(STAT_Wetness_Pushes);
+	}
+
+	FMemory::Memcpy(Wetness.PushedLevel, Levels, sizeof(Levels));
+	return bWet;
+}
@@ -0,0 +1,312 @@
+#include "WorldQuerySchedulerSubsystem.h"
+#include "SummerTPS.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("World Query Scheduler Tick"), STAT_WorldQuery_Tick, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Async Issued"), STAT_WorldQuery_AsyncIssued, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Over Budget"), STAT_WorldQuery_OverBudget, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Deferred"), STAT_WorldQuery_Deferred, STATGROUP_SummerTPS);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Player Movement"), STAT_WorldQuery_Count_PlayerMovement, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Player Cover"), STAT_WorldQuery_Count_PlayerCover, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Trajectory Preview"), STAT_WorldQuery_Count_TrajectoryPreview, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries Spawning"), STAT_WorldQuery_Count_Spawning, STATGROUP_SummerTPS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Queries AI"), STAT_WorldQuery_Count_AI, STATGROUP_SummerTPS);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("World Query ms Player Movement"), STAT_WorldQuery_Ms_PlayerMovement, STATGROUP_SummerTPS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("World Query ms Player Cover"), STAT_WorldQuery_Ms_PlayerCover, STATGROUP_SummerTPS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("World Query ms Trajectory Preview"), STAT_WorldQuery_Ms_TrajectoryPreview, STATGROUP_SummerTPS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("World Query ms Spawning"), STAT_WorldQuery_Ms_Spawning, STATGROUP_SummerTPS);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("World Query ms AI"), STAT_WorldQuery_Ms_AI, STATGROUP_SummerTPS);
+
+namespace WorldQueryScheduler
+{
+	static void ForEachScheduler(UWorld* World, TFunctionRef<void(UWorldQuerySchedulerSubsystem&)> Func)
+	{
+		if (UWorldQuerySchedulerSubsystem* Scheduler = World ? World->GetSubsystem<UWorldQuerySchedulerSubsystem>() : nullptr)
+		{
+			Func(*Scheduler);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("summer.WorldQuery.Report"),
+		TEXT("Prints per-category world query counts, synchronous time and async latency since the last reset."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			ForEachScheduler(World, [](UWorldQuerySchedulerSubsystem& Scheduler) { Scheduler.ReportStats(); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs ResetCommand(
+		TEXT("summer.WorldQuery.Reset"),
+		TEXT("Clears the accumulated world query statistics."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>&, UWorld* World)
+		{
+			ForEachScheduler(World, [](UWorldQuerySchedulerSubsystem& Scheduler) { Scheduler.ResetStats(); });
+		}));
+}
+
+UWorldQuerySchedulerSubsystem::UWorldQuerySchedulerSubsystem()
+{
+	MaxAsyncQueriesPerFrame = 32;
+	NextQueryId = 0;
+	NumReportedFrames = 0;
+}
+
+void UWorldQuerySchedulerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	AsyncQueryDelegate.BindUObject(this, &UWorldQuerySchedulerSubsystem::OnAsyncQueryDone);
+}
+
+void UWorldQuerySchedulerSubsystem::Deinitialize()
+{
+	// Pending callbacks may reference actors of the world going away; drop them without completing
+	PendingQueries.Empty();
+	InFlightQueries.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UWorldQuerySchedulerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UWorldQuerySchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWorldQuerySchedulerSubsystem, STATGROUP_Tickables);
+}
+
+bool UWorldQuerySchedulerSubsystem::LineTraceNow(EWorldQueryCategory Category, FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params)
+{
+	FScopedQuery Scope(this, Category);
+	return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, Channel, Params);
+}
+
+bool UWorldQuerySchedulerSubsystem::SweepNow(EWorldQueryCategory Category, FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape, const FCollisionQueryParams& Params)
+{
+	FScopedQuery Scope(this, Category);
+	return GetWorld()->SweepSingleByChannel(OutHit, Start, End, Rotation, Channel, Shape, Params);
+}
+
+void UWorldQuerySchedulerSubsystem::RecordExternalQuery(EWorldQueryCategory Category, double Seconds)
+{
+	FCategoryFrame& Frame = CurrentFrame[(int32)Category];
+	Frame.NumSync++;
+	Frame.SyncSeconds += Seconds;
+}
+
+void UWorldQuerySchedulerSubsystem::SubmitLineTrace(EWorldQueryCategory Category, const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params, int32 MaxLatencyFrames, FWorldQueryCallback&& Callback)
+{
+	FPendingQuery Query{ Start, End, FQuat::Identity, FCollisionShape(), Params, Channel, Category, false, 0, 0, MoveTemp(Callback) };
+	Submit(MoveTemp(Query), MaxLatencyFrames);
+}
+
+void UWorldQuerySchedulerSubsystem::SubmitSweep(EWorldQueryCategory Category, const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape, const FCollisionQueryParams& Params, int32 MaxLatencyFrames, FWorldQueryCallback&& Callback)
+{
+	FPendingQuery Query{ Start, End, Rotation, Shape, Params, Channel, Category, true, 0, 0, MoveTemp(Callback) };
+	Submit(MoveTemp(Query), MaxLatencyFrames);
+}
+
+void UWorldQuerySchedulerSubsystem::Submit(FPendingQuery&& Query, int32 MaxLatencyFrames)
+{
+	Query.SubmitFrame = GFrameCounter;
+	Query.DeadlineFrame = GFrameCounter + FMath::Max(0, MaxLatencyFrames);
+
+	// Async results arrive the frame after they are issued, so a query that can't wait a frame runs right here
+	if (MaxLatencyFrames <= 0)
+	{
+		RunNow(Query);
+		return;
+	}
+
+	PendingQueries.Add(MoveTemp(Query));
+}
+
+void UWorldQuerySchedulerSubsystem::RunNow(FPendingQuery& Query)
+{
+	FWorldQueryResult Result;
+	Result.bBlockingHit = Query.bSweep
+		? SweepNow(Query.Category, Result.Hit, Query.Start, Query.End, Query.Rotation, Query.Channel, Query.Shape, Query.Params)
+		: LineTraceNow(Query.Category, Result.Hit, Query.Start, Query.End, Query.Channel, Query.Params);
+	Result.LatencyFrames = (int32)(GFrameCounter - Query.SubmitFrame);
+
+	if (Query.Callback)
+	{
+		Query.Callback(Result);
+	}
+}
+
+void UWorldQuerySchedulerSubsystem::IssueAsync(FPendingQuery& Query)
+{
+	const uint32 QueryId = NextQueryId++;
+	InFlightQueries.Add(QueryId, FInFlightQuery{ MoveTemp(Query.Callback), Query.Category, Query.SubmitFrame });
+
+	if (Query.bSweep)
+	{
+		GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, Query.Start, Query.End, Query.Rotation, Query.Channel, Query.Shape, Query.Params,
+			FCollisionResponseParams::DefaultResponseParam, &AsyncQueryDelegate, QueryId);
+	}
+	else
+	{
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Query.Start, Query.End, Query.Channel, Query.Params,
+			FCollisionResponseParams::DefaultResponseParam, &AsyncQueryDelegate, QueryId);
+	}
+
+	CurrentFrame[(int32)Query.Category].NumAsync++;
+}
+
+void UWorldQuerySchedulerSubsystem::OnAsyncQueryDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FInFlightQuery* Found = InFlightQueries.Find(Datum.UserData);
+	if (!Found)
+	{
+		return;
+	}
+
+	FInFlightQuery InFlight = MoveTemp(*Found);
+	InFlightQueries.Remove(Datum.UserData);
+
+	FWorldQueryResult Result;
+	if (Datum.OutHits.Num() > 0)
+	{
+		Result.Hit = Datum.OutHits[0];
+		Result.bBlockingHit = Result.Hit.bBlockingHit;
+	}
+	Result.LatencyFrames = (int32)(GFrameCounter - InFlight.SubmitFrame);
+
+	FCategoryTotals& CategoryTotals = Totals[(int32)InFlight.Category];
+	CategoryTotals.NumCompletedAsync++;
+	CategoryTotals.TotalLatencyFrames += Result.LatencyFrames;
+
+	if (InFlight.Callback)
+	{
+		InFlight.Callback(Result);
+	}
+}
+
+void UWorldQuerySchedulerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WorldQuery_Tick);
+
+	if (PendingQueries.Num() > 0)
+	{
+		// Callbacks of queries run here may submit new ones, so schedule from a separate array
+		Swap(PendingQueries, SchedulingQueries);
+
+		// Earliest deadline first; stable so queries with the same deadline keep their submission order
+		SchedulingQueries.StableSort([](const FPendingQuery& A, const FPendingQuery& B) { return A.DeadlineFrame < B.DeadlineFrame; });
+
+		const uint64 Frame = GFrameCounter;
+		int32 NumIssued = 0;
+		int32 NumOverBudget = 0;
+		int32 NumHandled = 0;
+
+		for (FPendingQuery& Query : SchedulingQueries)
+		{
+			if (Query.DeadlineFrame <= Frame)
+			{
+				// Submitted after this frame's scheduling with no slack left; an async result would be late
+				RunNow(Query);
+			}
+			else if (NumIssued < MaxAsyncQueriesPerFrame)
+			{
+				IssueAsync(Query);
+				++NumIssued;
+			}
+			else if (Query.DeadlineFrame == Frame + 1)
+			{
+				// Would miss its tolerance if it waited for next frame's budget
+				IssueAsync(Query);
+				CurrentFrame[(int32)Query.Category].NumOverBudget++;
+				++NumOverBudget;
+			}
+			else
+			{
+				// Sorted by deadline: everything after this one can wait as well
+				break;
+			}
+			++NumHandled;
+		}
+
+		for (int32 Index = NumHandled; Index < SchedulingQueries.Num(); ++Index)
+		{
+			PendingQueries.Add(MoveTemp(SchedulingQueries[Index]));
+		}
+		SchedulingQueries.Reset();
+
+		INC_DWORD_STAT_BY(STAT_WorldQuery_AsyncIssued, NumIssued + NumOverBudget);
+		INC_DWORD_STAT_BY(STAT_WorldQuery_OverBudget, NumOverBudget);
+	}
+
+	SET_DWORD_STAT(STAT_WorldQuery_Deferred, PendingQueries.Num());
+
+	PublishFrameStats();
+}
+
+void UWorldQuerySchedulerSubsystem::PublishFrameStats()
+{
+	auto CountOf = [this](EWorldQueryCategory Category) { return CurrentFrame[(int32)Category].NumSync + CurrentFrame[(int32)Category].NumAsync; };
+	auto MsOf = [this](EWorldQueryCategory Category) { return (float)(CurrentFrame[(int32)Category].SyncSeconds * 1000.0); };
+
+	SET_DWORD_STAT(STAT_WorldQuery_Count_PlayerMovement, CountOf(EWorldQueryCategory::PlayerMovement));
+	SET_DWORD_STAT(STAT_WorldQuery_Count_PlayerCover, CountOf(EWorldQueryCategory::PlayerCover));
+	SET_DWORD_STAT(STAT_WorldQuery_Count_TrajectoryPreview, CountOf(EWorldQueryCategory::TrajectoryPreview));
+	SET_DWORD_STAT(STAT_WorldQuery_Count_Spawning, CountOf(EWorldQueryCategory::Spawning));
+	SET_DWORD_STAT(STAT_WorldQuery_Count_AI, CountOf(EWorldQueryCategory::AI));
+
+	SET_FLOAT_STAT(STAT_WorldQuery_Ms_PlayerMovement, MsOf(EWorldQueryCategory::PlayerMovement));
+	SET_FLOAT_STAT(STAT_WorldQuery_Ms_PlayerCover, MsOf(EWorldQueryCategory::PlayerCover));
+	SET_FLOAT_STAT(STAT_WorldQuery_Ms_TrajectoryPreview, MsOf(EWorldQueryCategory::TrajectoryPreview));
+	SET_FLOAT_STAT(STAT_WorldQuery_Ms_Spawning, MsOf(EWorldQueryCategory::Spawning));
+	SET_FLOAT_STAT(STAT_WorldQuery_Ms_AI, MsOf(EWorldQueryCategory::AI));
+
+	// Queries issued after this tick (later tick groups) land in the next frame's numbers
+	for (int32 Index = 0; Index < (int32)EWorldQueryCategory::Count; ++Index)
+	{
+		const FCategoryFrame& Frame = CurrentFrame[Index];
+		FCategoryTotals& CategoryTotals = Totals[Index];
+		CategoryTotals.NumSync += Frame.NumSync;
+		CategoryTotals.NumAsync += Frame.NumAsync;
+		CategoryTotals.NumOverBudget += Frame.NumOverBudget;
+		CategoryTotals.SyncSeconds += Frame.SyncSeconds;
+		CategoryTotals.PeakFrameSyncSeconds = FMath::Max(CategoryTotals.PeakFrameSyncSeconds, Frame.SyncSeconds);
+		CategoryTotals.PeakFrameQueries = FMath::Max(CategoryTotals.PeakFrameQueries, Frame.NumSync + Frame.NumAsync);
+
+		CurrentFrame[Index] = FCategoryFrame();
+	}
+
+	NumReportedFrames++;
+}
+
+void UWorldQuerySchedulerSubsystem::ReportStats() const
+{
+	const UEnum* CategoryEnum = StaticEnum<EWorldQueryCategory>();
+	const double Frames = FMath::Max<int64>(NumReportedFrames, 1);
+
+	UE_LOG(LogTemp, Log, TEXT("World queries over %lld frames:"), NumReportedFrames);
+	for (int32 Index = 0; Index < (int32)EWorldQueryCategory::Count; ++Index)
+	{
+		const FCategoryTotals& CategoryTotals = Totals[Index];
+		UE_LOG(LogTemp, Log, TEXT("  %-18s sync %6.2f/frame (%.3f ms/frame, peak %.3f ms)  async %6.2f/frame (over budget %lld, avg latency %.2f frames)  peak %d queries/frame"),
+			*CategoryEnum->GetNameStringByIndex(Index),
+			CategoryTotals.NumSync / Frames,
+			CategoryTotals.SyncSeconds * 1000.0 / Frames,
+			CategoryTotals.PeakFrameSyncSeconds * 1000.0,
+			CategoryTotals.NumAsync / Frames,
+			CategoryTotals.NumOverBudget,
+			CategoryTotals.NumCompletedAsync > 0 ? (double)CategoryTotals.TotalLatencyFrames / CategoryTotals.NumCompletedAsync : 0.0,
+			CategoryTotals.PeakFrameQueries);
+	}
+}
+
+void UWorldQuerySchedulerSubsystem::ResetStats()
+{
+	for (FCategoryTotals& CategoryTotals : Totals)
+	{
+		CategoryTotals = FCategoryTotals();
+	}
+	NumReportedFrames = 0;
+}
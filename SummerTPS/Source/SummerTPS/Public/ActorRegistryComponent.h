@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ActorRegistryComponent.generated.h"
+
+/**
+ * Registers its owner with UActorRegistrySubsystem for actors without native registration, such as the BP_CoverBox cover blueprints.
+ * Tag the owner (e.g. "Cover") so it can be found through ForEachActorWithTag.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SUMMERTPS_API UActorRegistryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UActorRegistryComponent();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorRegistrySubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRegistryActorChanged, AActor*);
+
+/**
+ * Index of gameplay actors (spawners, enemies, cover, damageables) by class and by tag.
+ * Actors register themselves in BeginPlay and unregister in EndPlay, so lookups cost O(matches) instead of a scan of every actor in the world.
+ * An actor is filed under its class and every native or Blueprint parent class up to AActor, and under the tags it has when registering.
+ * Iteration runs over the internal arrays without allocating; don't register or unregister actors from inside the callback.
+ */
+UCLASS()
+class SUMMERTPS_API UActorRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterActor(AActor* Actor);
+	void UnregisterActor(AActor* Actor);
+
+	bool IsRegistered(const AActor* Actor) const { return RegisteredActors.Contains(Actor); }
+
+	/** All registered actors of Class or a subclass */
+	TConstArrayView<AActor*> GetActorsOfClass(const UClass* Class) const;
+
+	/** All registered actors that had Tag when they registered */
+	TConstArrayView<AActor*> GetActorsWithTag(FName Tag) const;
+
+	template <typename ActorType, typename FunctorType>
+	void ForEachActor(FunctorType&& Functor) const
+	{
+		for (AActor* Actor : GetActorsOfClass(ActorType::StaticClass()))
+		{
+			Functor(static_cast<ActorType*>(Actor));
+		}
+	}
+
+	/** Registered actors of ActorType carrying Tag, visits only the tag's bucket */
+	template <typename ActorType, typename FunctorType>
+	void ForEachActorWithTag(FName Tag, FunctorType&& Functor) const
+	{
+		for (AActor* Actor : GetActorsWithTag(Tag))
+		{
+			if (ActorType* Typed = Cast<ActorType>(Actor))
+			{
+				Functor(Typed);
+			}
+		}
+	}
+
+	/** Fired after an actor registered, e.g. a spawner in a sublevel that streamed in after its manager started */
+	FOnRegistryActorChanged OnActorRegistered;
+
+	/** Fired before an actor is removed from the index */
+	FOnRegistryActorChanged OnActorUnregistered;
+
+private:
+	TMap<const UClass*, TArray<AActor*>> ActorsByClass;
+
+	TMap<FName, TArray<AActor*>> ActorsByTag;
+
+	/** Tags each actor was filed under, so unregistering finds the same buckets even if the actor's Tags changed since */
+	TMap<const AActor*, TArray<FName>> RegisteredActors;
+};
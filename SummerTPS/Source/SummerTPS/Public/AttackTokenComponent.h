@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "AttackTokenComponent.generated.h"
+
+/**
+ * Limits how many attackers may attack the owning actor at the same time.
+ * Attackers ask for a token before firing. A token is held until released or until MaxHoldTime runs out,
+ * after which its slot cools down before it can be granted again. When all slots are busy, a request whose priority
+ * beats the weakest holder by PreemptPriorityMargin takes that holder's slot.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SUMMERTPS_API UAttackTokenComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UAttackTokenComponent();
+
+	/** Grants (or refreshes) a token for Attacker. Higher priority wins when slots are contended */
+	UFUNCTION(BlueprintCallable, Category = "Attack Tokens")
+	bool TryAcquireToken(AActor* Attacker, float Priority);
+
+	/** Returns the attacker's token, starting its slot cooldown */
+	UFUNCTION(BlueprintCallable, Category = "Attack Tokens")
+	void ReleaseToken(AActor* Attacker);
+
+	UFUNCTION(BlueprintCallable, Category = "Attack Tokens")
+	bool HasToken(const AActor* Attacker) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Attack Tokens")
+	int32 GetNumActiveTokens() const;
+
+protected:
+	/** Maximum number of attackers allowed at once */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attack Tokens", meta = (ClampMin = "1"))
+	int32 MaxTokens;
+
+	/** Time a released slot stays unavailable */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attack Tokens", meta = (ClampMin = "0.0"))
+	float TokenCooldown;
+
+	/** Tokens not released within this time expire on their own */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attack Tokens", meta = (ClampMin = "0.0"))
+	float MaxHoldTime;
+
+	/** How much higher a request's priority has to be to take a slot from the weakest holder */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Attack Tokens", meta = (ClampMin = "0.0"))
+	float PreemptPriorityMargin;
+
+private:
+	struct FTokenSlot
+	{
+		TWeakObjectPtr<AActor> Holder;
+		float Priority = 0.0f;
+		double AcquiredTime = 0.0;
+		double CooldownEndTime = 0.0;
+	};
+
+	/** Frees slots whose holder is gone or held the token for too long */
+	void ExpireSlots(double Now);
+
+	void FreeSlot(FTokenSlot& Slot, double Now);
+
+	TArray<FTokenSlot> Slots;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BTService_ChaseTarget.generated.h"
+
+/** Per-AI state of the chase service, stored in the behavior tree instance memory */
+struct FBTChaseTargetMemory
+{
+	/** Target the current move request was issued for */
+	TWeakObjectPtr<AActor> ChasedTarget;
+
+	/** True while a move request towards ChasedTarget is active */
+	bool bIsChasing = false;
+};
+
+/**
+ * Native chase logic for enemies.
+ * Follows the blackboard TargetActor with a goal-tracking move request, stops inside attack range
+ * and publishes whether the target is in range so the attack branch can be gated by a cheap bool decorator.
+ */
+UCLASS()
+class SUMMERTPS_API UBTService_ChaseTarget : public UBTService
+{
+	GENERATED_BODY()
+
+public:
+	UBTService_ChaseTarget();
+
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+	/** Object key holding the actor to chase */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector TargetActorKey;
+
+	/** Optional bool key set to true while the target is inside AttackRange */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector InAttackRangeKey;
+
+	/** Distance at which the enemy stops chasing and is considered in attack range */
+	UPROPERTY(EditAnywhere, Category = "Chase", meta = (ClampMin = "0.0"))
+	float AttackRange;
+
+	/** Extra distance the target has to move away before chasing resumes, avoids start/stop jitter at the range border */
+	UPROPERTY(EditAnywhere, Category = "Chase", meta = (ClampMin = "0.0"))
+	float RangeHysteresis;
+
+private:
+	void StopChasing(UBehaviorTreeComponent& OwnerComp, FBTChaseTargetMemory& Memory) const;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyAttack.generated.h"
+
+class AAIController;
+
+/** Per-AI state of the attack task, stored in the behavior tree instance memory */
+struct FBTEnemyAttackMemory
+{
+	/** Time left before the task finishes after firing (or after starting to strafe/hold) */
+	float RemainingRecoveryTime = 0.0f;
+
+	/** True when no attack token was granted and the enemy is strafing or holding instead */
+	bool bDeniedToken = false;
+};
+
+/**
+ * Native replacement for BTT_Attack.
+ * Faces the blackboard target, fires through AEnemyCharacter::TryAttack and optionally holds for a recovery time.
+ * When the target's attack token manager refuses, the enemy strafes sideways (or holds) for the recovery time and the task fails.
+ * While summer.AI.ParallelDecisions is on, the task also fails without firing until UEnemyDecisionSubsystem set AttackReadyKey
+ * (range, sight and cooldown). The gate needs a Bool "AttackReady" key in the enemy blackboard asset; without it the task
+ * attacks as before.
+ */
+UCLASS()
+class SUMMERTPS_API UBTTask_EnemyAttack : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyAttack();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+
+	/** Object key holding the actor to attack, used to set the focus before firing */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector TargetActorKey;
+
+	/** Optional Bool key written by the batched decision phase; the attack only fires while it's set */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector AttackReadyKey;
+
+	/** Time the task stays in progress after firing. 0 finishes immediately */
+	UPROPERTY(EditAnywhere, Category = "Attack", meta = (ClampMin = "0.0"))
+	float RecoveryTime;
+
+	/** Sideways distance to move when no attack token is granted. 0 holds position */
+	UPROPERTY(EditAnywhere, Category = "Attack", meta = (ClampMin = "0.0"))
+	float StrafeDistance;
+
+private:
+	void StartStrafe(AAIController& AICon, const AActor* Target) const;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_FindInfluencePosition.generated.h"
+
+UENUM()
+enum class EInfluencePositionMode : uint8
+{
+	/** Around the target, off the player's line of fire and to the target's side */
+	Flank,
+	/** Away from the target, through cells with little threat and recent damage */
+	Retreat
+};
+
+/**
+ * Picks a flanking or retreat position from UInfluenceMapSubsystem and writes it to a vector key.
+ * Reads the influence grid only, so it is cheap enough to run for every enemy instead of an EQS query with traces.
+ */
+UCLASS()
+class SUMMERTPS_API UBTTask_FindInfluencePosition : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_FindInfluencePosition();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	UPROPERTY(EditAnywhere, Category = "Influence")
+	EInfluencePositionMode Mode;
+
+	/** Object key holding the actor to flank or retreat from */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector TargetActorKey;
+
+	/** Vector key that receives the position */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector ResultKey;
+
+	/** Flank: distance band around the target to search */
+	UPROPERTY(EditAnywhere, Category = "Influence", meta = (ClampMin = "0.0", EditCondition = "Mode == EInfluencePositionMode::Flank"))
+	float MinFlankRange;
+
+	UPROPERTY(EditAnywhere, Category = "Influence", meta = (ClampMin = "0.0", EditCondition = "Mode == EInfluencePositionMode::Flank"))
+	float MaxFlankRange;
+
+	/** Retreat: radius around the pawn to search */
+	UPROPERTY(EditAnywhere, Category = "Influence", meta = (ClampMin = "0.0", EditCondition = "Mode == EInfluencePositionMode::Retreat"))
+	float RetreatSearchRadius;
+};
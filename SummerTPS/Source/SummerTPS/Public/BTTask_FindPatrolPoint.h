@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_FindPatrolPoint.generated.h"
+
+/** Per-AI state of the find patrol point task, stored in the behavior tree instance memory */
+struct FBTFindPatrolPointMemory
+{
+	/** Location the patrol radius is centered on (the pawn's location on first execution) */
+	FVector PatrolOrigin = FVector::ZeroVector;
+
+	bool bHasPatrolOrigin = false;
+};
+
+/**
+ * Native replacement for BTT_FindPatrolLocation / BTT_FindPatrolPoint.
+ * Picks a random reachable navmesh point around the pawn's patrol origin and writes it to the blackboard.
+ * While summer.AI.ParallelDecisions is on, the task hands its patrol area to the enemy, UEnemyDecisionSubsystem maintains the point
+ * inside it and the task only falls back to its own query until the first point was written.
+ */
+UCLASS()
+class SUMMERTPS_API UBTTask_FindPatrolPoint : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_FindPatrolPoint();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	/** Vector key that receives the patrol point */
+	UPROPERTY(EditAnywhere, Category = "Blackboard")
+	FBlackboardKeySelector PatrolLocationKey;
+
+	/** Radius around the patrol origin to search in */
+	UPROPERTY(EditAnywhere, Category = "Patrol", meta = (ClampMin = "0.0"))
+	float PatrolRadius;
+
+	/** If true, the radius is centered on where the pawn first patrolled instead of its current location */
+	UPROPERTY(EditAnywhere, Category = "Patrol")
+	bool bAnchorToFirstLocation;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ClothLODComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+/** Cloth solver budget at one camera distance */
+USTRUCT(BlueprintType)
+struct FClothLODLevel
+{
+	GENERATED_BODY()
+
+	/** Owners closer to the camera than this use this level or a finer one */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD")
+	float MaxDistance = 0.0f;
+
+	/** Solver iterations per substep. 0 leaves it unchanged, a level with both values at 0 restores the authored cloth config */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD", meta = (ClampMin = "0"))
+	int32 NumIterations = 0;
+
+	/** Substeps per frame. 0 leaves it unchanged */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD", meta = (ClampMin = "0"))
+	int32 NumSubsteps = 0;
+
+	/** Stop simulating entirely, cloth keeps its last pose */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD")
+	bool bSuspend = false;
+};
+
+/**
+ * Scales the cloth solver of the owner's skeletal meshes with camera distance and owner state.
+ * Meshes further away get fewer iterations and substeps or are suspended, fast camera moves drop to the coarsest simulated level,
+ * and the simulation is frozen while ATPSPlayer lerps into or out of cover.
+ * Resuming always forces a cloth teleport (and a reset after long suspensions) so the cloth doesn't snap from a stale pose.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SUMMERTPS_API UClothLODComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UClothLODComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Index into Levels currently applied, INDEX_NONE before the first update */
+	int32 GetCurrentLevel() const { return CurrentLevel; }
+
+	bool IsClothFrozen() const { return bFrozen; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	/** Levels ordered from finest to coarsest. The last level catches everything beyond the previous level's MaxDistance */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD")
+	TArray<FClothLODLevel> Levels;
+
+	/** Extra distance needed before moving to a coarser level */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD", meta = (ClampMin = "0.0"))
+	float HysteresisDistance;
+
+	/** Camera speed (cm/s) above which the coarsest non-suspended level is used */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD", meta = (ClampMin = "0.0"))
+	float FastCameraSpeed;
+
+	/** Suspensions longer than this reset the cloth on resume instead of only teleporting it */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cloth LOD", meta = (ClampMin = "0.0"))
+	float ResetAfterSuspendTime;
+
+private:
+	/** Picks the level for this frame, INDEX_NONE when the cloth should be frozen */
+	int32 ComputeLevel(float CameraDistance, float CameraSpeed) const;
+
+	void ApplyLevel(int32 NewLevel);
+	void Suspend();
+	void Resume();
+
+	UPROPERTY()
+	TArray<USkeletalMeshComponent*> ClothMeshes;
+
+	int32 CurrentLevel;
+
+	bool bFrozen;
+
+	double SuspendStartTime;
+
+	FVector LastCameraLocation;
+
+	bool bHasLastCameraLocation;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "CombatClockSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCombatStep, int64 /*StepIndex*/);
+
+/** A combat timer, either on the world timer manager or on the fixed step clock depending on the mode the world started in */
+struct FCombatTimerHandle
+{
+	FTimerHandle WorldHandle;
+	int32 StepTimerId = INDEX_NONE;
+
+	void Invalidate()
+	{
+		WorldHandle.Invalidate();
+		StepTimerId = INDEX_NONE;
+	}
+};
+
+/**
+ * Clock for the combat simulation. By default it's a thin wrapper over world time, the world timer manager and FMath
+ * randomness. With summer.Combat.FixedStep 1 when the map loads it runs combat in fixed steps instead: the frame's delta time
+ * is accumulated and drained in steps of FixedStepSize, at most MaxStepsPerFrame per frame (the rest is dropped, so a hitch
+ * slows combat down rather than making the next frames even longer). Combat timers (auto fire, spawning, projectile
+ * lifespans), combat time (cover transitions) and projectile flight, which carries the hits and damage, advance only on
+ * steps, and combat randomness comes from a stream seeded with summer.Combat.Seed. Projectiles stay on the game thread in
+ * this mode since the async physics results arrive on wall clock timing.
+ * That makes player fire and spawning independent of the frame rate. Character movement, enemy AI and enemy attacks still run
+ * on frame ticks, so only scenarios without them (or with them held still) take the same steps across runs.
+ * summer.Combat.Determinism 1 records a hash of the combat state after every step, 2 compares each step against the last
+ * recording and reports the first step that differs.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UCombatClockSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCombatClockSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	static UCombatClockSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Whether this world runs combat in fixed steps; decided when the world is created */
+	bool IsFixedStep() const { return bFixedStep; }
+
+	int64 GetStepIndex() const { return StepIndex; }
+
+	float GetFixedStepSize() const { return FixedStepSize; }
+
+	/** Broadcast after each fixed step's timers fired; never in the default mode */
+	FOnCombatStep OnCombatStep;
+
+	/** Seconds of combat simulated so far in fixed step mode, world time otherwise */
+	static double GetCombatTime(const UObject* WorldContextObject);
+
+	/** Same semantics as FTimerManager::SetTimer; in fixed step mode Rate and FirstDelay are rounded to whole steps */
+	static void SetTimer(const UObject* WorldContextObject, FCombatTimerHandle& Handle, FTimerDelegate Delegate, float Rate, bool bLoop, float FirstDelay = -1.0f);
+
+	template <typename ObjectType>
+	static void SetTimer(ObjectType* Object, FCombatTimerHandle& Handle, void (ObjectType::*Method)(), float Rate, bool bLoop, float FirstDelay = -1.0f)
+	{
+		SetTimer(Object, Handle, FTimerDelegate::CreateUObject(Object, Method), Rate, bLoop, FirstDelay);
+	}
+
+	static void ClearTimer(const UObject* WorldContextObject, FCombatTimerHandle& Handle);
+	static bool IsTimerActive(const UObject* WorldContextObject, const FCombatTimerHandle& Handle);
+	static float GetTimerRemaining(const UObject* WorldContextObject, const FCombatTimerHandle& Handle);
+
+	/** Combat randomness: the seeded stream in fixed step mode, FMath otherwise */
+	static float FRand(const UObject* WorldContextObject);
+
+	/** Hash of the combat state as of now, as recorded per step by the determinism check */
+	uint32 HashCombatState() const;
+
+	/** Prints the determinism check's progress (summer.Combat.Determinism.Report) */
+	void ReportDeterminism() const;
+
+protected:
+	/** Length of one combat step in seconds */
+	UPROPERTY(Config, EditAnywhere, Category = "Combat Clock", meta = (ClampMin = "0.001"))
+	float FixedStepSize;
+
+	/** Catch-up cap: steps beyond this in one frame are dropped */
+	UPROPERTY(Config, EditAnywhere, Category = "Combat Clock", meta = (ClampMin = "1"))
+	int32 MaxStepsPerFrame;
+
+	/** Also hash character locations, rounded to this many centimeters; 0 leaves them out since character movement isn't stepped */
+	UPROPERTY(Config, EditAnywhere, Category = "Determinism", meta = (ClampMin = "0.0"))
+	float LocationHashGrid;
+
+private:
+	struct FStepTimer
+	{
+		int32 Id = INDEX_NONE;
+		FTimerDelegate Delegate;
+		int64 NextStep = 0;
+		int32 IntervalSteps = 1;
+		bool bLoop = false;
+	};
+
+	void Step();
+	void FireTimers();
+	void CheckDeterminism();
+	FString GetDeterminismFilePath() const;
+
+	FStepTimer* FindStepTimer(int32 Id);
+	const FStepTimer* FindStepTimer(int32 Id) const;
+
+	bool bFixedStep;
+	int64 StepIndex;
+	double Accumulator;
+	FRandomStream Random;
+
+	/** Ordered by creation, so timers due on the same step always fire in the same order */
+	TArray<FStepTimer> StepTimers;
+	int32 NextTimerId;
+
+	/** 0 off, 1 record, 2 compare; fixed for the world's lifetime like the mode */
+	int32 DeterminismMode;
+	TArray<uint32> StepHashes;
+	TArray<uint32> BaselineHashes;
+	int64 FirstMismatchStep;
+
+	/** Scratch for sorting per-actor hashes, so the combined hash doesn't depend on registration order */
+	mutable TArray<uint32> ActorHashes;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrameArena.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CoverSearchSubsystem.generated.h"
+
+struct FWorldQueryResult;
+
+/** Cached answer to "can the player see someone standing at this cover point" */
+enum class ECoverVisibility : uint8
+{
+	/** Not evaluated yet, a refresh is queued */
+	Unknown,
+	Hidden,
+	Exposed
+};
+
+/** A precomputed place to stand behind a cover actor */
+struct FCoverPoint
+{
+	/** Navmesh location next to the cover */
+	FVector Location = FVector::ZeroVector;
+
+	/** Horizontal normal of the cover face, pointing from the cover towards Location */
+	FVector WallNormal = FVector::ZeroVector;
+
+	TWeakObjectPtr<AActor> CoverActor;
+
+	/** World time of the last visibility evaluation, negative if never evaluated */
+	double LastEvaluatedTime = -1.0;
+
+	bool bHidden = false;
+
+	/** Waiting in the refresh queue or for an async trace */
+	bool bQueued = false;
+
+	/** Cleared when the cover actor goes away. Indices are never reused so in-flight traces can't land on another point */
+	bool bValid = true;
+};
+
+/**
+ * Cover candidates around every actor tagged CoverActorTag, generated once when the actor registers with UActorRegistrySubsystem,
+ * plus a visibility cache shared by every enemy: one trace from the player's eyes answers the question for all queries asking
+ * about the same point within CacheLifetime. Stale points are queued and refreshed with deferred traces through UWorldQuerySchedulerSubsystem, at most MaxTracesPerFrame per frame,
+ * so a wave of enemies searching for cover at once costs a few traces per frame instead of one per enemy per candidate.
+ * Used by UEnvQueryGenerator_CoverPoints and UEnvQueryTest_CoverVisibility.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UCoverSearchSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCoverSearchSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Appends the indices of valid cover points within Radius of Center */
+	void GatherCoverPoints(const FVector& Center, float Radius, TArray<int32, FFrameArenaAllocator>& OutIndices) const;
+
+	const FCoverPoint& GetCoverPoint(int32 Index) const { return CoverPoints[Index]; }
+
+	/** Index of the cover point generated at exactly Location, INDEX_NONE if there is none */
+	int32 FindCoverPointAt(const FVector& Location) const;
+
+	/** Cached visibility of a cover point. Queues a refresh when the cached answer is older than CacheLifetime */
+	ECoverVisibility RequestVisibility(int32 Index);
+
+protected:
+	/** Actors with this tag get cover points (add an ActorRegistryComponent to cover blueprints) */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	FName CoverActorTag;
+
+	/** Spacing of the points along each cover face */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	float CandidateSpacing;
+
+	/** Distance of the points from the cover face */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	float CandidateStandoff;
+
+	/** Cover lower than this doesn't hide a crouching enemy and gets no points */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	float MinCoverHeight;
+
+	/** Height above the point the visibility trace aims at (a crouching enemy's head) */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	float TargetHeight;
+
+	/** Points further than this from the player count as hidden without a trace */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	float MaxVisibilityDistance;
+
+	/** How long a visibility answer is shared before it is traced again */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	float CacheLifetime;
+
+	/** Visibility traces submitted per frame */
+	UPROPERTY(Config, EditAnywhere, Category = "Cover")
+	int32 MaxTracesPerFrame;
+
+private:
+	void HandleActorRegistered(AActor* Actor);
+	void HandleActorUnregistered(AActor* Actor);
+
+	void AddCoverPoints(AActor* CoverActor);
+
+	void OnVisibilityTraceDone(int32 Index, const FWorldQueryResult& Result);
+
+	void SetVisibility(FCoverPoint& Point, bool bHidden, double Now);
+
+	static FIntVector MakeLocationKey(const FVector& Location) { return FIntVector(FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z)); }
+
+	TArray<FCoverPoint> CoverPoints;
+	TMap<FIntVector, int32> PointsByLocation;
+
+	/** Point indices waiting for a visibility trace, oldest first. Consumed from RefreshHead and compacted once drained */
+	TArray<int32> RefreshQueue;
+	int32 RefreshHead;
+
+	FDelegateHandle ActorRegisteredHandle;
+	FDelegateHandle ActorUnregisteredHandle;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "DamageNumberWidget.generated.h"
+
+/**
+ * Floating damage number recycled by ASummerTPSHUD, which positions it over the victim every frame while it is shown.
+ * Like UHitMarkerWidget it is never reconstructed, so the Blueprint subclass restarts its animation in OnShow.
+ */
+UCLASS(Abstract)
+class SUMMERTPS_API UDamageNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Damage is everything one victim took from the player in one frame, e.g. a direct hit plus its splash */
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnShow(float Damage, bool bKilled);
+};
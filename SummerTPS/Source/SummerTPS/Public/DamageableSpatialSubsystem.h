@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageableSpatialSubsystem.generated.h"
+
+class UHealthComponent;
+class UDamageType;
+
+/** One result of a damageable query */
+struct FDamageableQueryHit
+{
+	UHealthComponent* HealthComponent = nullptr;
+
+	/** Distance from the query origin to the actor's collision surface (0 when the origin is inside) */
+	float Distance = 0.0f;
+};
+
+/**
+ * Uniform spatial hash over every live UHealthComponent owner, for splash and area queries without physics overlaps.
+ * Health components register themselves, pooled enemies drop out while parked; positions are refreshed once per frame and only entries
+ * that crossed a cell border move buckets.
+ * Queries take caller-owned result arrays so repeated queries in a frame don't allocate.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UDamageableSpatialSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UDamageableSpatialSubsystem();
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterDamageable(UHealthComponent* HealthComponent);
+	void UnregisterDamageable(UHealthComponent* HealthComponent);
+
+	/** Living damageables whose collision touches the sphere. OutHits is reset first */
+	int32 QueryRadius(const FVector& Center, float Radius, TArray<FDamageableQueryHit>& OutHits) const;
+
+	/** Living damageables inside the cone (apex Origin, axis Direction, up to Length) */
+	int32 QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Length, TArray<FDamageableQueryHit>& OutHits) const;
+
+	/**
+	 * Damages everything within Radius with a falloff from BaseDamage at the center to MinimumDamage at the edge, through UGameplayStatics::ApplyDamage.
+	 * Returns the number of actors damaged.
+	 */
+	int32 ApplyRadialDamage(const FVector& Center, float Radius, float BaseDamage, float MinimumDamage, float FalloffExponent,
+		AActor* DamageCauser, AController* InstigatedBy, TSubclassOf<UDamageType> DamageTypeClass, TConstArrayView<AActor*> IgnoreActors);
+
+	int32 GetNumDamageables() const { return Entries.Num(); }
+
+protected:
+	/** Edge length of one hash cell. Around the typical splash radius works best */
+	UPROPERTY(Config, EditAnywhere, Category = "Spatial Hash", meta = (ClampMin = "50.0"))
+	float CellSize;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UHealthComponent> HealthComponent;
+		TWeakObjectPtr<AActor> Owner;
+		FVector Location = FVector::ZeroVector;
+		float Radius = 0.0f;
+		FIntVector Cell = FIntVector::ZeroValue;
+	};
+
+	FIntVector ToCell(const FVector& Location) const;
+
+	void AddToCell(const FIntVector& Cell, int32 EntryIndex);
+	void RemoveFromCell(const FIntVector& Cell, int32 EntryIndex);
+	void RemoveEntryAt(int32 EntryIndex);
+
+	/** Visits the entries of every cell overlapping Box */
+	template <typename FunctorType>
+	void ForEachInBox(const FBox& Box, FunctorType&& Functor) const;
+
+	TArray<FEntry> Entries;
+
+	TMap<FIntVector, TArray<int32, TInlineAllocator<8>>> Cells;
+
+	TMap<TWeakObjectPtr<UHealthComponent>, int32> EntryIndices;
+
+	/** Reused result storage of ApplyRadialDamage */
+	TArray<FDamageableQueryHit> RadialDamageScratch;
+
+	/** Largest registered collision radius, added to query bounds so big actors aren't missed at cell borders */
+	float MaxEntryRadius;
+};
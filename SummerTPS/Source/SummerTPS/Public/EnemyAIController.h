@@ -2,15 +2,19 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "Navigation/CrowdFollowingComponent.h"
 #include "EnemyAIController.generated.h"
 
+class UEnemyBehaviorTreeComponent;
+enum class EEnemyCrowdAvoidance : uint8;
+
 UCLASS()
 class SUMMERTPS_API AEnemyAIController : public AAIController
 {
 	GENERATED_BODY()
 
 public:
-	AEnemyAIController();
+	AEnemyAIController(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	class UBehaviorTree* BehaviorTree;
@@ -18,5 +22,34 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	class UBlackboardData* BlackboardData;
 
+	/** Same tree layout as BehaviorTree but built from native tasks/services. Used instead of BehaviorTree when summer.AI.UseNativeBehaviorTree is on */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	class UBehaviorTree* NativeBehaviorTree;
+
+	virtual bool RunBehaviorTree(UBehaviorTree* BTAsset) override;
+
+	/** Throttles the behavior tree tick, used by the enemy significance LOD */
+	void SetBehaviorTreeTickInterval(float Interval);
+
+	/**
+	 * Sets the detour crowd avoidance quality, Off leaves the agent in the crowd as an obstacle only.
+	 * Switching between off and on is deferred to the end of the current move, the crowd component only accepts it while idle.
+	 */
+	void SetCrowdAvoidance(EEnemyCrowdAvoidance Avoidance);
+
+	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
+
 	virtual void BeginPlay() override; // protected -> public으로 변경
+
+protected:
+	/** Behavior tree component that also records its own tick cost for the Blueprint vs native benchmark */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI")
+	UEnemyBehaviorTreeComponent* EnemyBehaviorTreeComponent;
+
+private:
+	void ApplyPendingCrowdSimulationState();
+
+	/** Simulation state requested by SetCrowdAvoidance while a move was in progress */
+	ECrowdSimulationState PendingCrowdSimulationState;
+	bool bHasPendingCrowdSimulationState;
 };
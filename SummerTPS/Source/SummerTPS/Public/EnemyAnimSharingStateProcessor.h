@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationSharingTypes.h"
+#include "EnemyAnimSharingStateProcessor.generated.h"
+
+/**
+ * Maps enemies onto animation sharing states through EEnemyAIState, so every enemy in the same state (idle, patrol, chase, attack)
+ * follows one shared leader pose instead of evaluating its own ABP_EnemyDummy.
+ * Assign this class as the State Processor Class of the enemy skeleton's entry in the animation sharing setup asset.
+ */
+UCLASS()
+class SUMMERTPS_API UEnemyAnimSharingStateProcessor : public UAnimationSharingStateProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyAnimSharingStateProcessor();
+
+	virtual void ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess) override;
+	virtual UEnum* GetAnimationStateEnum_Implementation() override;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "EnemyBehaviorTreeComponent.generated.h"
+
+/** Which flavour of the enemy behavior tree a component is running, used to split the cost benchmark */
+UENUM()
+enum class EEnemyBTCostCategory : uint8
+{
+	Blueprint,
+	Native,
+	MAX UMETA(Hidden)
+};
+
+/**
+ * Behavior tree component used by AEnemyAIController.
+ * Measures its own tick cost so the Blueprint task tree and the native task tree can be compared per enemy
+ * ("summer.AI.BTBenchmark.Report" / "summer.AI.BTBenchmark.Reset").
+ */
+UCLASS()
+class SUMMERTPS_API UEnemyBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+	/** Sets which benchmark bucket this component's tick time is accounted to */
+	void SetCostCategory(EEnemyBTCostCategory NewCategory);
+
+	EEnemyBTCostCategory GetCostCategory() const { return CostCategory; }
+
+	/** Minimum time between tree ticks, set by the enemy significance LOD. Skipped time is passed on to the next tick */
+	void SetLODTickInterval(float Interval) { LODTickInterval = FMath::Max(Interval, 0.0f); }
+
+	/** Prints the average per-enemy cost of each category since the last reset */
+	static void ReportBenchmark();
+
+	/** Clears the accumulated benchmark timings */
+	static void ResetBenchmark();
+
+private:
+	EEnemyBTCostCategory CostCategory = EEnemyBTCostCategory::Blueprint;
+
+	bool bIsCounted = false;
+
+	float LODTickInterval = 0.0f;
+
+	float AccumulatedLODDeltaTime = 0.0f;
+};
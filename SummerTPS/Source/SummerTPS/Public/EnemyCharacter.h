@@ -5,23 +5,31 @@
 #include "Perception/AIPerceptionComponent.h" 
 #include "Perception/AISenseConfig_Sight.h"   
 #include "EnemyAIController.h"               
+#include "EnemyAIState.h"
 #include "EnemyCharacter.generated.h"
 
 class UHealthComponent;
+class UAttackTokenComponent;
 class AWeapon;
 class UBehaviorTree; 
 class UBlackboardData; 
+class UAnimationSharingSetup;
+struct FEnemyLODTierSettings;
 
 UCLASS(Blueprintable, meta = (AIControllerClass = "AEnemyAIController")) 
 class SUMMERTPS_API AEnemyCharacter : public ACharacter
 {
     GENERATED_BODY()
 
+    // Microbenchmarks (Private/Tests) call the protected gameplay entry points directly
+    friend struct FSummerTPSBenchmarkAccess;
+
 public:
-    AEnemyCharacter();
+    AEnemyCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     UHealthComponent* HealthComponent;
@@ -39,6 +47,70 @@ public:
     UFUNCTION(BlueprintCallable, Category = "AI")
     void Attack();
 
+    /**
+     * Fires at Target if the target grants an attack token (targets without a UAttackTokenComponent are always allowed).
+     * Returns false when no token was available, the caller should strafe or hold instead.
+     */
+    bool TryAttack(AActor* Target);
+
+    /** Gives back the attack token held on the current target, if any */
+    void ReleaseAttackToken();
+
+    /** Base priority when competing for attack tokens, closer enemies get a bonus on top */
+    UPROPERTY(EditDefaultsOnly, Category = "Combat")
+    float AttackPriority = 1.0f;
+
+    /** Applies the update rates of a significance tier to behavior tree, perception, movement and animation */
+    void ApplyLODSettings(const FEnemyLODTierSettings& Settings);
+
+    /** Puts the enemy to sleep for reuse: hidden, no collision, no ticking, AI stopped */
+    void DeactivateToPool();
+
+    /** Wakes a pooled enemy up at the given transform with the given health */
+    void ActivateFromPool(const FTransform& SpawnTransform, float InitialHealth);
+
+    /** Cancels a death in progress (ragdoll, pending lifespan) and pools the enemy, so a snapshot restore can reuse the actor */
+    void ReviveToPool();
+
+    bool IsPooled() const { return bIsPooled; }
+
+    /** Only an enemy sleeping in a pool is clustered, see UObjectChurnSubsystem::ClusterPooledActor */
+    virtual bool CanBeClusterRoot() const override { return bIsPooled; }
+    virtual bool CanBeInCluster() const override { return bIsPooled; }
+
+    bool IsDead() const { return bIsDead; }
+
+    /** World time of the last shot, negative when the enemy hasn't fired yet */
+    double GetLastAttackTime() const { return LastAttackTime; }
+
+    /** Patrol area of the behavior tree's Find Patrol Point task, which the batched decision phase picks points in */
+    void SetPatrolArea(const FVector& Origin, float Radius);
+    bool HasPatrolArea() const { return PatrolAreaRadius >= 0.0f; }
+    const FVector& GetPatrolOrigin() const { return PatrolOrigin; }
+    float GetPatrolAreaRadius() const { return PatrolAreaRadius; }
+
+    UAIPerceptionComponent* GetAIPerceptionComponent() const { return AIPerceptionComponent; }
+
+    UHealthComponent* GetHealthComponent() const { return HealthComponent; }
+
+    /** Called by the noise aggregation layer. Writes InvestigateLocation unless the enemy already sees a target */
+    void OnNoiseHeard(const FVector& NoiseLocation, float Loudness, AActor* NoiseSource);
+
+    /** Quieter noises than this are ignored */
+    UPROPERTY(EditDefaultsOnly, Category = "AI")
+    float HearingThreshold = 0.1f;
+
+    /** Coarse state used to pick the shared animation pose */
+    EEnemyAIState GetAIState() const;
+
+    /** Shared poses per EEnemyAIState for this enemy's skeleton. Creates the world's animation sharing manager if none exists yet */
+    UPROPERTY(EditDefaultsOnly, Category = "Animation")
+    UAnimationSharingSetup* AnimationSharingSetup;
+
+    /** How long after firing the enemy stays in the Attack animation state */
+    UPROPERTY(EditDefaultsOnly, Category = "Animation")
+    float AttackAnimationTime = 0.5f;
+
     UPROPERTY(EditDefaultsOnly, Category = "Combat")
     TSubclassOf<AWeapon> DefaultWeaponClass;
 
@@ -48,6 +120,29 @@ private:
 
     bool bIsDead;
 
+    bool bIsPooled;
+
+    /** Mesh collision profile before the ragdoll switched it, restored by ReviveToPool */
+    FName MeshCollisionProfileName;
+
+    /** Set while sight perception reports a target, chooses Chase over Patrol when moving */
+    bool bHasPerceivedTarget;
+
+    double LastAttackTime;
+
+    /** Set by UBTTask_FindPatrolPoint, radius negative until it first ran */
+    FVector PatrolOrigin;
+    float PatrolAreaRadius;
+
+    /** True while the mesh follows a shared leader pose instead of running its own anim instance */
+    bool bUsesAnimationSharing;
+
+    void RegisterAnimationSharing();
+    void UnregisterAnimationSharing();
+
+    /** Token component of the target this enemy currently holds an attack token on */
+    TWeakObjectPtr<UAttackTokenComponent> HeldAttackToken;
+
 protected: 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI")
     UAIPerceptionComponent* AIPerceptionComponent;
@@ -58,6 +153,10 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "AI")
     UBlackboardData* BlackboardData;
 
+    /** Native-task version of BehaviorTree, forwarded to the AI controller */
+    UPROPERTY(EditDefaultsOnly, Category = "AI")
+    UBehaviorTree* NativeBehaviorTree;
+
     UPROPERTY(EditDefaultsOnly, Category = "AI")
     float SightRadius = 1000.0f;
 
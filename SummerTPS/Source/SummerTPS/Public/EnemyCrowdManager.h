@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EnemyCrowdManager.generated.h"
+
+class AEnemyCharacter;
+class UInstancedStaticMeshComponent;
+
+/** Patrol state of one crowd proxy slot */
+UENUM()
+enum class EEnemyCrowdProxyState : uint8
+{
+	/** Slot is unused */
+	Free,
+	/** Waiting before picking the next patrol point */
+	Idle,
+	/** Waiting for a navmesh patrol point (nav queries are budgeted per frame) */
+	NeedsGoal,
+	/** Walking towards its patrol point */
+	Walking,
+	/** Represented by a full AEnemyCharacter actor */
+	Promoted
+};
+
+/**
+ * Lightweight crowd representation for distant enemies.
+ * Proxies are plain structure-of-arrays data (position, velocity, health, patrol state) moved by a SIMD kernel
+ * in straight lines between navmesh patrol points (not along paths, so they may cut corners) and drawn as static mesh
+ * instances. A proxy inside EngagementRange of the player is promoted to a pooled AEnemyCharacter, projected back onto the
+ * navmesh and nudged out of blocking geometry, and demoted back once it leaves DemotionRange.
+ */
+UCLASS()
+class SUMMERTPS_API AEnemyCrowdManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AEnemyCrowdManager();
+
+	virtual void Tick(float DeltaTime) override;
+
+	/** Adds a crowd proxy at the given location. Health < 0 uses the enemy class default. Returns the proxy index or INDEX_NONE if full */
+	UFUNCTION(BlueprintCallable, Category = "Crowd")
+	int32 AddProxy(const FVector& Location, float InitialHealth = -1.0f);
+
+	/** Number of live proxies, including promoted ones */
+	UFUNCTION(BlueprintCallable, Category = "Crowd")
+	int32 GetNumProxies() const { return NumLiveProxies; }
+
+	/** Number of proxies currently represented by a full actor */
+	UFUNCTION(BlueprintCallable, Category = "Crowd")
+	int32 GetNumPromoted() const { return NumPromoted; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	/** Instanced visuals for proxies. Custom data 0 is 1 while walking, 0 while idle (for vertex-animated materials) */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UInstancedStaticMeshComponent* ProxyInstances;
+
+	/** Actor class proxies are promoted to */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	TSubclassOf<AEnemyCharacter> EnemyClass;
+
+	/** Maximum number of proxies */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd", meta = (ClampMin = "1"))
+	int32 MaxProxies;
+
+	/** Number of full enemy actors kept for promotion, spawned up front */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd", meta = (ClampMin = "0"))
+	int32 ActorPoolSize;
+
+	/** Proxies closer than this to the player become full actors */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	float EngagementRange;
+
+	/** Promoted actors farther than this from the player become proxies again. Should be larger than EngagementRange */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	float DemotionRange;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	float ProxyWalkSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	float PatrolRadius;
+
+	/** Idle time range between patrol points */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	FVector2D IdleTimeRange;
+
+	/** Navmesh queries (patrol points) allowed per frame */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd", meta = (ClampMin = "1"))
+	int32 MaxNavQueriesPerFrame;
+
+	/** Vertical offset from the navmesh point to the instance origin */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crowd")
+	float ProxyMeshZOffset;
+
+private:
+	/** Moves walking proxies towards their goals and computes the squared distance to the player, 4 proxies per iteration */
+	void MoveProxies(float DeltaTime, const FVector& PlayerLocation);
+
+	void UpdatePatrolStates(float DeltaTime);
+	void UpdatePromotions(const FVector& PlayerLocation);
+	void PromoteProxy(int32 Index);
+	void DemoteProxy(int32 Index);
+	void FreeProxy(int32 Index);
+	void SetWalkingFlag(int32 Index, bool bWalking);
+	void UpdateInstanceTransforms();
+
+	AEnemyCharacter* AcquireActor();
+	void ReleaseActor(AEnemyCharacter* Enemy);
+
+	/** Structure-of-arrays proxy data, sized to a multiple of 4 for the SIMD kernel */
+	TArray<float> PosX, PosY, PosZ;
+	TArray<float> GoalX, GoalY, GoalZ;
+	TArray<float> VelX, VelY;
+	TArray<float> Speed;
+	TArray<float> DistSqToPlayer;
+	TArray<float> Health;
+	TArray<float> IdleTimeLeft;
+	TArray<FVector> PatrolOrigin;
+	TArray<EEnemyCrowdProxyState> State;
+	TArray<TWeakObjectPtr<AEnemyCharacter>> PromotedActors;
+
+	TArray<int32> FreeSlots;
+	TArray<FTransform> InstanceTransforms;
+
+	/** Round-robin cursor for patrol goal queries */
+	int32 NextGoalQueryIndex;
+
+	int32 NumLiveProxies;
+	int32 NumPromoted;
+
+	/** Enemy actors waiting in the pool */
+	UPROPERTY()
+	TArray<AEnemyCharacter*> InactiveActors;
+};
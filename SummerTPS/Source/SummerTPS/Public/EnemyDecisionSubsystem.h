@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyDecisionSubsystem.generated.h"
+
+class AEnemyCharacter;
+
+/**
+ * Per-frame decision phase for all active enemies, split so the expensive part runs on worker threads.
+ * Gather (game thread): every enemy's location, facing, perceived targets, attack timer and patrol state is copied into
+ * contiguous snapshot arrays, perceived actors are deduplicated into one target table.
+ * Decide (ParallelFor): target scoring, attack readiness and patrol point choice, reading only the snapshots and writing
+ * one decision per enemy, so workers never touch UObjects.
+ * Commit (game thread): changed decisions are written to the blackboards (TargetActor, AttackReady, PatrolLocation); patrol
+ * points are projected onto the navmesh here. Focus is left to the behavior tree.
+ * The behavior trees keep running serially but only act on the committed keys. Patrol points are picked in the area of the
+ * tree's Find Patrol Point task (its radius and anchor), and AttackReady gates the Enemy Attack task when the blackboard asset
+ * has a Bool key of that name. Disabled by summer.AI.ParallelDecisions 0, in which case perception writes TargetActor
+ * directly as before.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UEnemyDecisionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyDecisionSubsystem();
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Whether the decision phase owns target selection and patrol points (summer.AI.ParallelDecisions) */
+	static bool IsEnabled();
+
+protected:
+	/** Targets further away than this are never chosen and score 0 on distance */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "1.0"))
+	float MaxTargetDistance;
+
+	/** Score weight of the target being in front of the enemy */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "0.0"))
+	float FacingWeight;
+
+	/** Score bonus of the current target, so a slightly better candidate doesn't make the enemy switch back and forth */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "0.0"))
+	float TargetSwitchBias;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "0.0"))
+	float AttackRange;
+
+	/** Extra range an attack-ready enemy keeps before it stops being ready */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "0.0"))
+	float AttackRangeHysteresis;
+
+	/** Time after a shot before the enemy is ready again */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "0.0"))
+	float AttackCooldown;
+
+	/** Distance to the patrol point at which the next one is picked */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "0.0"))
+	float PatrolAcceptanceRadius;
+
+	/** Enemies per worker task; fewer enemies than this run on the game thread */
+	UPROPERTY(Config, EditAnywhere, Category = "Decisions", meta = (ClampMin = "1"))
+	int32 MinBatchSize;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Blackboard")
+	FName TargetActorKeyName;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Blackboard")
+	FName AttackReadyKeyName;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Blackboard")
+	FName PatrolLocationKeyName;
+
+private:
+	struct FTargetSnapshot
+	{
+		AActor* Actor = nullptr;
+		FVector Location = FVector::ZeroVector;
+		bool bAlive = true;
+	};
+
+	struct FEnemyDecision
+	{
+		int32 Target = INDEX_NONE;
+		bool bAttackReady = false;
+		bool bNewPatrolPoint = false;
+		FVector PatrolPoint = FVector::ZeroVector;
+	};
+
+	void Gather(double Now);
+	void Decide(int32 Index);
+	void Commit();
+
+	/** Index of Actor in Targets, adding it on first sight */
+	int32 FindOrAddTarget(AActor* Actor);
+
+	/** Snapshots, one element per enemy in every array */
+	TArray<AEnemyCharacter*> Enemies;
+	TArray<FVector> Locations;
+	TArray<FVector> Forwards;
+	TArray<FVector> PatrolOrigins;
+
+	/** Negative while the enemy has no patrol area yet */
+	TArray<float> PatrolRadii;
+	TArray<float> TimesSinceAttack;
+	TArray<int32> CurrentTargets;
+	TArray<uint8> WasAttackReady;
+	TArray<uint8> HasPatrolPoint;
+	TArray<FVector> PatrolPoints;
+	TArray<uint32> RandomSeeds;
+
+	/** Perceived targets of enemy i are CandidateIndices[CandidateStarts[i] .. CandidateStarts[i + 1]) */
+	TArray<int32> CandidateStarts;
+	TArray<int32> CandidateIndices;
+
+	TArray<FTargetSnapshot> Targets;
+	TMap<const AActor*, int32> TargetIndices;
+
+	TArray<FEnemyDecision> Decisions;
+
+	/** Scratch for the perception query */
+	TArray<AActor*> PerceivedActors;
+
+	uint32 FrameCounter;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemyCharacter;
+
+/** Detour crowd avoidance level per significance tier. Off keeps the agent in the crowd as an obstacle only */
+UENUM(BlueprintType)
+enum class EEnemyCrowdAvoidance : uint8
+{
+	Off,
+	Low,
+	Medium,
+	Good,
+	High
+};
+
+/** What an enemy is allowed to spend in one significance (LOD) tier */
+USTRUCT(BlueprintType)
+struct FEnemyLODTierSettings
+{
+	GENERATED_BODY()
+
+	/** Enemies closer than this (after the off-screen scale) belong to this tier or a more significant one */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	float MaxDistance = 0.0f;
+
+	/** Minimum time between behavior tree ticks. 0 ticks every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	float BehaviorTreeTickInterval = 0.0f;
+
+	/** Whether sight perception is updated at all in this tier */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	bool bEnableSight = true;
+
+	/** Tick interval of the character movement component */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	float MovementTickInterval = 0.0f;
+
+	/** Move along the navmesh instead of doing floor sweeps against collision */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	bool bUseNavWalking = false;
+
+	/** Tick interval of the skeletal mesh (animation update) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	float AnimationTickInterval = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	EVisibilityBasedAnimTickOption AnimationTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPose;
+
+	/** Significance handed to the animation budget allocator (0..1). Used instead of AnimationTickInterval while the allocator is enabled */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AnimationSignificance = 1.0f;
+
+	/** Crowd avoidance quality of the enemy's path following */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LOD")
+	EEnemyCrowdAvoidance CrowdAvoidance = EEnemyCrowdAvoidance::High;
+};
+
+/**
+ * Assigns every enemy a significance tier from its distance to the local player and whether it was recently rendered,
+ * and throttles behavior tree, perception, movement and animation per tier.
+ * Tier changes use a distance hysteresis and a minimum dwell time so enemies on a border don't flip every frame.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemySignificanceSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemyCharacter* Enemy);
+	void UnregisterEnemy(AEnemyCharacter* Enemy);
+
+	/** Current tier of an enemy, INDEX_NONE if it isn't registered */
+	int32 GetEnemyTier(const AEnemyCharacter* Enemy) const;
+
+	int32 GetNumTiers() const { return Tiers.Num(); }
+
+	const FEnemyLODTierSettings& GetTierSettings(int32 Tier) const { return Tiers[Tier]; }
+
+protected:
+	/** Tiers ordered from most to least significant. The last tier catches everything beyond the previous tier's MaxDistance */
+	UPROPERTY(Config, EditAnywhere, Category = "LOD")
+	TArray<FEnemyLODTierSettings> Tiers;
+
+	/** Extra distance an enemy has to move past a tier border before it drops to a less significant tier */
+	UPROPERTY(Config, EditAnywhere, Category = "LOD")
+	float HysteresisDistance;
+
+	/** Minimum time an enemy stays in a tier before it may change again */
+	UPROPERTY(Config, EditAnywhere, Category = "LOD")
+	float MinTimeInTier;
+
+	/** Distance multiplier for enemies that were not rendered recently */
+	UPROPERTY(Config, EditAnywhere, Category = "LOD")
+	float OffscreenDistanceScale;
+
+	/** Number of enemies evaluated per frame, the rest are picked up round-robin on the following frames */
+	UPROPERTY(Config, EditAnywhere, Category = "LOD")
+	int32 MaxEvaluationsPerFrame;
+
+private:
+	struct FEnemyEntry
+	{
+		TWeakObjectPtr<AEnemyCharacter> Enemy;
+		int32 Tier = INDEX_NONE;
+		double LastTierChangeTime = 0.0;
+	};
+
+	int32 ComputeTier(const FEnemyEntry& Entry, float Distance) const;
+	void ApplyTier(FEnemyEntry& Entry, int32 NewTier, double Now);
+
+	TArray<FEnemyEntry> Entries;
+
+	/** Round-robin cursor into Entries */
+	int32 NextEvaluationIndex;
+};
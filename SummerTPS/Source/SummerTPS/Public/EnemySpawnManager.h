@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "CombatClockSubsystem.h"
 #include "EnemySpawnManager.generated.h"
 
 class AEnemySpawner;
@@ -16,6 +17,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public: 
     // 이 매니저가 제어할 스포너들의 그룹 태그
@@ -41,4 +43,19 @@ private:
 
     // 태그를 이용해 관리할 스포너들을 찾는 내부 함수
     void FindSpawnersInWorld();
+
+    // 나중에 등록된 스포너(스트리밍 서브레벨 등)를 관리 목록에 추가
+    void OnActorRegistered(AActor* Actor);
+
+    // 스트리밍 아웃되거나 파괴된 스포너를 관리 목록에서 제거
+    void OnActorUnregistered(AActor* Actor);
+
+    // StartAllSpawners가 이미 호출되었는지 여부 (늦게 합류한 스포너도 바로 시작)
+    bool bSpawnersStarted;
+
+    // SpawnActivationDelay 타이머 (고정 스텝 전투에서는 전투 스텝 기준)
+    FCombatTimerHandle ActivationTimerHandle;
+
+    FDelegateHandle ActorRegisteredHandle;
+    FDelegateHandle ActorUnregisteredHandle;
 };
\ No newline at end of file
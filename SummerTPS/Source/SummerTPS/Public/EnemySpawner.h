@@ -2,21 +2,38 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "CombatClockSubsystem.h"
 #include "EnemySpawner.generated.h"
 
 class AEnemyCharacter;
+class AEnemyCrowdManager;
 class USphereComponent;
 
+// 스냅샷 복원용 스포너 진행 상태
+struct FEnemySpawnerState
+{
+    int32 EnemiesSpawnedCount = 0;
+    int32 NumberOfEnemiesToSpawn = 0;
+
+    // 스폰 타이머가 돌고 있었는지, 그리고 다음 스폰까지 남은 시간
+    bool bSpawning = false;
+    float TimeUntilNextSpawn = 0.0f;
+};
+
 UCLASS()
 class SUMMERTPS_API AEnemySpawner : public AActor
 {
     GENERATED_BODY()
 
+    // 마이크로벤치마크(Private/Tests)에서 비공개 스폰 함수를 직접 호출
+    friend struct FSummerTPSBenchmarkAccess;
+
 public: 
     AEnemySpawner();
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public: 
     // 스폰할 적 캐릭터의 종류 (블루프린트에서 선택)
@@ -43,17 +60,46 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawning")
     bool bRandomizeSpawnRotation;
 
+    // 바닥 트레이스 결과를 몇 프레임까지 기다릴 수 있는지 (0이면 즉시 동기 트레이스, 고정 스텝 전투에서는 항상 동기)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawning", meta = (ClampMin = "0"))
+    int32 GroundTraceMaxLatencyFrames;
+
+    // 설정되면 액터 대신 경량 크라우드 프록시로 스폰 (플레이어 근처에서 AEnemyCharacter로 승격)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spawning")
+    AEnemyCrowdManager* CrowdManager;
+
     // 스폰 프로세스를 시작하는 함수 (블루프린트나 다른 코드에서 호출 가능)
     UFUNCTION(BlueprintCallable, Category = "Spawning")
     void StartSpawning();
 
+    // 타이머 없이 즉시 Count명을 추가로 스폰 (벤치마크용)
+    void SpawnImmediately(int32 Count);
+
+    // 현재 스폰 진행 상태를 반환 (게임플레이 스냅샷용)
+    FEnemySpawnerState CaptureState() const;
+
+    // 스냅샷 시점의 진행 상태로 되돌림. 바닥 트레이스를 기다리던 스폰은 취소됨
+    void RestoreState(const FEnemySpawnerState& State);
+
 private:
-    // 실제로 적 한 명을 스폰하는 내부 함수
+    // 스폰 위치를 고르고 바닥 트레이스를 요청하는 내부 함수
     void SpawnEnemy();
 
-    // 시간차를 두고 스폰을 관리하기 위한 타이머 핸들
-    FTimerHandle SpawnTimerHandle;
+    // 스폰 볼륨 안의 랜덤 위치로 바닥 트레이스 후 스폰. bCountTowardWave가 false면 웨이브 카운터에 포함되지 않음 (즉시 스폰용)
+    void SpawnAtRandomPoint(bool bUseCrowdManager, bool bCountTowardWave);
+
+    // 바닥 위치가 정해진 뒤 실제로 적(또는 크라우드 프록시)을 만드는 함수
+    void FinishSpawn(const FVector& SpawnLocation, bool bUseCrowdManager, bool bCountTowardWave);
+
+    // 시간차를 두고 스폰을 관리하기 위한 타이머 핸들 (고정 스텝 전투에서는 전투 시계 기준)
+    FCombatTimerHandle SpawnTimerHandle;
 
     // 현재까지 스폰된 적의 수를 추적하는 카운터
     int32 EnemiesSpawnedCount;
+
+    // 바닥 트레이스 결과를 기다리는 중인 스폰 수
+    int32 PendingSpawnCount;
+
+    // RestoreState마다 증가. 이전 세대의 바닥 트레이스 콜백은 무시됨
+    uint32 SpawnGeneration;
 };
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryGenerator.h"
+#include "DataProviders/AIDataProvider.h"
+#include "EnvQueryGenerator_CoverPoints.generated.h"
+
+/**
+ * Generates the precomputed cover points of UCoverSearchSubsystem around a context, instead of a grid of points that each need
+ * their own navmesh projection and visibility trace. Pair it with the Cover Visibility test.
+ */
+UCLASS(meta = (DisplayName = "Cover Points"))
+class SUMMERTPS_API UEnvQueryGenerator_CoverPoints : public UEnvQueryGenerator
+{
+	GENERATED_BODY()
+
+public:
+	UEnvQueryGenerator_CoverPoints();
+
+	virtual void GenerateItems(FEnvQueryInstance& QueryInstance) const override;
+	virtual FText GetDescriptionTitle() const override;
+	virtual FText GetDescriptionDetails() const override;
+
+protected:
+	/** Cover points are gathered around this context */
+	UPROPERTY(EditDefaultsOnly, Category = "Generator")
+	TSubclassOf<UEnvQueryContext> SearchCenter;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Generator")
+	FAIDataProviderFloatValue SearchRadius;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+#include "EnvQueryTest_CoverVisibility.generated.h"
+
+/**
+ * Scores cover points by whether the player can see them: 1 hidden, 0 exposed, UnknownScore while the first trace is pending.
+ * Reads the shared visibility cache of UCoverSearchSubsystem, which traces stale points on a per-frame budget,
+ * so the test itself never traces. Items that aren't cover points count as exposed.
+ */
+UCLASS(meta = (DisplayName = "Cover Visibility"))
+class SUMMERTPS_API UEnvQueryTest_CoverVisibility : public UEnvQueryTest
+{
+	GENERATED_BODY()
+
+public:
+	UEnvQueryTest_CoverVisibility();
+
+	virtual void RunTest(FEnvQueryInstance& QueryInstance) const override;
+	virtual FText GetDescriptionTitle() const override;
+	virtual FText GetDescriptionDetails() const override;
+
+protected:
+	/** Score of a point that has never been traced yet */
+	UPROPERTY(EditDefaultsOnly, Category = "Cover", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float UnknownScore;
+};
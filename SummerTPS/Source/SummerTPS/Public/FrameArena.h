@@ -0,0 +1,230 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ContainerAllocationPolicies.h"
+
+/**
+ * Bump allocator for game thread scratch data that lives no longer than the current frame.
+ * Memory is handed out from one block and the whole block is reclaimed at once on FCoreDelegates::OnEndFrame.
+ * Freeing the most recent allocation rolls the top back, so nested scratch arrays in one call stack reuse the same bytes.
+ * Requests that don't fit, or come from another thread, return null and the caller falls back to the heap.
+ * Use it through FFrameArenaAllocator; the block size is summer.FrameArena.SizeKB.
+ */
+class SUMMERTPS_API FFrameArena
+{
+public:
+	static FFrameArena& Get();
+
+	/** Null when the request doesn't fit this frame or the caller isn't on the game thread */
+	void* Allocate(SIZE_T Size, uint32 Alignment);
+
+	/** Grows or shrinks Ptr without moving it, possible only for the most recent allocation */
+	bool TryResizeInPlace(void* Ptr, SIZE_T OldSize, SIZE_T NewSize);
+
+	/** Gives the bytes back if Ptr is the most recent allocation, otherwise they wait for the end of the frame */
+	void Free(void* Ptr, SIZE_T Size);
+
+	/** Counts an allocation that had to go to the heap */
+	void NoteOverflow(SIZE_T Size);
+
+	/** Changes every frame; memory from an earlier generation must not be touched */
+	uint64 GetGeneration() const { return Generation; }
+
+	/** Logs the block size, the high-water mark over all frames and the overflow count */
+	void Report() const;
+
+private:
+	FFrameArena();
+
+	/** Reclaims the block, publishes the frame's peak usage and applies a changed block size */
+	void Reset();
+
+	uint8* Memory;
+	SIZE_T Capacity;
+	SIZE_T Top;
+
+	uint64 Generation;
+
+	/** Highest Top of the current frame, reset every frame */
+	SIZE_T FramePeak;
+
+	/** Highest frame peak since startup */
+	SIZE_T HighWater;
+	uint64 NumOverflows;
+	SIZE_T OverflowBytes;
+};
+
+/**
+ * TArray allocator policy backed by FFrameArena, e.g. TArray<FVector, FFrameArenaAllocator> for per-call scratch data.
+ * Arrays using it must not outlive the frame: keep them local, never in members. Once the arena is full the array moves
+ * its elements to the heap and stays there until it is freed.
+ */
+class FFrameArenaAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = false };
+	enum { RequireRangeCheck = true };
+
+	class ForAnyElementType
+	{
+	public:
+		ForAnyElementType()
+			: Data(nullptr), ArenaBytes(0), Generation(0), bOnHeap(false)
+		{
+		}
+
+		ForAnyElementType(const ForAnyElementType&) = delete;
+		ForAnyElementType& operator=(const ForAnyElementType&) = delete;
+
+		~ForAnyElementType()
+		{
+			Release();
+		}
+
+		void MoveToEmpty(ForAnyElementType& Other)
+		{
+			checkSlow(this != &Other);
+			Release();
+
+			Data = Other.Data;
+			ArenaBytes = Other.ArenaBytes;
+			Generation = Other.Generation;
+			bOnHeap = Other.bOnHeap;
+
+			Other.Data = nullptr;
+			Other.ArenaBytes = 0;
+			Other.bOnHeap = false;
+		}
+
+		FScriptContainerElement* GetAllocation() const
+		{
+			return Data;
+		}
+
+		void ResizeAllocation(SizeType PreviousNumElements, SizeType NumElements, SIZE_T NumBytesPerElement)
+		{
+			const SIZE_T NewBytes = (SIZE_T)NumElements * NumBytesPerElement;
+			if (NewBytes == 0)
+			{
+				Release();
+				return;
+			}
+
+			if (bOnHeap)
+			{
+				Data = (FScriptContainerElement*)FMemory::Realloc(Data, NewBytes, Alignment);
+				return;
+			}
+
+			FFrameArena& Arena = FFrameArena::Get();
+			checkf(!Data || Generation == Arena.GetGeneration(), TEXT("Frame arena array used after the end of the frame it was allocated in"));
+
+			if (Data && Arena.TryResizeInPlace(Data, ArenaBytes, NewBytes))
+			{
+				ArenaBytes = NewBytes;
+				return;
+			}
+
+			const SIZE_T LiveBytes = (SIZE_T)PreviousNumElements * NumBytesPerElement;
+			void* NewData = Arena.Allocate(NewBytes, Alignment);
+			if (NewData)
+			{
+				Generation = Arena.GetGeneration();
+			}
+			else
+			{
+				Arena.NoteOverflow(NewBytes);
+				NewData = FMemory::Malloc(NewBytes, Alignment);
+				bOnHeap = true;
+			}
+
+			if (Data)
+			{
+				FMemory::Memcpy(NewData, Data, FMath::Min(LiveBytes, NewBytes));
+				Arena.Free(Data, ArenaBytes);
+			}
+
+			Data = (FScriptContainerElement*)NewData;
+			ArenaBytes = bOnHeap ? 0 : NewBytes;
+		}
+
+		SizeType CalculateSlackReserve(SizeType NumElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackReserve(NumElements, NumBytesPerElement, false);
+		}
+
+		SizeType CalculateSlackShrink(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackShrink(NumElements, NumAllocatedElements, NumBytesPerElement, false);
+		}
+
+		SizeType CalculateSlackGrow(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false);
+		}
+
+		SIZE_T GetAllocatedSize(SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return (SIZE_T)NumAllocatedElements * NumBytesPerElement;
+		}
+
+		bool HasAllocation() const
+		{
+			return !!Data;
+		}
+
+		SizeType GetInitialCapacity() const
+		{
+			return 0;
+		}
+
+	private:
+		/** Enough for every gameplay element type; over-aligned types don't belong in scratch arrays */
+		static constexpr uint32 Alignment = 16;
+
+		void Release()
+		{
+			if (!Data)
+			{
+				return;
+			}
+
+			if (bOnHeap)
+			{
+				FMemory::Free(Data);
+			}
+			else if (Generation == FFrameArena::Get().GetGeneration())
+			{
+				FFrameArena::Get().Free(Data, ArenaBytes);
+			}
+
+			Data = nullptr;
+			ArenaBytes = 0;
+			bOnHeap = false;
+		}
+
+		FScriptContainerElement* Data;
+		SIZE_T ArenaBytes;
+		uint64 Generation;
+		bool bOnHeap;
+	};
+
+	template <typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		ElementType* GetAllocation() const
+		{
+			return (ElementType*)ForAnyElementType::GetAllocation();
+		}
+	};
+};
+
+template <>
+struct TAllocatorTraits<FFrameArenaAllocator> : TAllocatorTraitsBase<FFrameArenaAllocator>
+{
+	enum { SupportsMove = true };
+	enum { IsZeroConstruct = false };
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySpawner.h"
+#include "GameplaySnapshotSubsystem.generated.h"
+
+class ATPSPlayer;
+class AEnemyCharacter;
+class UBlackboardComponent;
+class UBlackboardKeyType;
+
+/** One blackboard key of an enemy. Only the member matching KeyType is meaningful */
+struct FBlackboardValueSnapshot
+{
+	FName KeyName;
+	TSubclassOf<UBlackboardKeyType> KeyType;
+
+	/** Vector and rotator keys can be unset, restored with ClearValue */
+	bool bIsSet = true;
+
+	TWeakObjectPtr<UObject> Object;
+	FVector Vector = FVector::ZeroVector;
+	FRotator Rotator = FRotator::ZeroRotator;
+	float Float = 0.0f;
+	int32 Int = 0;
+	uint8 Enum = 0;
+	bool bBool = false;
+	FName Name;
+};
+
+struct FEnemySnapshot
+{
+	/** The actor the entry was captured from, reused first when it is still around */
+	TWeakObjectPtr<AEnemyCharacter> Enemy;
+	TSubclassOf<AEnemyCharacter> Class;
+	TWeakObjectPtr<AActor> Owner;
+	FTransform Transform;
+	float Health = 0.0f;
+	TArray<FBlackboardValueSnapshot> Blackboard;
+};
+
+struct FGameplaySnapshot
+{
+	TWeakObjectPtr<ATPSPlayer> Player;
+	FTransform PlayerTransform;
+	FRotator PlayerControlRotation = FRotator::ZeroRotator;
+	float PlayerHealth = 0.0f;
+	float PlayerWater = 0.0f;
+
+	TArray<TPair<TWeakObjectPtr<AEnemySpawner>, FEnemySpawnerState>> Spawners;
+
+	TArray<FEnemySnapshot> Enemies;
+
+	/** World time of the capture */
+	double CaptureTime = 0.0;
+};
+
+/**
+ * Retry without reloading the map: captures the gameplay state that changes during a wave (player transform and health,
+ * spawner progress, live enemies with health and blackboard values) and restores it in place.
+ * Restoring revives the player, returns projectiles in flight to UProjectilePoolSubsystem and moves enemies through
+ * DeactivateToPool / ActivateFromPool, reusing every enemy actor still in the world (dead ones included) before spawning new ones,
+ * so a restore costs milliseconds and can be repeated for benchmark iterations within one process. Enemies the snapshot doesn't
+ * need stay pooled in the world for the next restore.
+ * Enemies owned by an AEnemyCrowdManager belong to its proxy simulation and are left alone, as is the crowd manager itself.
+ * A snapshot is taken automatically when AEnemySpawnManager starts a wave.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UGameplaySnapshotSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UGameplaySnapshotSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	UFUNCTION(BlueprintCallable, Category = "Snapshot")
+	void CaptureSnapshot();
+
+	/** Puts the world back into the captured state. False if there is no snapshot */
+	UFUNCTION(BlueprintCallable, Category = "Snapshot")
+	bool RestoreSnapshot();
+
+	UFUNCTION(BlueprintCallable, Category = "Snapshot")
+	bool HasSnapshot() const { return bHasSnapshot; }
+
+	/** Called by AEnemySpawnManager when it starts its spawners */
+	void NotifyWaveStarted();
+
+	/** Restores Iterations times in a row and logs the mean and worst restore time */
+	void RunRestoreBenchmark(int32 Iterations);
+
+protected:
+	/** Capture automatically whenever a wave starts */
+	UPROPERTY(Config, EditAnywhere, Category = "Snapshot")
+	bool bCaptureOnWaveStart;
+
+private:
+	/** Enemies owned by a crowd manager are part of its simulation, not of the snapshot */
+	static bool IsCrowdEnemy(const AEnemyCharacter* Enemy);
+
+	static void CaptureBlackboard(const UBlackboardComponent& Blackboard, TArray<FBlackboardValueSnapshot>& OutValues);
+	static void RestoreBlackboard(UBlackboardComponent& Blackboard, const TArray<FBlackboardValueSnapshot>& Values);
+
+	void RestoreEnemies();
+
+	FGameplaySnapshot Snapshot;
+	bool bHasSnapshot;
+};
@@ -11,11 +11,15 @@ class SUMMERTPS_API UHealthComponent : public UActorComponent
 {
     GENERATED_BODY()
 
+    // Microbenchmarks (Private/Tests) call the protected gameplay entry points directly
+    friend struct FSummerTPSBenchmarkAccess;
+
 public:
     UHealthComponent();
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Health")
     float DefaultHealth;
@@ -35,4 +39,11 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Health")
     bool IsDead() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Health")
+    float GetDefaultHealth() const;
+
+    /** Sets health directly without going through the damage pipeline (pooling, state restore) */
+    UFUNCTION(BlueprintCallable, Category = "Health")
+    void SetHealth(float NewHealth);
 };
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HitMarkerWidget.generated.h"
+
+/**
+ * Crosshair hit marker recycled by ASummerTPSHUD. The HUD keeps a fixed number of them in the viewport and only toggles
+ * visibility, so the Blueprint subclass should restart its animation in OnShow rather than rely on Construct.
+ */
+UCLASS(Abstract)
+class SUMMERTPS_API UHitMarkerWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** NumHits is how many enemies the player damaged this frame, bKilled whether any of them died */
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnShow(int32 NumHits, bool bKilled);
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InfluenceMapSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class EInfluenceLayer : uint8
+{
+	/** Cells covered by the player's line of fire */
+	Threat,
+	/** Cells recently occupied by enemies */
+	Density,
+	/** Cells where damage was recently taken */
+	Damage,
+
+	Count UMETA(Hidden)
+};
+
+/**
+ * 2D influence grid over the navigable area, used by enemies to pick flanking and retreat positions with array lookups instead of traces.
+ * Each layer decays exponentially, but lazily: a cell stores its value and the time it was last written, and is only brought up to date
+ * when a source stamps over it or a query reads it. Sources only re-stamp when they moved or turned far enough, so a frame touches a
+ * handful of cell rows instead of the whole grid. Rows are padded to a multiple of four cells and stamped four cells at a time.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UInfluenceMapSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInfluenceMapSubsystem();
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool HasGrid() const { return GridWidth > 0; }
+
+	/** Current (decayed) value of a layer at Location, 0 outside the grid */
+	float SampleLayer(EInfluenceLayer Layer, const FVector& Location) const;
+
+	/** Stamps recent damage around Location. Amount is in health points */
+	void AddDamage(const FVector& Location, float Amount);
+
+	/**
+	 * Best cell between MinRange and MaxRange of Target that is off the player's line of fire, away from other enemies and
+	 * to the side of the target's facing, weighted by how far the querier has to walk. Projected onto the navmesh.
+	 */
+	bool FindFlankPosition(const FVector& QuerierLocation, const AActor* Target, float MinRange, float MaxRange, FVector& OutLocation) const;
+
+	/** Best cell within SearchRadius of the querier that gains distance from ThreatLocation and has little threat and damage */
+	bool FindRetreatPosition(const FVector& QuerierLocation, const FVector& ThreatLocation, float SearchRadius, FVector& OutLocation) const;
+
+protected:
+	/** Edge length of one cell in cm */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence")
+	float CellSize;
+
+	/** Used when the level has no navmesh bounds volume */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence")
+	FBox FallbackBounds;
+
+	/** Time for each layer to lose half its value */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Threat")
+	float ThreatHalfLife;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Density")
+	float DensityHalfLife;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Damage")
+	float DamageHalfLife;
+
+	/** Values saturate here so a camping source doesn't build an unbounded hotspot */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence")
+	float MaxCellValue;
+
+	/** Length and half width of the player's line of fire */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Threat")
+	float ThreatRange;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Threat")
+	float ThreatHalfWidth;
+
+	/** Threat added on the aim line per stamp, falling off to half at ThreatRange */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Threat")
+	float ThreatAmount;
+
+	/** Re-stamp the threat once the aim turned this far (degrees) */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Threat")
+	float ThreatRestampAngle;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Density")
+	float DensityRadius;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Density")
+	float DensityAmount;
+
+	/** Damage stamp radius, and the amount added per point of damage */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Damage")
+	float DamageRadius;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Damage")
+	float DamageAmountPerHealth;
+
+	/** Sources re-stamp once they moved this far, or after RestampInterval while standing still */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence")
+	float RestampDistance;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence")
+	float RestampInterval;
+
+	/** Score weights of the position queries */
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Queries")
+	float ThreatWeight;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Queries")
+	float DensityWeight;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Queries")
+	float DamageWeight;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Queries")
+	float FlankAngleWeight;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Queries")
+	float RetreatDistanceWeight;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Influence|Queries")
+	float TravelWeight;
+
+private:
+	struct FLayer
+	{
+		TArray<float> Values;
+		TArray<float> StampTimes;
+	};
+
+	/** Last stamp of a moving source, to skip re-stamping while it stands still */
+	struct FSourceStamp
+	{
+		FVector2D Location = FVector2D::ZeroVector;
+		FVector2D Direction = FVector2D::ZeroVector;
+		float Time = -1.0f;
+	};
+
+	struct FCandidate
+	{
+		FVector2D Location;
+		float Score;
+	};
+
+	void StampThreat(float Now);
+	void StampDensity(float Now);
+
+	void StampRadial(EInfluenceLayer Layer, const FVector2D& Center, float Radius, float Amount, float Now);
+	void StampSegment(EInfluenceLayer Layer, const FVector2D& Start, const FVector2D& End, float HalfWidth, float Amount, float Now);
+
+	/** Decays and adds Contribution(CellCenterX lanes, CellCenterY) over every cell in Area, four cells per step */
+	template <typename ContributionFunc>
+	void StampArea(EInfluenceLayer Layer, const FBox2D& Area, float Now, ContributionFunc&& Contribution);
+
+	float ReadCell(EInfluenceLayer Layer, int32 Index, float Now) const;
+
+	float GetHalfLife(EInfluenceLayer Layer) const;
+
+	bool ShouldRestamp(const FSourceStamp& Stamp, const FVector2D& Location, const FVector2D& Direction, float Now) const;
+
+	/** Projects the best scored candidates onto the navmesh, highest score first */
+	bool ProjectBestCandidate(TConstArrayView<FCandidate> Candidates, float Z, FVector& OutLocation) const;
+
+	/** Grid-relative time so the float timestamps keep their precision in long sessions */
+	float GetGridTime() const;
+
+	FIntPoint ToCell(const FVector2D& Location) const;
+
+	FVector2D GetCellCenter(int32 X, int32 Y) const { return GridOrigin + FVector2D(X + 0.5f, Y + 0.5f) * CellSize; }
+
+	FLayer Layers[(int32)EInfluenceLayer::Count];
+
+	FVector2D GridOrigin;
+	int32 GridWidth;
+	int32 GridHeight;
+
+	/** GridWidth rounded up to a multiple of four */
+	int32 RowStride;
+
+	double GridStartTime;
+
+	FSourceStamp PlayerStamp;
+	TMap<TWeakObjectPtr<AActor>, FSourceStamp> EnemyStamps;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "NatsuAnimInstance.generated.h"
+
+class ATPSPlayer;
+
+/**
+ * Animation proxy of UNatsuAnimInstance.
+ * PreUpdate copies the player state once per frame on the game thread, Update derives every blend-space and aim-offset input
+ * on an animation worker thread. The anim graph reads the outputs below through the instance's Proxy property.
+ */
+USTRUCT(BlueprintType)
+struct SUMMERTPS_API FNatsuAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FNatsuAnimInstanceProxy() = default;
+	FNatsuAnimInstanceProxy(UAnimInstance* Instance) : FAnimInstanceProxy(Instance) {}
+
+	/** Horizontal speed for the locomotion blend space */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Locomotion")
+	float GroundSpeed = 0.0f;
+
+	/** Movement direction relative to the actor facing, -180..180 */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Locomotion")
+	float Direction = 0.0f;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Locomotion")
+	bool bShouldMove = false;
+
+	/** Smoothed pitch input of AO_MF_Natsu */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Aim")
+	float AimPitch = 0.0f;
+
+	/** Smoothed yaw input of AO_MF_Natsu */
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Aim")
+	float AimYaw = 0.0f;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "State")
+	bool bIsAiming = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "State")
+	bool bIsSprinting = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "State")
+	bool bIsCovered = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "State")
+	bool bIsEnteringCover = false;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "State")
+	bool bIsExitingCover = false;
+
+protected:
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	/** Game thread snapshot, only touched in PreUpdate and read in Update */
+	FRotator ControlRotation = FRotator::ZeroRotator;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	FVector Velocity = FVector::ZeroVector;
+	bool bHasPlayer = false;
+
+	/** Tuning copied from the instance so Update never reads the UObject */
+	float MinMoveSpeed = 3.0f;
+	float AimInterpSpeed = 15.0f;
+	FVector2D AimYawRange = FVector2D(-90.0f, 90.0f);
+	FVector2D AimPitchRange = FVector2D(-90.0f, 90.0f);
+};
+
+/**
+ * Native parent class for ABP_NatsuSummer.
+ * All per-frame math happens in FNatsuAnimInstanceProxy so the update runs on animation worker threads;
+ * the anim blueprint should read Proxy values through property access instead of using Event Blueprint Update Animation.
+ */
+UCLASS(Transient, Blueprintable)
+class SUMMERTPS_API UNatsuAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override { return &Proxy; }
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override {}
+
+	/** Below this speed the character counts as standing still */
+	UPROPERTY(EditDefaultsOnly, Category = "Locomotion")
+	float MinMoveSpeed = 3.0f;
+
+	/** Interpolation speed of the aim offset inputs, 0 snaps */
+	UPROPERTY(EditDefaultsOnly, Category = "Aim")
+	float AimInterpSpeed = 15.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Aim")
+	FVector2D AimYawRange = FVector2D(-90.0f, 90.0f);
+
+	UPROPERTY(EditDefaultsOnly, Category = "Aim")
+	FVector2D AimPitchRange = FVector2D(-90.0f, 90.0f);
+
+private:
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Animation", meta = (AllowPrivateAccess = "true"))
+	FNatsuAnimInstanceProxy Proxy;
+
+	friend struct FNatsuAnimInstanceProxy;
+};
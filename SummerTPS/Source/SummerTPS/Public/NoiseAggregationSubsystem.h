@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageableSpatialSubsystem.h"
+#include "NoiseAggregationSubsystem.generated.h"
+
+class AEnemyCharacter;
+
+/**
+ * Hearing for enemies without one perception event per shot.
+ * Noises reported during a frame are merged per source and kind (e.g. the player's gunfire, the player's impacts) into one event
+ * with the loudest loudness and a loudness-weighted location. At the end of the frame each merged event finds the enemies in earshot
+ * through the damageable spatial hash and queues one delivery per enemy; a per-frame budget drains the queue.
+ * Delivered noises set the enemy's InvestigateLocation blackboard key, they never set TargetActor.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UNoiseAggregationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UNoiseAggregationSubsystem();
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Reports a noise. Loudness scales MaxRange like UAISense_Hearing does.
+	 * Noises with the same Source and Kind in one frame become a single event.
+	 */
+	void ReportNoise(AActor* Source, const FVector& Location, float Loudness, float MaxRange, FName Kind);
+
+protected:
+	/** Enemy deliveries processed per frame, the rest wait for the following frames */
+	UPROPERTY(Config, EditAnywhere, Category = "Noise", meta = (ClampMin = "1"))
+	int32 MaxDeliveriesPerFrame;
+
+	/** Queued deliveries older than this are dropped, the enemy will hear the next shot anyway */
+	UPROPERTY(Config, EditAnywhere, Category = "Noise", meta = (ClampMin = "0.0"))
+	float MaxDeliveryDelay;
+
+private:
+	struct FMergedNoise
+	{
+		TWeakObjectPtr<AActor> Source;
+		FName Kind;
+		FVector WeightedLocation = FVector::ZeroVector;
+		float TotalLoudness = 0.0f;
+		float Loudness = 0.0f;
+		float MaxRange = 0.0f;
+		int32 NumReports = 0;
+	};
+
+	struct FNoiseDelivery
+	{
+		TWeakObjectPtr<AEnemyCharacter> Enemy;
+		TWeakObjectPtr<AActor> Source;
+		FVector Location = FVector::ZeroVector;
+		float Loudness = 0.0f;
+		double Time = 0.0;
+	};
+
+	/** Turns this frame's merged noises into per-enemy deliveries */
+	void GatherListeners(double Now);
+
+	void Deliver(double Now);
+
+	/** Noises of the current frame */
+	TArray<FMergedNoise> PendingNoises;
+
+	/** FIFO of deliveries; one entry per enemy, a newer noise overwrites the queued one */
+	TArray<FNoiseDelivery> DeliveryQueue;
+
+	/** Read cursor into DeliveryQueue, compacted once it passes half the array */
+	int32 DeliveryHead;
+
+	TMap<TWeakObjectPtr<AEnemyCharacter>, int32> QueuedEnemies;
+
+	TArray<FDamageableQueryHit> ListenerScratch;
+};
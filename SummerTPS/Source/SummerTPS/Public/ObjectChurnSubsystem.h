@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/UObjectArray.h"
+#include "ObjectChurnSubsystem.generated.h"
+
+/**
+ * Watches how fast UObjects are created and destroyed, per class, and how long garbage collection pauses the game.
+ * Counts are rolled into per-second rates; a class over its budget logs a warning. Every GC pause is recorded together with
+ * the combat intensity of that moment (projectiles in flight plus active enemies) so summer.Churn.Report can show whether
+ * hitches follow the fights. The monitor doesn't run in shipping builds.
+ *
+ * Also owns the GC clustering of pooled actors: an inactive pooled actor becomes the root of a cluster holding its components
+ * (and an enemy's weapon), so reachability analysis treats the whole group as one object while it waits in the pool.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UObjectChurnSubsystem : public UTickableWorldSubsystem, public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+{
+	GENERATED_BODY()
+
+public:
+	UObjectChurnSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+
+	/** Logs the classes with the highest churn and the GC pauses grouped by combat intensity */
+	void ReportStats() const;
+
+	void ResetStats();
+
+	/**
+	 * Makes a pooled actor that just went inactive the root of a GC cluster. Its references have to stay put until
+	 * UnclusterPooledActor, which must run before the actor is reactivated. Does nothing when gc.CreateGCClusters is off
+	 * or the actor can't be a cluster root.
+	 */
+	static void ClusterPooledActor(AActor* Actor);
+
+	static void UnclusterPooledActor(AActor* Actor);
+
+protected:
+	/** Length of the window counts are turned into rates over */
+	UPROPERTY(Config, EditAnywhere, Category = "Churn", meta = (ClampMin = "0.1"))
+	float WindowSeconds;
+
+	/** Creations or destructions per second a class may reach before it's reported */
+	UPROPERTY(Config, EditAnywhere, Category = "Churn", meta = (ClampMin = "1"))
+	int32 DefaultBudgetPerSecond;
+
+	/** Per-class overrides of DefaultBudgetPerSecond, keyed by class name (e.g. SummerTPSProjectile) */
+	UPROPERTY(Config, EditAnywhere, Category = "Churn")
+	TMap<FName, int32> ClassBudgetsPerSecond;
+
+	/** Minimum time between two over-budget warnings for the same class */
+	UPROPERTY(Config, EditAnywhere, Category = "Churn", meta = (ClampMin = "0.0"))
+	float WarningCooldown;
+
+	/** Combat intensity from which a GC pause counts as happening in heavy combat */
+	UPROPERTY(Config, EditAnywhere, Category = "Churn", meta = (ClampMin = "1"))
+	int32 HeavyCombatIntensity;
+
+private:
+	struct FClassChurn
+	{
+		FName ClassName;
+		int32 WindowCreated = 0;
+		int32 WindowDestroyed = 0;
+		uint64 TotalCreated = 0;
+		uint64 TotalDestroyed = 0;
+		float LastRate = 0.0f;
+		float PeakRate = 0.0f;
+		double LastWarningTime = -1.0;
+	};
+
+	struct FGCSample
+	{
+		float PauseMs = 0.0f;
+		int32 CombatIntensity = 0;
+	};
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	/** Turns the window's counts into rates and checks them against the budgets */
+	void CloseWindow(double Now);
+
+	int32 GetBudget(FName ClassName) const;
+
+	/** Projectiles in flight plus enemies that are neither pooled nor dead */
+	int32 MeasureCombatIntensity() const;
+
+	bool bListening;
+
+	/** Creations and deletions arrive from loading and purge threads too */
+	mutable FCriticalSection Lock;
+
+	/**
+	 * Keyed by class pointer, the name is read once when the class is first seen creating an object.
+	 * Destructions of classes that were never seen creating one (e.g. loaded with the map) only go to UntrackedDestroyed,
+	 * their class may be purged in the same pass and can't be read safely.
+	 */
+	TMap<const UClass*, FClassChurn> Classes;
+	uint64 UntrackedDestroyed;
+
+	int32 WindowCreated;
+	int32 WindowDestroyed;
+	double WindowStart;
+
+	/** Measured when a window closes, GC samples use the latest value */
+	int32 CombatIntensity;
+
+	double GCStartTime;
+
+	/** Ring buffer of the most recent GC pauses */
+	TArray<FGCSample> GCSamples;
+	int32 NextGCSample;
+	uint64 NumGCs;
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Chaos/SimCallbackInput.h"
+#include "Chaos/SimCallbackObject.h"
+#include "ProjectileAsyncSimSubsystem.generated.h"
+
+class ASummerTPSProjectile;
+class USDFCollisionSubsystem;
+
+/** A projectile handed to the physics thread */
+struct FProjectileSimLaunch
+{
+	int32 Id = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	float Radius = 0.0f;
+	float GravityZ = 0.0f;
+	float Lifetime = 0.0f;
+
+	/** UniqueID of the shooter, never hit by its own projectile */
+	uint32 OwnerId = 0;
+};
+
+/** Capsule of a character projectiles can hit, refreshed once per game thread frame */
+struct FProjectileSimTarget
+{
+	uint32 Id = 0;
+	FVector Center = FVector::ZeroVector;
+	float Radius = 0.0f;
+
+	/** Half height of the capsule's cylinder part, without the caps */
+	float HalfSegment = 0.0f;
+};
+
+struct FProjectileSimInput : public Chaos::FSimCallbackInput
+{
+	TArray<FProjectileSimLaunch> Launches;
+	TArray<int32> Removals;
+	TArray<FProjectileSimTarget> Targets;
+	bool bHasTargets = false;
+
+	/** Distance field to trace against, sent once the game thread has it */
+	const USDFCollisionSubsystem* SDF = nullptr;
+
+	void Reset()
+	{
+		Launches.Reset();
+		Removals.Reset();
+		Targets.Reset();
+		bHasTargets = false;
+		SDF = nullptr;
+	}
+};
+
+enum class EProjectileSimEvent : uint8
+{
+	/** Touched static geometry (TargetId 0) or a target */
+	Hit,
+	/** Left the distance field; the game thread has to simulate the rest of the flight */
+	NoCoverage,
+	/** Lifetime ran out in flight */
+	Expired
+};
+
+struct FProjectileSimEvent
+{
+	int32 Id = INDEX_NONE;
+	EProjectileSimEvent Type = EProjectileSimEvent::Hit;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	FVector ImpactPoint = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::UpVector;
+	uint32 TargetId = 0;
+};
+
+struct FProjectileSimState
+{
+	int32 Id = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+};
+
+struct FProjectileSimOutput : public Chaos::FSimCallbackOutput
+{
+	TArray<FProjectileSimState> States;
+	TArray<FProjectileSimEvent> Events;
+
+	void Reset()
+	{
+		States.Reset();
+		Events.Reset();
+	}
+};
+
+/**
+ * Runs before every physics step on the physics thread. Owns the in-flight projectiles there, integrates them like the
+ * trajectory preview (USDFCollisionSubsystem::PredictPath) and sweeps each step against the distance field and the target
+ * capsules. Nothing here touches UObjects except the distance field, whose queries lock against volume (un)registration.
+ */
+class FProjectileSimCallback : public Chaos::TSimCallbackObject<FProjectileSimInput, FProjectileSimOutput>
+{
+private:
+	struct FSimProjectile
+	{
+		FProjectileSimLaunch Launch;
+		FVector Location = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+		float Age = 0.0f;
+	};
+
+	virtual void OnPreSimulate_Internal() override;
+
+	void ApplyInput(const FProjectileSimInput& Input);
+
+	/** Advances one projectile by Dt, returns false once it hit something or left coverage */
+	bool StepProjectile(FSimProjectile& Projectile, float Dt, FProjectileSimOutput& Output) const;
+
+	TArray<FSimProjectile> Projectiles;
+	TArray<FProjectileSimTarget> Targets;
+	const USDFCollisionSubsystem* SDF = nullptr;
+
+	/** Launch ids only grow, so a launch seen in an earlier step's input is never added twice */
+	int32 LastLaunchId = INDEX_NONE;
+};
+
+/**
+ * Moves projectiles in Chaos's async physics tick instead of UProjectileMovementComponent on the game thread tick.
+ * Opt-in: it needs summer.Projectile.AsyncSim 1 and async physics (Physics settings: Tick Physics Async), which the project
+ * doesn't enable by default since it moves every physics body onto the fixed step. Then trajectories don't depend on the
+ * frame rate, and the integration and contact tests run on the physics thread. Each frame the game thread sends new launches,
+ * removals and the current character capsules, then applies the marshalled results: projectile transforms for rendering, and
+ * hit events that go through the projectile's usual damage and FX handlers.
+ * Only the distance field and character capsules are simulated on the physics thread. Dynamic and physics bodies are swept
+ * on the game thread along each applied transform (ASummerTPSProjectile::SweepDynamicObjects), so they still stop projectiles
+ * as on the movement component path. A projectile leaving the baked volumes is handed back to its movement component for the
+ * rest of its flight, exactly like the distance field path on the game thread.
+ * Off in fixed step combat (UCombatClockSubsystem): how many physics steps ran by a given combat step depends on wall clock
+ * timing, so projectiles fly on the combat steps on the game thread instead.
+ */
+UCLASS()
+class SUMMERTPS_API UProjectileAsyncSimSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UProjectileAsyncSimSubsystem();
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Whether projectiles should launch into the async simulation (summer.Projectile.AsyncSim, async physics and a registered callback) */
+	bool IsAvailable() const;
+
+	/** Hands Projectile's flight to the physics thread starting at its current location, returns the simulation id */
+	int32 Launch(ASummerTPSProjectile* Projectile, const FVector& Velocity, float Radius, float GravityZ, float Lifetime);
+
+	/** Stops simulating a projectile that expired or was pooled on the game thread */
+	void Remove(int32 Id);
+
+	/** Projectiles the physics thread is simulating, as far as the game thread knows */
+	int32 GetNumInFlight() const { return Projectiles.Num(); }
+
+private:
+	/** Sends the current character capsules to the physics thread; launches and removals are sent as they happen */
+	void SendTargets();
+
+	/** Applies every output the physics thread produced since the last frame */
+	void ConsumeOutputs();
+
+	void HandleEvent(const FProjectileSimEvent& Event);
+
+	FProjectileSimCallback* Callback;
+
+	TMap<int32, TWeakObjectPtr<ASummerTPSProjectile>> Projectiles;
+
+	/** Characters sent as targets, by UniqueID, so hit events can be resolved back to actors */
+	TMap<uint32, TWeakObjectPtr<AActor>> TargetActors;
+
+	/** States of the newest output, applied to the actors once all outputs of the frame were consumed */
+	TArray<FProjectileSimState> LatestStates;
+
+	int32 NextId;
+};
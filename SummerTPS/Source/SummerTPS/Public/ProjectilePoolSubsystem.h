@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectilePoolSubsystem.generated.h"
+
+class ASummerTPSProjectile;
+
+/**
+ * Reuses projectile actors instead of spawning one per shot and destroying it on impact.
+ * Acquired projectiles are tracked as in flight until they hit something or their lifespan runs out, then they go back to
+ * a per-class free list. ReleaseAll returns everything in flight at once, used by the gameplay snapshot restore.
+ */
+UCLASS()
+class SUMMERTPS_API UProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** A projectile of Class flying from SpawnTransform, reused from the pool when one is free. Null if spawning failed */
+	ASummerTPSProjectile* Acquire(TSubclassOf<ASummerTPSProjectile> Class, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+	/** Returns a projectile acquired from this pool. False if it didn't come from here, the caller should destroy it */
+	bool Release(ASummerTPSProjectile* Projectile);
+
+	/** Returns every projectile in flight to the pool */
+	void ReleaseAll();
+
+	int32 GetNumInFlight() const { return InFlight.Num(); }
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<ASummerTPSProjectile>> InFlight;
+
+	/** Pooled projectiles of every class; Acquire searches from the back for a matching class */
+	UPROPERTY()
+	TArray<TObjectPtr<ASummerTPSProjectile>> Free;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FrameArena.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SDFCollisionSubsystem.generated.h"
+
+class ASDFCollisionVolume;
+
+/** Outcome of a distance field trace */
+enum class ESDFTraceResult : uint8
+{
+	/** Reached the end without touching static geometry */
+	Miss,
+	Hit,
+	/** Left the baked volumes (or ran out of steps); the caller has to use a physics query instead */
+	NoCoverage
+};
+
+struct FSDFTraceHit
+{
+	/** Center of the traced sphere at the time of the hit */
+	FVector Location = FVector::ZeroVector;
+
+	/** Point on the static surface */
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	FVector ImpactNormal = FVector::UpVector;
+
+	/** 0..1 along the traced segment */
+	float Time = 0.0f;
+};
+
+/**
+ * Answers distance, normal and sphere-trace queries against the static level from baked ASDFCollisionVolumes,
+ * so projectiles and the trajectory preview don't need physics sweeps for static geometry.
+ * Dynamic actors (enemies, the player) are not in the field and still need physics queries. Only volumes whose bake covered all
+ * their static geometry register (ASDFCollisionVolume::HasCompleteCoverage), so covered points can skip physics static collision.
+ * Queries are safe from other threads (the async projectile simulation runs them on the physics thread): they hold a read
+ * lock against volumes registering or unregistering, and baked data never changes during play.
+ */
+UCLASS()
+class SUMMERTPS_API USDFCollisionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterVolume(ASDFCollisionVolume* Volume);
+	void UnregisterVolume(ASDFCollisionVolume* Volume);
+
+	bool HasCoverage(const FVector& Point) const;
+
+	bool HasVolumes() const;
+
+	/** False if Point is outside every baked volume */
+	bool SampleDistance(const FVector& Point, float& OutDistance) const;
+
+	/** Distance plus the unit normal of the nearest surface */
+	bool SampleDistanceAndNormal(const FVector& Point, float& OutDistance, FVector& OutNormal) const;
+
+	/** Sphere-traces a sphere of Radius from Start to End through the field */
+	ESDFTraceResult SphereTrace(const FVector& Start, const FVector& End, float Radius, FSDFTraceHit& OutHit) const;
+
+	/**
+	 * Steps a ballistic path like UGameplayStatics::PredictProjectilePath, sphere tracing each step against the field.
+	 * OutPath receives every step position including the hit location.
+	 */
+	ESDFTraceResult PredictPath(const FVector& Start, const FVector& LaunchVelocity, float Radius, float MaxSimTime, float SimFrequency, float GravityZ, TArray<FVector, FFrameArenaAllocator>& OutPath, FSDFTraceHit& OutHit) const;
+
+private:
+	const ASDFCollisionVolume* FindVolume(const FVector& Point) const;
+
+	UPROPERTY()
+	TArray<ASDFCollisionVolume*> Volumes;
+
+	/** Written by (un)registration on the game thread, read by every query */
+	mutable FRWLock VolumesLock;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SDFCollisionVolume.generated.h"
+
+class UBoxComponent;
+
+/**
+ * Baked, sparse distance volume of the static collision inside its box.
+ * The box is split into bricks of BrickResolution^3 voxels. Only bricks within MaxDistance of static geometry store samples
+ * (quantized to 8 bits, with a one-sample apron so trilinear lookups never cross bricks); every other brick reads as MaxDistance.
+ * Bake in the editor with the Bake button after changing the static level. Queries go through USDFCollisionSubsystem.
+ * Projectiles inside a volume stop sweeping static geometry with physics, so a volume only registers when the bake covered
+ * every primitive of BakeObjectTypes in it. Stationary/movable primitives and primitives without simple collision can't be
+ * baked; a volume containing any of them stays out of play and projectiles keep their physics collision there.
+ */
+UCLASS()
+class SUMMERTPS_API ASDFCollisionVolume : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASDFCollisionVolume();
+
+	/** Rebuilds the field from the static collision overlapping the box */
+	UFUNCTION(CallInEditor, Category = "SDF")
+	void Bake();
+
+	/** Drops all baked data */
+	UFUNCTION(CallInEditor, Category = "SDF")
+	void ClearBakedData();
+
+	bool HasBakedData() const { return BrickTable.Num() > 0; }
+
+	/** True if the last bake sampled every primitive of BakeObjectTypes inside the box */
+	bool HasCompleteCoverage() const { return bBakedCompleteCoverage; }
+
+	/** True if Point lies inside the baked bounds */
+	bool Contains(const FVector& Point) const;
+
+	/** Distance to the nearest static surface, clamped to [0, MaxDistance]. Point must be inside the bounds */
+	float SampleDistance(const FVector& Point) const;
+
+	/** Distance plus its (unnormalized) gradient, which points away from the nearest surface */
+	float SampleDistanceAndGradient(const FVector& Point, FVector& OutGradient) const;
+
+	/** Settings the current data was baked with, which the editable ones only match until they are changed */
+	float GetMaxDistance() const { return BakedMaxDistance; }
+
+	float GetVoxelSize() const { return BakedVoxelSize; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SDF")
+	UBoxComponent* Bounds;
+
+	/** Edge length of one voxel in cm */
+	UPROPERTY(EditAnywhere, Category = "SDF", meta = (ClampMin = "5.0"))
+	float VoxelSize;
+
+	/** Voxels per brick edge */
+	UPROPERTY(EditAnywhere, Category = "SDF", meta = (ClampMin = "2", ClampMax = "16"))
+	int32 BrickResolution;
+
+	/** Narrow band around the surface that is stored. Also the largest step a sphere trace takes */
+	UPROPERTY(EditAnywhere, Category = "SDF", meta = (ClampMin = "1.0"))
+	float MaxDistance;
+
+	/** Object types treated as static geometry while baking */
+	UPROPERTY(EditAnywhere, Category = "SDF")
+	TArray<TEnumAsByte<ECollisionChannel>> BakeObjectTypes;
+
+private:
+	/** Fetches the 8 corner samples of the voxel containing Point and its fractional position inside that voxel */
+	void GatherCorners(const FVector& Point, float OutCorners[8], FVector& OutFraction) const;
+
+	float DecodeSample(int32 BrickIndex, int32 X, int32 Y, int32 Z) const;
+
+	int32 GetSamplesPerBrick() const { return FMath::Cube(BakedBrickResolution + 1); }
+
+	/** World-space min corner and brick grid the data was baked with */
+	UPROPERTY()
+	FVector BakedOrigin;
+
+	UPROPERTY()
+	FIntVector BrickCounts;
+
+	UPROPERTY()
+	float BakedVoxelSize;
+
+	UPROPERTY()
+	int32 BakedBrickResolution;
+
+	UPROPERTY()
+	float BakedMaxDistance;
+
+	/** False for data baked before skipped primitives were tracked, which has to be baked again */
+	UPROPERTY()
+	bool bBakedCompleteCoverage;
+
+	/** Per brick: index into the stored bricks, INDEX_NONE for bricks further than MaxDistance from any surface */
+	UPROPERTY()
+	TArray<int32> BrickTable;
+
+	/** (BrickResolution + 1)^3 quantized samples per stored brick */
+	UPROPERTY()
+	TArray<uint8> BrickSamples;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SplashDecalSubsystem.generated.h"
+
+class UDecalComponent;
+class UMaterialInterface;
+class UPrimitiveComponent;
+
+/**
+ * Water splash decals from a fixed ring of decal components instead of one new component per impact.
+ * A splash close to a live decal of the same material on the same surface refreshes and slightly grows that decal instead of
+ * taking a slot. Otherwise it takes the next slot in ring order, which recycles the oldest decal once the ring is full;
+ * a surface already at MaxDecalsPerSurface recycles its own oldest decal instead. A surface is the hit component, cut into
+ * SurfaceCellSize cells so one big floor doesn't share a single cap, and the static distance field counts as one component.
+ * Fading runs in the renderer from UDecalComponent::SetFadeOut; the subsystem only hides slots whose fade is over,
+ * checked when the earliest expiry comes due, so there is no per-decal tick.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API USplashDecalSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USplashDecalSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Places a decal of Size (radius on the surface) at Location facing along Normal. Surface is null for distance field hits */
+	void AddSplash(UMaterialInterface* Material, const FVector& Location, const FVector& Normal, float Size, const UPrimitiveComponent* Surface);
+
+	/** Logs capacity, live decals and how often slots were merged or recycled */
+	void ReportStats() const;
+
+protected:
+	/** Decal components in the ring, created on first use */
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "1"))
+	int32 Capacity;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "1"))
+	int32 MaxDecalsPerSurface;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "1.0"))
+	float SurfaceCellSize;
+
+	/** A splash closer than this fraction of the decal size to a live decal merges into it */
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "0.0"))
+	float MergeDistanceRatio;
+
+	/** Growth of a decal per merged splash, up to MaxMergedScale of its original size */
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "0.0"))
+	float MergeGrowth;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "1.0"))
+	float MaxMergedScale;
+
+	/** Time a decal stays fully visible */
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "0.0"))
+	float FadeStartDelay;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Decals", meta = (ClampMin = "0.0"))
+	float FadeDuration;
+
+private:
+	struct FSurfaceKey
+	{
+		TObjectKey<UPrimitiveComponent> Component;
+		FIntVector Cell = FIntVector::ZeroValue;
+
+		bool operator==(const FSurfaceKey& Other) const { return Component == Other.Component && Cell == Other.Cell; }
+	};
+
+	struct FDecalSlot
+	{
+		FSurfaceKey Surface;
+		TObjectKey<UMaterialInterface> Material;
+		FVector Location = FVector::ZeroVector;
+		FVector Normal = FVector::UpVector;
+		float BaseSize = 0.0f;
+		float Size = 0.0f;
+		double PlacedTime = 0.0;
+
+		/** Negative while the slot is free */
+		double ExpireTime = -1.0;
+	};
+
+	void CreateSlots();
+
+	/** Shows the slot's component with the slot's placement and restarts its fade */
+	void ApplySlot(int32 Index, double Now, bool bNewPlacement);
+
+	void HideExpired(double Now);
+
+	UPROPERTY()
+	TArray<TObjectPtr<UDecalComponent>> Components;
+
+	/** Parallel to Components */
+	TArray<FDecalSlot> Slots;
+
+	/** Ring cursor, the slot placed longest ago */
+	int32 NextSlot;
+
+	int32 NumLive;
+
+	/** Earliest ExpireTime of a live slot, nothing to hide before it */
+	double NextExpireTime;
+
+	uint64 NumPlaced;
+	uint64 NumMerged;
+	uint64 NumRecycled;
+
+	/** Recycles in the current one-second window and the rate of the last one */
+	int32 WindowRecycled;
+	double WindowStart;
+	float RecyclesPerSecond;
+};
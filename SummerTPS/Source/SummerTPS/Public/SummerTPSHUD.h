@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "SummerTPSHUD.generated.h"
+
+class ATPSPlayer;
+class UHealthComponent;
+class UUserWidget;
+class UHitMarkerWidget;
+class UDamageNumberWidget;
+class USummerTPSHUDViewModel;
+
+/**
+ * Player HUD driven by events only. The view-model is fed from the possessed ATPSPlayer's health, fire, water and cover events
+ * and flushed once per frame; nothing is bound to a property that polls every frame.
+ * Hits the player lands are collected during the frame, merged per victim and shown through fixed pools of hit-marker and
+ * damage-number widgets created up front. When a pool runs out the oldest widget is recycled, so the widget count and the
+ * per-frame cost stay flat however many enemies a burst of splash damage hits.
+ */
+UCLASS()
+class SUMMERTPS_API ASummerTPSHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	ASummerTPSHUD();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	USummerTPSHUDViewModel* GetViewModel() const { return ViewModel; }
+
+	/** Called by UHealthComponent when this HUD's player controller damaged Victim */
+	void NotifyDamageDealt(AActor* Victim, float Damage, bool bKilled);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Health, water gauge and crosshair. Gets the view-model from GetViewModel on this HUD */
+	UPROPERTY(EditDefaultsOnly, Category = "HUD")
+	TSubclassOf<UUserWidget> OverlayWidgetClass;
+
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Hit Markers")
+	TSubclassOf<UHitMarkerWidget> HitMarkerClass;
+
+	/** Markers of consecutive frames overlap for this many frames before the oldest is restarted */
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Hit Markers", meta = (ClampMin = "1"))
+	int32 HitMarkerPoolSize;
+
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Hit Markers", meta = (ClampMin = "0.0"))
+	float HitMarkerDuration;
+
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Damage Numbers")
+	TSubclassOf<UDamageNumberWidget> DamageNumberClass;
+
+	/** Damage numbers on screen at most; a frame with more victims shows the biggest hits */
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Damage Numbers", meta = (ClampMin = "1"))
+	int32 DamageNumberPoolSize;
+
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Damage Numbers", meta = (ClampMin = "0.0"))
+	float DamageNumberDuration;
+
+	/** Offset from the victim's location the number is anchored at */
+	UPROPERTY(EditDefaultsOnly, Category = "HUD|Damage Numbers")
+	FVector DamageNumberOffset;
+
+private:
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<AActor> Victim;
+		FVector Location = FVector::ZeroVector;
+		float Damage = 0.0f;
+		bool bKilled = false;
+	};
+
+	UFUNCTION()
+	void HandlePossessedPawnChanged(APawn* OldPawn, APawn* NewPawn);
+
+	UFUNCTION()
+	void HandleHealthChanged(UHealthComponent* OwningHealthComp, float Health, float HealthDelta, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
+
+	void BindPlayer(ATPSPlayer* Player);
+	void UnbindPlayer();
+
+	/** Copies everything the view-model shows from the player, used on binding and after a revive */
+	void RefreshFromPlayer(ATPSPlayer* Player);
+
+	/** Hands this frame's hits to the widget pools */
+	void ShowPendingDamage(double Now);
+
+	/** Moves shown damage numbers along with their anchors and hides expired widgets */
+	void UpdateWidgets(double Now);
+
+	UPROPERTY()
+	TObjectPtr<USummerTPSHUDViewModel> ViewModel;
+
+	UPROPERTY()
+	TObjectPtr<UUserWidget> OverlayWidget;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UHitMarkerWidget>> HitMarkers;
+
+	/** Parallel to HitMarkers, negative while hidden */
+	TArray<double> HitMarkerExpireTimes;
+	int32 NextHitMarker;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UDamageNumberWidget>> DamageNumbers;
+
+	/** Parallel to DamageNumbers */
+	TArray<FVector> DamageNumberAnchors;
+	TArray<double> DamageNumberExpireTimes;
+	int32 NextDamageNumber;
+
+	/** This frame's hits, one entry per victim */
+	TArray<FPendingDamage> PendingDamage;
+	int32 PendingHits;
+	bool bPendingKill;
+
+	TWeakObjectPtr<ATPSPlayer> BoundPlayer;
+	FDelegateHandle FiredHandle;
+	FDelegateHandle WaterChangedHandle;
+	FDelegateHandle CoverChangedHandle;
+	FDelegateHandle RevivedHandle;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "SummerTPSHUDViewModel.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHUDViewModelChanged, USummerTPSHUDViewModel*, ViewModel);
+
+/**
+ * Everything the HUD widgets show about the player, pushed in by ASummerTPSHUD from gameplay events instead of polled by
+ * property bindings. Setters only mark a group dirty; ASummerTPSHUD flushes once per frame, so each On*Changed event fires at
+ * most once a frame however many shots, hits or health changes happened. Widgets bind to the events and read the properties.
+ */
+UCLASS(BlueprintType)
+class SUMMERTPS_API USummerTPSHUDViewModel : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	USummerTPSHUDViewModel();
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float Health;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float MaxHealth;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	bool bIsDead;
+
+	/** Water left in the gun; MaxWater is 0 when the gun never runs dry */
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float Water;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float MaxWater;
+
+	/** Shots fired during the last flushed frame, e.g. for crosshair kick */
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 ShotsThisFrame;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	bool bIsCovered;
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	float GetHealthPercent() const;
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	float GetWaterPercent() const;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDViewModelChanged OnHealthChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDViewModelChanged OnWaterChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDViewModelChanged OnFired;
+
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnHUDViewModelChanged OnCoverChanged;
+
+	void SetHealth(float InHealth, float InMaxHealth, bool bInIsDead);
+	void SetWater(float InWater, float InMaxWater);
+	void AddShot();
+	void SetCovered(bool bInIsCovered);
+
+	/** Marks every group dirty, e.g. after the HUD switched to a new pawn */
+	void MarkAllDirty();
+
+	/** Broadcasts the events of the groups that changed since the last flush */
+	void Flush();
+
+private:
+	int32 PendingShots;
+
+	bool bHealthDirty;
+	bool bWaterDirty;
+	bool bCoverDirty;
+};
@@ -4,11 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "CombatClockSubsystem.h"
 #include "SummerTPSProjectile.generated.h"
 
 class USphereComponent;
 class UProjectileMovementComponent;
 class UNiagaraSystem;
+class UMaterialInterface;
+struct FSDFTraceHit;
+struct FProjectileSimEvent;
 
 UCLASS()
 class SUMMERTPS_API ASummerTPSProjectile : public AActor
@@ -22,6 +26,10 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Pooled projectiles go back to the pool instead of being destroyed */
+	virtual void LifeSpanExpired() override;
 
 public:	
 	// Called every frame
@@ -43,9 +51,51 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Effects")
 	UNiagaraSystem* SpawnEffect;
 
+	/** Decal left where the water hits level geometry, placed through USplashDecalSubsystem */
+	UPROPERTY(EditAnywhere, Category = "Effects")
+	UMaterialInterface* SplashDecal;
+
+	UPROPERTY(EditAnywhere, Category = "Effects", meta = (ClampMin = "0.0"))
+	float SplashDecalSize;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
 	float Damage;
 
+	/** Wetness added to the body region of a character hit directly, see UWetnessSubsystem. 0 leaves characters dry */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float HitWetness;
+
+	/** Radius of the water splash around the impact point. 0 disables splash damage */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile|Splash", meta = (ClampMin = "0.0"))
+	float SplashRadius;
+
+	/** Splash damage at the impact point, falling off towards SplashMinimumDamage at SplashRadius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile|Splash", meta = (ClampMin = "0.0"))
+	float SplashDamage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile|Splash", meta = (ClampMin = "0.0"))
+	float SplashMinimumDamage;
+
+	/** 1 is linear falloff, higher values keep the damage concentrated near the center */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile|Splash", meta = (ClampMin = "0.1"))
+	float SplashFalloffExponent;
+
+	/** Loudness of the impact for enemy hearing, 0 is silent */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+	float ImpactNoiseLoudness;
+
+	/** Range at which an impact of loudness 1 is heard */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile", meta = (ClampMin = "0.0"))
+	float ImpactNoiseRange;
+
+	/** Collide with static geometry through the baked distance field where available, physics then only handles dynamic actors */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	bool bUseSDFCollision;
+
+	/** Fly inside distance field coverage on the physics thread's fixed step, see UProjectileAsyncSimSubsystem. Needs bUseSDFCollision */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Projectile")
+	bool bUseAsyncSimulation;
+
 	/** called when projectile overlaps something */
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -54,8 +104,88 @@ public:
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	/** Puts the projectile to sleep for reuse: hidden, no collision, no movement, no ticking */
+	void DeactivateToPool();
+
+	/** Wakes a pooled projectile up at the given transform, flying at InitialSpeed along its forward vector */
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	bool IsPooled() const { return bIsPooled; }
+
+	/** Id in UProjectileAsyncSimSubsystem while the physics thread moves this projectile, INDEX_NONE otherwise */
+	int32 GetAsyncSimId() const { return AsyncSimId; }
+
+	/** Result of the async simulation: a hit goes through the usual impact handlers, leaving coverage resumes the movement component */
+	void OnAsyncSimEvent(const FProjectileSimEvent& Event, AActor* HitActor);
+
+	/**
+	 * Sweeps from the current location to End against what the async simulation doesn't know about (dynamic and physics bodies,
+	 * and static geometry outside distance field coverage), with this projectile's collision responses. A hit ends the flight
+	 * through OnHit and returns true.
+	 */
+	bool SweepDynamicObjects(const FVector& End);
+
+	/** Only a projectile sleeping in the pool is clustered, see UObjectChurnSubsystem::ClusterPooledActor */
+	virtual bool CanBeClusterRoot() const override { return bIsPooled; }
+	virtual bool CanBeInCluster() const override { return bIsPooled; }
+
 	/** Returns CollisionComp subobject **/
 	USphereComponent* GetCollisionComp() const { return CollisionComp; }
 	/** Returns ProjectileMovement subobject **/
 	UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
+
+private:
+	/** Sphere-traces the distance moved since the last frame against the static distance field */
+	void UpdateSDFCollision();
+
+	/** Switches static geometry between physics collision and the distance field */
+	void SetStaticCollisionFromSDF(bool bFromSDF);
+
+	void OnSDFImpact(const FSDFTraceHit& Hit);
+
+	/** Splash around the impact, the directly hit actor already took the full hit damage */
+	void ApplySplashDamage(const FVector& ImpactPoint, AActor* DirectHitActor);
+
+	void ReportImpactNoise(const FVector& ImpactPoint);
+
+	/** Splash decal on level geometry; characters and other pawns don't get one */
+	void PlaceSplashDecal(const FVector& ImpactPoint, const FVector& ImpactNormal, const UPrimitiveComponent* Surface, const AActor* HitActor);
+
+	/** Adds HitWetness to a directly hit character */
+	void SoakHitCharacter(AActor* HitActor, const FVector& ImpactPoint, FName BoneName);
+
+	/** Ends the flight: back to UProjectilePoolSubsystem when the projectile came from it, destroyed otherwise */
+	void Expire();
+
+	/** Lifespan on the combat clock in fixed step combat, the actor lifespan otherwise. 0 lives forever */
+	void StartLifeSpan(float InLifeSpan);
+
+	/** Frame ticks of the actor and the movement component; in fixed step combat they stay off and OnCombatStep moves the projectile */
+	void SetFlightTickEnabled(bool bEnabled);
+
+	/** Advances the movement component and the distance field sweep by one combat step */
+	void OnCombatStep(int64 StepIndex);
+
+	/** Hands the flight to UProjectileAsyncSimSubsystem if enabled and available; movement, collision and tick go to sleep meanwhile */
+	void StartAsyncSimulation();
+
+	void StopAsyncSimulation();
+
+	int32 AsyncSimId;
+
+	/** Set in BeginPlay when the world runs combat in fixed steps, see UCombatClockSubsystem */
+	bool bStepWithCombatClock;
+
+	FDelegateHandle CombatStepHandle;
+
+	FCombatTimerHandle LifeSpanTimerHandle;
+
+	FVector LastSDFLocation;
+
+	bool bIsPooled;
+
+	bool bStaticCollisionFromSDF;
+
+	/** Response to WorldStatic from the collision profile, restored when leaving the distance field */
+	TEnumAsByte<ECollisionResponse> DefaultStaticResponse;
 };
@@ -2,18 +2,27 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Kismet/GameplayStaticsTypes.h"
+#include "CombatClockSubsystem.h"
 #include "TPSPlayer.generated.h"
 
 class UHealthComponent;
+class UAttackTokenComponent;
+class UClothLODComponent;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTPSPlayerEvent, ATPSPlayer*);
+
 UCLASS()
 class SUMMERTPS_API ATPSPlayer : public ACharacter
 {
 	GENERATED_BODY()
 
+	// Microbenchmarks (Private/Tests) call the protected gameplay entry points directly
+	friend struct FSummerTPSBenchmarkAccess;
+
 public:
 	// Sets default values for this character's properties
 	ATPSPlayer();
@@ -29,6 +38,38 @@ public:
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	/** State read by the animation proxy on the game thread */
+	bool IsAiming() const { return bIsAiming; }
+	bool IsSprinting() const { return bIsSprinting; }
+	bool IsCovered() const { return bIsCovered; }
+	bool IsEnteringCover() const { return bIsEnteringCover; }
+	bool IsExitingCover() const { return bIsExitingCover; }
+
+	bool IsDead() const { return bIsDead; }
+
+	UHealthComponent* GetHealthComponent() const { return HealthComponent; }
+
+	/** Undoes a death (ragdoll, disabled input and movement) and puts the player back at SpawnTransform with Health and InWater, out of cover and not firing */
+	void Revive(const FTransform& SpawnTransform, const FRotator& ControlRotation, float Health, float InWater);
+
+	/** Adds Amount to the water tank, up to MaxWater; for refill stations and pickups */
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void RefillWater(float Amount);
+
+	float GetWater() const { return Water; }
+	float GetMaxWater() const { return MaxWater; }
+
+	/** False when WaterPerShot is 0 and the gun never runs dry */
+	bool UsesWater() const { return WaterPerShot > 0.0f; }
+
+	/** Events for the HUD view-model, which reads the new state back from the player */
+	FOnTPSPlayerEvent OnFired;
+	FOnTPSPlayerEvent OnWaterChanged;
+	FOnTPSPlayerEvent OnCoverChanged;
+
+	/** Revive set health and state directly, without the usual events */
+	FOnTPSPlayerEvent OnRevived;
+
 protected:
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -160,6 +201,26 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
 	float TimeBetweenShots;
 
+	/** Loudness of each shot for enemy hearing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+	float GunfireNoiseLoudness;
+
+	/** Range at which a shot of loudness 1 is heard */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+	float GunfireNoiseRange;
+
+	/** Capacity of the water tank */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (ClampMin = "0.0"))
+	float MaxWater;
+
+	/** Water each shot uses; 0 lets the gun fire forever */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (ClampMin = "0.0"))
+	float WaterPerShot;
+
+	/** Water left, full on BeginPlay and topped up by RefillWater */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Combat")
+	float Water;
+
 	/************************************************************************
 	* Weapon Handling
 	************************************************************************/
@@ -179,6 +240,14 @@ protected:
 UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UHealthComponent* HealthComponent;
 
+	/** Bounds how many enemies may attack the player at once */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UAttackTokenComponent* AttackTokenComponent;
+
+	/** Scales the swimsuit cloth simulation with camera distance and cover state */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UClothLODComponent* ClothLODComponent;
+
 protected:
 	/************************************************************************
 	* Cover System
@@ -203,7 +272,7 @@ protected:
 	/** True if player is currently entering cover with animation. */
 	bool bIsEnteringCover;
 
-	/** Time when the enter cover animation started. */
+	/** Combat time when the enter cover animation started. */
 	float EnterCoverStartTime;
 
 	/** Duration of the enter cover animation. */
@@ -228,7 +297,7 @@ protected:
 	/** True if player is currently exiting cover with animation. */
 	bool bIsExitingCover;
 
-	/** Time when the exit cover animation started. */
+	/** Combat time when the exit cover animation started. */
 	float ExitCoverStartTime;
 
 	/** Duration of the exit cover animation. */
@@ -242,8 +311,8 @@ protected:
 	FVector ExitCoverTargetLocation;
 
 private:
-	/** Timer handle for automatic firing */
-	FTimerHandle TimerHandle_AutomaticFire;
+	/** Timer handle for automatic firing, on the combat clock so fixed step combat fires at a fixed rate */
+	FCombatTimerHandle TimerHandle_AutomaticFire;
 
 	/** Flag to track if the dedicated aim button is pressed */
 	bool bIsAiming;
@@ -260,6 +329,12 @@ private:
 private:
 	bool bIsDead;
 
+	/** Mesh collision profile before the ragdoll switched it, restored by Revive */
+	FName MeshCollisionProfileName;
+
+	/** Physics fallback of the trajectory preview, kept so its path buffer is reused every frame */
+	FPredictProjectilePathResult TrajectoryPredictResult;
+
 	UFUNCTION()
 	void OnDeath();
 };
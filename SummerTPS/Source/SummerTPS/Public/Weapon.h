@@ -14,6 +14,9 @@ public:
 
     virtual void Fire();
 
+    /** Joins its owner's GC cluster, e.g. a pooled enemy's */
+    virtual bool CanBeInCluster() const override;
+
 protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     USceneComponent* Root;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WetnessSubsystem.generated.h"
+
+class ACharacter;
+
+UENUM(BlueprintType)
+enum class EWetnessRegion : uint8
+{
+	Head,
+	Torso,
+	Arms,
+	Legs,
+	Count UMETA(Hidden)
+};
+
+/**
+ * How wet each body region of a character is, for the wet skin materials.
+ * Every region stores its value and the time it was last changed; drying is an exponential decay evaluated from the elapsed
+ * time whenever the value is read, so nothing ticks per character. Hits only mark the character dirty. Once per frame, dirty
+ * characters and characters whose drying has crossed a quantization step get their regions pushed to the mesh as one
+ * custom primitive data vector (Head, Torso, Arms, Legs at CustomPrimitiveDataIndex), and only if a quantized value changed.
+ * Characters are forgotten once fully dry.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UWetnessSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UWetnessSubsystem();
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Adds Amount (0..1 scale) to the region around HitLocation, picked from BoneName or, without one, from the hit height */
+	void AddWater(ACharacter* Character, const FVector& HitLocation, FName BoneName, float Amount);
+
+	/** Dries the character instantly and forgets it, for pooled, reactivated or snapshot-restored characters */
+	void ClearCharacter(ACharacter* Character);
+
+	/** Current wetness of a region with drying applied, 0..1 */
+	UFUNCTION(BlueprintCallable, Category = "Wetness")
+	float GetWetness(const ACharacter* Character, EWetnessRegion Region) const;
+
+	/** Region a hit belongs to; bone names win over the height on the capsule */
+	static EWetnessRegion GetRegionForHit(const ACharacter* Character, const FVector& HitLocation, FName BoneName);
+
+protected:
+	/** Seconds for wetness to halve */
+	UPROPERTY(Config, EditAnywhere, Category = "Wetness", meta = (ClampMin = "0.1"))
+	float DryingHalfLife;
+
+	/** Distinct wetness levels the materials can show; changes within a level are never pushed */
+	UPROPERTY(Config, EditAnywhere, Category = "Wetness", meta = (ClampMin = "2", ClampMax = "255"))
+	int32 QuantizationLevels;
+
+	/** First of the four custom primitive data floats the wet materials read */
+	UPROPERTY(Config, EditAnywhere, Category = "Wetness", meta = (ClampMin = "0"))
+	int32 CustomPrimitiveDataIndex;
+
+private:
+	static constexpr int32 NumRegions = (int32)EWetnessRegion::Count;
+
+	struct FCharacterWetness
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		float Value[NumRegions] = {};
+		double UpdateTime[NumRegions] = {};
+
+		/** Quantized levels the mesh currently shows */
+		uint8 PushedLevel[NumRegions] = {};
+
+		/** Earliest time drying moves a region down a level */
+		double NextLevelChangeTime = 0.0;
+
+		bool bDirty = false;
+	};
+
+	/** Value of a region at Now with drying applied */
+	float Evaluate(const FCharacterWetness& Wetness, int32 Region, double Now) const;
+
+	uint8 Quantize(float Value) const;
+
+	/** Pushes the quantized regions if any changed, returns false once the character is completely dry */
+	bool Push(FCharacterWetness& Wetness, double Now);
+
+	const FCharacterWetness* Find(const ACharacter* Character) const;
+
+	/** Characters with any wetness; dry ones are removed */
+	TArray<FCharacterWetness> WetCharacters;
+};
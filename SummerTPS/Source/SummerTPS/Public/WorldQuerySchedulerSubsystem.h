@@ -0,0 +1,171 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "WorldQuerySchedulerSubsystem.generated.h"
+
+/** Who issued a query, for the per-category counts and times */
+UENUM()
+enum class EWorldQueryCategory : uint8
+{
+	PlayerMovement,
+	PlayerCover,
+	TrajectoryPreview,
+	Spawning,
+	AI,
+
+	Count UMETA(Hidden)
+};
+
+/** Result handed to the callback of a deferred query */
+struct FWorldQueryResult
+{
+	FHitResult Hit;
+
+	bool bBlockingHit = false;
+
+	/** Frames between submission and completion */
+	int32 LatencyFrames = 0;
+};
+
+using FWorldQueryCallback = TUniqueFunction<void(const FWorldQueryResult&)>;
+
+/**
+ * Single entry point for gameplay line traces and sweeps, so the trace work landing in one frame is bounded and attributed.
+ *
+ * Critical queries (LineTraceNow / SweepNow) run synchronously and are only counted and timed.
+ * Deferrable queries (SubmitLineTrace / SubmitSweep) carry a latency tolerance in frames. They are batched into async scene queries,
+ * at most MaxAsyncQueriesPerFrame per frame, earliest deadline first, and complete through their callback within the tolerance:
+ * a query that can't wait any longer is issued over budget, and one with a tolerance of 0 runs synchronously right away.
+ * Callbacks run on the game thread; capture weak pointers, the issuer may be gone by then.
+ */
+UCLASS(config = Game)
+class SUMMERTPS_API UWorldQuerySchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UWorldQuerySchedulerSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	bool LineTraceNow(EWorldQueryCategory Category, FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params);
+
+	bool SweepNow(EWorldQueryCategory Category, FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape, const FCollisionQueryParams& Params);
+
+	void SubmitLineTrace(EWorldQueryCategory Category, const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params, int32 MaxLatencyFrames, FWorldQueryCallback&& Callback);
+
+	void SubmitSweep(EWorldQueryCategory Category, const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape, const FCollisionQueryParams& Params, int32 MaxLatencyFrames, FWorldQueryCallback&& Callback);
+
+	/** Attributes synchronous query work done by engine helpers (e.g. PredictProjectilePath) to a category */
+	void RecordExternalQuery(EWorldQueryCategory Category, double Seconds);
+
+	/** Times the enclosing scope as one synchronous query of Category. Scheduler may be null */
+	struct FScopedQuery
+	{
+		FScopedQuery(UWorldQuerySchedulerSubsystem* InScheduler, EWorldQueryCategory InCategory)
+			: Scheduler(InScheduler), Category(InCategory), StartTime(FPlatformTime::Seconds())
+		{
+		}
+
+		~FScopedQuery()
+		{
+			if (Scheduler)
+			{
+				Scheduler->RecordExternalQuery(Category, FPlatformTime::Seconds() - StartTime);
+			}
+		}
+
+	private:
+		UWorldQuerySchedulerSubsystem* Scheduler;
+		EWorldQueryCategory Category;
+		double StartTime;
+	};
+
+	/** Logs per-category averages and peaks since the last reset */
+	void ReportStats() const;
+	void ResetStats();
+
+protected:
+	/** Async scene queries issued per frame before deferrable queries start waiting for a later frame */
+	UPROPERTY(Config, EditAnywhere, Category = "Queries")
+	int32 MaxAsyncQueriesPerFrame;
+
+private:
+	struct FPendingQuery
+	{
+		FVector Start;
+		FVector End;
+		FQuat Rotation;
+		FCollisionShape Shape;
+		FCollisionQueryParams Params;
+		ECollisionChannel Channel;
+		EWorldQueryCategory Category;
+		bool bSweep;
+		uint64 SubmitFrame;
+
+		/** Last frame the result may be delivered in */
+		uint64 DeadlineFrame;
+
+		FWorldQueryCallback Callback;
+	};
+
+	struct FInFlightQuery
+	{
+		FWorldQueryCallback Callback;
+		EWorldQueryCategory Category;
+		uint64 SubmitFrame;
+	};
+
+	/** Counters of the frame in progress */
+	struct FCategoryFrame
+	{
+		int32 NumSync = 0;
+		int32 NumAsync = 0;
+		int32 NumOverBudget = 0;
+		double SyncSeconds = 0.0;
+	};
+
+	/** Totals since the last reset, for the report */
+	struct FCategoryTotals
+	{
+		int64 NumSync = 0;
+		int64 NumAsync = 0;
+		int64 NumOverBudget = 0;
+		int64 TotalLatencyFrames = 0;
+		int64 NumCompletedAsync = 0;
+		double SyncSeconds = 0.0;
+		double PeakFrameSyncSeconds = 0.0;
+		int32 PeakFrameQueries = 0;
+	};
+
+	void Submit(FPendingQuery&& Query, int32 MaxLatencyFrames);
+
+	/** Runs a pending query synchronously and completes it right away */
+	void RunNow(FPendingQuery& Query);
+
+	void IssueAsync(FPendingQuery& Query);
+
+	void OnAsyncQueryDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	void PublishFrameStats();
+
+	TArray<FPendingQuery> PendingQueries;
+
+	/** Queries being scheduled this tick, swapped with PendingQueries to keep its allocation */
+	TArray<FPendingQuery> SchedulingQueries;
+
+	TMap<uint32, FInFlightQuery> InFlightQueries;
+	uint32 NextQueryId;
+
+	FTraceDelegate AsyncQueryDelegate;
+
+	FCategoryFrame CurrentFrame[(int32)EWorldQueryCategory::Count];
+	FCategoryTotals Totals[(int32)EWorldQueryCategory::Count];
+	int64 NumReportedFrames;
+};
@@ -4,3 +4,5 @@
 
 #include "CoreMinimal.h"
 
+/** Stat group for SummerTPS gameplay systems ("stat SummerTPS") */
+DECLARE_STATS_GROUP(TEXT("SummerTPS"), STATGROUP_SummerTPS, STATCAT_Advanced);